@@ -0,0 +1,44 @@
+#ifndef SVGBANDEXPORTER_H
+#define SVGBANDEXPORTER_H
+
+#include <QSize>
+#include <QString>
+#include "SvgRasterWriter.h"
+#include "SvgRenderer.h"
+
+class QIODevice;
+class SvgDocument;
+
+// 分带导出超大栅格：输出图像按水平条带逐条渲染（每条带只是视图变换多平移一段），
+// 渲染完立即逐行交给流式编码器写出。峰值内存约为 条带字节数 ×（预渲染条带数 + 1），
+// 与输出总尺寸无关，60000×40000这样的海报也不需要整幅QImage。
+// 可让多个工作线程提前渲染后续条带，编码器按顺序写出
+class SvgBandExporter
+{
+public:
+    // 自动条带高度时每条带的目标字节数
+    static const qint64 kDefaultBandBytes = qint64(64) * 1024 * 1024;
+
+    // 条带高度（像素行），0表示按kDefaultBandBytes自动选择
+    void setBandHeight(int rows) { mBandHeight = rows; }
+    // 同时渲染的条带数（1为串行），越大越快但峰值内存成比例增加
+    void setParallelBands(int count) { mParallelBands = qMax(1, count); }
+    void setQuality(SvgRenderer::Quality quality) { mQuality = quality; }
+
+    // 文档按viewBox等比适配到size，写入fileName（格式按扩展名选择，写完才替换目标文件）
+    bool exportToFile(const SvgDocument* document, const QSize& size, const QString& fileName);
+    bool exportToDevice(const SvgDocument* document, const QSize& size, QIODevice* device,
+                        SvgRasterWriter::Format format);
+
+    QString errorString() const { return mError; }
+
+private:
+    int bandHeightFor(int width) const;
+
+    int mBandHeight = 0;
+    int mParallelBands = 1;
+    SvgRenderer::Quality mQuality = SvgRenderer::QualityFull;
+    QString mError;
+};
+
+#endif // SVGBANDEXPORTER_H
@@ -0,0 +1,17 @@
+#ifndef SVGDEFINITIONS_H
+#define SVGDEFINITIONS_H
+
+#include "SvgGroup.h"
+
+// <defs>：只保存可被<use>引用的内容，自身不绘制，也不占据文档范围
+class SvgDefinitions : public SvgGroup
+{
+public:
+    explicit SvgDefinitions(const QString& id = "");
+
+    void draw(SvgRenderer* renderer) const override;
+    QRectF boundingBox() const override { return QRectF(); }
+    bool isRendered() const override { return false; }
+};
+
+#endif // SVGDEFINITIONS_H
@@ -0,0 +1,79 @@
+#ifndef SVGDISPLAYLIST_H
+#define SVGDISPLAYLIST_H
+
+#include <QHash>
+#include <QRectF>
+#include <QTransform>
+#include <QVector>
+#include "SvgSceneStore.h"
+
+class SvgDocument;
+class SvgElement;
+class SvgGroup;
+
+// 显示列表中的一个图元：叶子元素 + 文档坐标下的累积变换
+struct SvgDisplayItem
+{
+    const SvgElement* element = nullptr;
+    QTransform transform;   // 祖先组变换与自身变换的组合（元素局部坐标→文档坐标）
+    QRectF bounds;          // 文档坐标包围盒（已含描边半宽）
+    int style = 0;          // 样式句柄（SvgDisplayList::style）
+};
+
+// 一个组的子树在显示列表中对应的图元区间（前序展开保证同一子树的图元相邻）
+struct SvgDisplayGroup
+{
+    const SvgGroup* group = nullptr;
+    int first = 0;          // 区间[first, end)
+    int end = 0;
+};
+
+// 编译后的显示列表：把元素树按文档顺序展开为扁平的叶子图元数组，
+// 并建立均匀网格索引，按区域查询时只返回可能可见的图元。
+// <use>实例是一个图元（绘制时重放目标子树），defs/symbol的内容不单独成为图元
+class SvgDisplayList
+{
+public:
+    // 登记图元区间的最少图元数（更小的组不值得单独缓存）；声明了图层提示的组不受此限制
+    static const int kMinGroupItems = 64;
+
+    // 从文档的场景存储（SvgSceneStore）编译，加载期间尚无存储时临时建立一份
+    // （编译期间文档不得修改；编译后列表只读，可被多个线程同时查询）
+    void compile(const SvgDocument* document);
+    void clear();
+
+    const QVector<SvgDisplayItem>& items() const { return mItems; }
+    int size() const { return mItems.size(); }
+    bool isEmpty() const { return mItems.isEmpty(); }
+    QRectF bounds() const { return mBounds; }
+    // 图元的样式热数据（颜色与线宽），来自场景存储去重后的样式表
+    const SvgHotStyle& style(const SvgDisplayItem& item) const { return mStyles.at(item.style); }
+    // 较大的组（及声明了图层提示的组）的图元区间，按first升序、同起点时外层在前
+    const QVector<SvgDisplayGroup>& groups() const { return mGroups; }
+
+    // 与文档坐标矩形rect相交的图元下标，按文档顺序（绘制顺序）排列
+    QVector<int> query(const QRectF& rect) const;
+
+    // 元素的属性、样式或变换已修改（子树结构不变）：原地重算其子树对应图元的变换与包围盒，
+    // 样式句柄取自文档已更新的场景存储；只移动这些图元在网格中的登记，
+    // 包围盒超出现有网格范围时才重建网格。插入或删除子树会改变图元下标，需要重新compile
+    void updateElement(const SvgDocument* document, const SvgElement* element);
+
+private:
+    void buildGrid();
+    QRect gridRange(const QRectF& rect) const;
+    void gridInsert(int index);
+    void gridRemove(int index);
+
+    QVector<SvgDisplayItem> mItems;
+    QVector<SvgDisplayGroup> mGroups;
+    QRectF mBounds;
+    QVector<SvgHotStyle> mStyles;     // 场景存储样式表的（隐式共享）副本
+    QVector<int> mUnbounded;          // 包围盒不可靠的图元（文本），任何查询都返回
+    int mGridColumns = 0;
+    int mGridRows = 0;
+    QVector<QVector<int>> mGrid;      // 每个网格单元内的图元下标（升序）
+    QHash<const SvgElement*, int> mIndexOf;   // 叶子元素→图元下标（首次编辑时才建立）
+};
+
+#endif // SVGDISPLAYLIST_H
@@ -1,13 +1,48 @@
 #ifndef SVGDocument_H
 #define SVGDocument_H
 
+#include <QHash>
 #include <QList>
 #include <QRectF>
 #include <QString>
+#include <QVector>
+#include <memory>
 #include "SvgElement.h"
 
-class QDomDocument;
-class QDomElement;
+class QIODevice;
+class SvgDocument;
+class SvgGeometryPool;
+class SvgGroup;
+class SvgSceneStore;
+class SvgUse;
+
+// 一次编辑的描述：哪个元素变了、需要重绘的文档区域
+struct SvgDocumentChange
+{
+    enum Kind {
+        ElementChanged,   // 属性/样式/变换修改，子树结构不变
+        ChildInserted,    // 插入了新的子树
+        ChildRemoved,     // 删除了子树（element为nullptr，对象已释放）
+        StructureChanged  // 批量编辑合并后的通知（element为nullptr），监听者整体重建
+    };
+
+    Kind kind = ElementChanged;
+    const SvgElement* element = nullptr;
+    QRectF dirtyRect;        // 文档坐标：修改前后外观的并集（已含描边与受影响的实例）
+    quint64 revision = 0;    // 修改后的文档版本号
+    // ElementChanged时同时改变外观的<use>实例（引用了被修改的内容），监听者需一并更新
+    QVector<const SvgElement*> instances;
+};
+
+// 文档编辑监听者（视图、缓存）：修改前先停止读取文档的后台任务，修改后只失效受影响的部分
+class SvgDocumentListener
+{
+public:
+    virtual ~SvgDocumentListener() = default;
+    // 文档即将被修改：等待或取消所有读取文档的工作线程任务（之后不一定有documentChanged，如属性不被支持）
+    virtual void documentAboutToChange(const SvgDocument* document) { Q_UNUSED(document); }
+    virtual void documentChanged(const SvgDocument* document, const SvgDocumentChange& change) = 0;
+};
 
 class SvgDocument
 {
@@ -15,16 +50,58 @@ public:
     SvgDocument();
     ~SvgDocument();
 
+    // 普通SVG与gzip压缩的SVGZ均可直接加载（按数据头自动识别）
     bool load(const QString& fileName);
     bool isValid() const { return mIsValid; }
     bool loadFromData(const QByteArray& data);
 
+    // 渐进加载：beginLoad打开文件后，每次continueLoad最多解析maxElements个元素。
+    // 解析期间文档可以直接绘制（已解析部分挂在根元素下），continueLoad返回false表示加载结束
+    bool beginLoad(const QString& fileName);
+    bool continueLoad(int maxElements = 2000);
+    bool isLoading() const { return mPending != nullptr; }
+    // 加载期间的几何去重池（相同的路径/点列表只解析一次）；未在加载时为nullptr
+    SvgGeometryPool* geometryPool() const { return mGeometryPool.get(); }
+
     void addElement(SvgElement* element);
     void removeElement(SvgElement* element);
     QList<SvgElement*> elements() const;
 
+    // 编辑接口（GUI线程，加载完成后）：每次成功的修改递增revision，并通知监听者受影响的区域。
+    // 属性按加载时相同的规则解析；insertChild取得child的所有权，removeChild释放被删除的子树。
+    // 不支持的属性/样式、不在文档中的元素返回false，此时不通知监听者
+    bool setAttribute(SvgElement* element, const QString& name, const QString& value);
+    bool setStyleProperty(SvgElement* element, const QString& name, const QString& value);
+    bool setElementTransform(SvgElement* element, const SvgTransform& transform);
+    bool insertChild(SvgGroup* parent, int index, SvgElement* child);
+    bool removeChild(SvgElement* child);
+    quint64 revision() const { return mRevision; }
+    // 批量编辑：beginEditBatch与endEditBatch之间的修改只在第一次修改前通知documentAboutToChange，
+    // 结束时合并为一次StructureChanged（dirtyRect为全部修改区域的并集），监听者与场景存储只重建一次
+    void beginEditBatch();
+    void endEditBatch();
+
+    void addListener(SvgDocumentListener* listener);
+    void removeListener(SvgDocumentListener* listener);
+
+    // 元素子树在文档坐标下的外观范围（含祖先变换与描边半宽）
+    QRectF documentBounds(const SvgElement* element) const;
+
+    // 元素热数据的列式存储：加载完成后建立，随编辑更新；加载期间（及加载失败时）为nullptr
+    const SvgSceneStore* sceneStore() const { return mSceneStore.get(); }
+
+    // id索引：加载完成后建立，结构编辑或id修改后重建（同一id出现多次时取文档顺序中的第一个）
+    SvgElement* elementById(const QString& id) const { return mIdIndex.value(id); }
+    // 直接或经由其他实例间接引用了element（其子树或祖先）的<use>实例：修改element会改变它们的外观
+    QVector<const SvgUse*> dependentInstances(const SvgElement* element) const;
+    // 目标内容被修改后，让这些实例共享的目标范围缓存失效
+    void invalidateInstanceBounds(const QVector<const SvgUse*>& instances) const;
+
+    // 声明的viewBox（加载结束时补齐默认值）；加载期间只由GUI线程解析根/嵌套svg时写入
     QRectF viewBox() const;
     void setViewBox(const QRectF& viewBox);
+    // 视图适配用的范围：加载期间未声明viewBox时为按已解析内容估算的临时范围（随内容增长），其余时候同viewBox()
+    QRectF displayViewBox() const;
 
     QString title() const;
     void setTitle(const QString& title);
@@ -38,18 +115,43 @@ public:
     // 1. 声明元素计数函数（与.cpp实现严格匹配）
     int totalElementCount() const;
 
-    // 2. 声明递归计数辅助函数
-    int countElementRecursive(SvgElement* elem) const;
+    // 2. 声明默认viewBox计算函数
+    void calculateDefaultViewBox();
+
+    // 内存紧张时释放路径缓存的QPainterPath与懒加载路径已生成的几何（下次绘制时重新生成），返回释放的字节数。
+    // 路径各自加锁，可与其他线程对本文档的绘制同时进行
+    qint64 releaseCachedGeometry() const;
 
-    // 3. 声明边界框扩展函数
-    void expandBboxWithElement(SvgElement* elem, QRectF& bbox) const;
+    // 二进制文档缓存目录（为空表示不使用缓存）
+    static void setCacheDirectory(const QString& dir) { sCacheDirectory = dir; }
+    static QString cacheDirectory() { return sCacheDirectory; }
 
-    // 4. 声明默认viewBox计算函数
-    void calculateDefaultViewBox();
+    // 加载完成后运行树优化（展开组、烘焙变换，见SvgTreeOptimizer）
+    static void setOptimizeOnLoad(bool enabled) { sOptimizeOnLoad = enabled; }
+    static bool optimizeOnLoad() { return sOptimizeOnLoad; }
+    // 已运行过树优化：元素树与源文本不再一一对应
+    bool isOptimized() const { return mOptimized; }
 
 private:
-    bool parseSvgElement(const QDomElement& domElement);
-    SvgElement* createElementFromDom(const QDomElement& domElement);
+    // load/loadFromData/beginLoad共用：在device上（必要时套gzip解压）建立流式解析器，device由mPending持有
+    bool beginLoadFromDevice(QIODevice* device);
+    // 渐进加载结束：补齐viewBox、校验有效性、写入缓存并释放加载状态
+    bool finishLoad(bool parsed);
+    void clear();
+    // 按sOptimizeOnLoad对加载结果运行树优化
+    void optimizeLoadedTree();
+    // 加载结束：释放几何去重池（元素间的共享保留）
+    void releaseGeometryPool();
+    // 编辑前后的通知
+    bool beginChange(const SvgElement* element);
+    void commitChange(SvgDocumentChange::Kind kind, const SvgElement* element, const QRectF& dirtyRect,
+                      const QVector<const SvgUse*>& instances = QVector<const SvgUse*>());
+    // element与受其影响的实例在文档坐标下的外观范围
+    QRectF affectedBounds(const SvgElement* element, const QVector<const SvgUse*>& instances) const;
+    // 重建id索引并为所有<use>解析目标
+    void resolveReferences();
+    // 按当前元素树（重新）建立场景存储
+    void buildSceneStore();
 
     QList<SvgElement*> mElements;
     QRectF mViewBox;
@@ -57,6 +159,26 @@ private:
     QString mTitle;
     QString mDescription;
     bool mIsValid = false;
+
+    struct PendingLoad;                    // 进行中的加载（文件映射、解压设备、解析器状态）
+    std::unique_ptr<PendingLoad> mPending;
+    QRectF mProvisionalViewBox;            // 加载期间按已解析内容估算的范围（只供视图适配，不参与解析）
+    quint64 mRevision = 0;                 // 编辑版本号
+    QList<SvgDocumentListener*> mListeners;
+    bool mOptimized = false;
+    std::unique_ptr<SvgGeometryPool> mGeometryPool;
+    QHash<QString, SvgElement*> mIdIndex;
+    QMultiHash<const SvgElement*, const SvgUse*> mInstances;   // 目标→引用它的实例
+    std::unique_ptr<SvgSceneStore> mSceneStore;
+    struct EditBatch {
+        int depth = 0;
+        bool notified = false;   // 已通知documentAboutToChange
+        QRectF dirty;
+    };
+    EditBatch mEditBatch;
+
+    static QString sCacheDirectory;
+    static bool sOptimizeOnLoad;
 };
 
 #endif // SVGDocument_H
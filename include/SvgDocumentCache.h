@@ -0,0 +1,46 @@
+#ifndef SVGDOCUMENTCACHE_H
+#define SVGDOCUMENTCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+class QDataStream;
+class SvgDocument;
+class SvgElement;
+class SvgGeometryPool;
+class SvgStyle;
+
+// 文档二进制缓存：把解析完成的元素树（样式、变换、路径顶点）序列化到磁盘，
+// 以源文件内容哈希为键；再次打开同一文件时直接映射缓存文件还原，跳过XML与属性解析
+class SvgDocumentCache
+{
+public:
+    explicit SvgDocumentCache(const QString& cacheDir);
+
+    // 计算源内容哈希（缓存键）
+    static QByteArray contentHash(const QByteArray& sourceData);
+
+    // 从缓存还原文档；缓存缺失、版本不符或哈希不一致（过期）时返回false
+    bool restore(const QByteArray& hash, SvgDocument* document) const;
+
+    // 将已解析的文档写入缓存（原子替换，失败时不影响旧缓存）
+    bool store(const QByteArray& hash, const SvgDocument* document) const;
+
+    QString cacheFilePath(const QByteArray& hash) const;
+
+private:
+    static void writeStyle(QDataStream& out, const SvgStyle& style);
+    static void readStyle(QDataStream& in, SvgStyle& style);
+
+    // 写出/读入一棵子树（前序记录序列）
+    static void writeElement(QDataStream& out, const SvgElement* element);
+    // pool不为空时相同的几何合并为共享数据
+    static SvgElement* readElement(QDataStream& in, SvgGeometryPool* pool);
+    // 单条元素记录；组记录只含子元素数量（读入时由childCount返回）
+    static void writeRecord(QDataStream& out, const SvgElement* element);
+    static SvgElement* readRecord(QDataStream& in, SvgGeometryPool* pool, quint32* childCount);
+
+    QString mCacheDir;
+};
+
+#endif // SVGDOCUMENTCACHE_H
@@ -8,6 +8,7 @@
 #include "SvgStyle.h"
 
 class SvgRenderer;
+class SvgGroup;
 
 class SvgElement
 {
@@ -16,7 +17,8 @@ public:
         TypeShape,
         TypeText,
         TypeClipping,
-        TypeGroup
+        TypeGroup,
+        TypeUse          // <use>实例：引用文档中另一处的内容
     };
 
     explicit SvgElement(ElementType type, const QString& id = "");
@@ -37,6 +39,11 @@ public:
     virtual QRectF boundingBox() const;
     virtual void setBoundingBox(const QRectF& bbox);
 
+    // 所在的组（顶层元素为nullptr），由SvgGroup在添加/移除子元素时维护
+    SvgGroup* parent() const { return mParent; }
+    void setParent(SvgGroup* parent) { mParent = parent; }
+    // 元素局部坐标→文档坐标：自身变换与所有祖先组变换的组合
+    QTransform worldTransform() const;
 
 protected:
     ElementType mType;
@@ -44,6 +51,7 @@ protected:
     SvgTransform mTransform;
     SvgStyle mStyle;
     QRectF mBoundingBox;
+    SvgGroup* mParent = nullptr;
 };
 
 #endif // SVGELEMENT_H
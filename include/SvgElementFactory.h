@@ -2,10 +2,12 @@
 #define SVGELEMENTFACTORY_H
 
 #include "SvgDocument.h"
-#include <QDomElement>
+#include "SvgGeometryPool.h"
 #include <QList>
 #include <QPointF>
 #include <QPainterPath>
+#include <QStringView>
+#include <QXmlStreamReader>
 
 class SvgElement;
 class SvgRect;
@@ -19,6 +21,29 @@ class SvgPolygon;   // 新增
 class SvgPath;      // 新增
 class SvgDocument;
 
+// 创建单个元素的输入：标签名（小写）、属性与文本内容（只有text元素使用）。
+// 属性值以QStringView取得，直接引用QXmlStreamReader给出的属性，不复制到临时DOM元素；
+// d、points、style等长文本由解析函数就地读取，只有元素需要保存的字符串（id、href、懒加载的d）才复制
+class SvgNodeSource
+{
+public:
+    SvgNodeSource(const QString& tagName, const QXmlStreamAttributes& attributes, const QString& text = QString())
+        : mTagName(tagName), mAttributes(attributes), mText(text)
+    {
+    }
+
+    const QString& tagName() const { return mTagName; }
+    bool hasAttribute(const char* name) const { return mAttributes.hasAttribute(QLatin1String(name)); }
+    // 属性不存在时为空
+    QStringView attribute(const char* name) const { return mAttributes.value(QLatin1String(name)); }
+    const QString& text() const { return mText; }
+
+private:
+    QString mTagName;
+    QXmlStreamAttributes mAttributes;   // 隐式共享，构造时不复制属性值
+    QString mText;
+};
+
 class SvgElementFactory
 {
 public:
@@ -28,44 +53,85 @@ public:
         bool valid;     // 解析是否成功（true表示有效）
     };
 
-    // 主创建函数：根据标签名创建对应元素
-    static SvgElement* createElement(const QDomElement& domElement, SvgDocument* document);
+    // 主创建函数：根据标签名创建对应元素（容器只创建自身，子元素由调用方按文档顺序逐个添加）；
+    // 标签不被支持时返回nullptr
+    static SvgElement* createElement(const SvgNodeSource& node, SvgDocument* document);
+    // createElement能否为该标签（小写）创建元素；不支持的标签连同子树一起被忽略
+    static bool isSupportedTag(const QString& tagName);
+
+    // 路径懒加载模式：加载时只保存d字符串和快速估算的边界框，首次绘制时才生成QPainterPath
+    static void setLazyPathParsing(bool lazy) { sLazyPathParsing = lazy; }
+    static bool lazyPathParsing() { return sLazyPathParsing; }
+
+    // 解析路径d属性（SvgPath懒加载时也会调用）
+    static QPainterPath parsePathData(QStringView d);
+
+    // 修改已创建元素的单个属性（与加载时同样的解析规则），并更新元素的局部边界框。
+    // 返回false表示该元素类型不支持此属性
+    static bool applyAttribute(SvgElement* element, const QString& name, const QString& value,
+                               const SvgDocument* document);
+    // applyAttribute是否会接受该属性（不修改元素），编辑前据此校验
+    static bool supportsAttribute(const SvgElement* element, const QString& name, const QString& value);
+
+    // 当前线程的viewBox快照：作用域内百分比坐标按快照换算，不读取文档当前的viewBox。
+    // 并行加载的工作线程使用（GUI线程解析到嵌套svg时会改写文档viewBox）
+    class ViewBoxSnapshot
+    {
+    public:
+        explicit ViewBoxSnapshot(const QRectF& viewBox);
+        ~ViewBoxSnapshot();
+
+    private:
+        QRectF mViewBox;
+        const QRectF* mPrevious;
+    };
 
 private:
     // 通用属性解析（样式、变换等）
-    static void parseCommonAttributes(SvgElement* element, const QDomElement& domElement);
+    static void parseCommonAttributes(SvgElement* element, const SvgNodeSource& node);
 
     // 元素专属创建函数
-    static SvgElement* createRectElement(const QDomElement& domElement);
-    static SvgElement* createCircleElement(const QDomElement& domElement);
-    static SvgElement* createTextElement(const QDomElement& domElement);
-    static SvgElement* createGroupElement(const QDomElement& domElement, SvgDocument* document);
-    static SvgElement* createEllipseElement(const QDomElement& domElement);  // 新增
-    static SvgElement* createLineElement(const QDomElement& domElement);     // 新增
-    static SvgElement* createPolylineElement(const QDomElement& domElement, SvgDocument* document); // 新增
-    static SvgElement* createPolygonElement(const QDomElement& domElement, SvgDocument* document);  // 新增
-    static SvgElement* createPathElement(const QDomElement& domElement);     // 新增
+    static SvgElement* createRectElement(const SvgNodeSource& node);
+    static SvgElement* createCircleElement(const SvgNodeSource& node);
+    static SvgElement* createTextElement(const SvgNodeSource& node);
+    static SvgElement* createGroupElement(const SvgNodeSource& node);
+    // 容器元素（g/defs/symbol）共用：解析通用属性（子元素由调用方添加）
+    static SvgElement* initContainer(SvgGroup* group, const SvgNodeSource& node);
+    static SvgElement* createUseElement(const SvgNodeSource& node);
+    static SvgElement* createEllipseElement(const SvgNodeSource& node);  // 新增
+    static SvgElement* createLineElement(const SvgNodeSource& node);     // 新增
+    static SvgElement* createPolylineElement(const SvgNodeSource& node, SvgDocument* document); // 新增
+    static SvgElement* createPolygonElement(const SvgNodeSource& node, SvgDocument* document);  // 新增
+    static SvgElement* createPathElement(const SvgNodeSource& node, SvgDocument* document);     // 新增
+
+    // 百分比坐标的参照：当前线程有快照时取快照，否则取文档的viewBox
+    static QRectF referenceViewBox(const SvgDocument* document);
 
     // 声明所有辅助函数
-    static QList<qreal> parseNumbers(const QString& str);
-    static QList<QPointF> parsePoints(const QString& pointsStr, const QRectF& viewBox);
+    static QList<qreal> parseNumbers(QStringView str);
+    static QList<QPointF> parsePoints(QStringView pointsStr, const QRectF& viewBox);
     static QRectF calculatePointsBoundingBox(const QList<QPointF>& points);
+    // 解析points属性并计算边界框；加载期间经文档的几何去重池，相同的列表只解析一次
+    static SvgGeometryPool::PointsEntry parsePointsShared(QStringView pointsStr, SvgDocument* document);
     static QRectF normalizeBbox(const QRectF& bbox);
-    static QPainterPath parsePathData(const QString& d);
-    static ParsedValue parseValueWithUnit(const QString& str);
+    // 不构建路径，只扫描坐标估算d属性的外接矩形（偏保守，包含控制点与弧线范围）
+    static QRectF estimatePathBounds(QStringView d);
+    static ParsedValue parseValueWithUnit(QStringView str);
     static qreal convertToPx(const ParsedValue& parsed, const QRectF& viewBox);
     static qreal parseDoubleAttr(
-        const QDomElement& elem,
-        const QString& attrName,
+        const SvgNodeSource& node,
+        const char* attrName,
         const QRectF& viewBox = QRectF(),  // 默认空viewBox
         qreal defaultValue = 0             // 默认值0
         );
-    static qreal parseDoubleAttrFromString(const QString& str, const QRectF& viewBox);
-    // 解析DOM元素的尺寸属性（如x、y、width等），返回数值（默认单位为px）
-    static qreal parseDimensionAttr(const QDomElement& elem, const QString& attrName, qreal defaultValue);
+    static qreal parseDoubleAttrFromString(QStringView str, const QRectF& viewBox);
+    // 解析元素的尺寸属性（如x、y、width等），返回数值（默认单位为px）
+    static qreal parseDimensionAttr(const SvgNodeSource& node, const char* attrName, qreal defaultValue);
 
     // 解析尺寸字符串（如"250"、"20px"、"1.5em"），提取数值部分（忽略单位）
-    static qreal parseDimension(const QString& dimStr, qreal defaultValue);
+    static qreal parseDimension(QStringView dimStr, qreal defaultValue);
+
+    static bool sLazyPathParsing;
 };
 
 #endif // SVGELEMENTFACTORY_H
@@ -0,0 +1,65 @@
+#ifndef SVGFRAMERENDERER_H
+#define SVGFRAMERENDERER_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QTransform>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <memory>
+#include "SvgRenderer.h"
+
+class SvgDocument;
+
+// 后台整帧渲染：在工作线程把文档绘制到离屏QImage，完成后交换到前台缓冲并发出frameReady。
+// 一帧画不完时按时间片增量渲染（SvgRenderScheduler），片与片之间也上屏部分结果。
+// 前台帧始终是最近一次完整完成的结果，GUI线程只负责贴图，从不等待光栅化。
+// 新请求会取消仍在进行的旧请求（渲染器在下一个元素处退出）
+class SvgFrameRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SvgFrameRenderer(QObject* parent = nullptr);
+    ~SvgFrameRenderer() override;
+
+    // 请求按viewTransform（文档坐标→帧像素）渲染size大小的新帧。
+    // 渲染完成（isBusy()返回false）之前文档不得修改；尺寸为空时不发起请求并返回false。
+    // 草稿质量按kDraftResolution缩小渲染，frameTransform()中已包含该缩放
+    bool requestFrame(const SvgDocument* document, const QTransform& viewTransform, const QSize& size,
+                      SvgRenderer::Quality quality = SvgRenderer::QualityFull);
+    // 取消所有请求并等待工作线程退出（修改或销毁文档前调用）
+    void cancelAndWait();
+    // 是否仍有任务在读取文档
+    bool isBusy() const { return mInFlight.loadAcquire() > 0; }
+
+    bool hasFrame() const { return !mFront.isNull(); }
+    const QImage& frame() const { return mFront; }
+    // 前台帧对应的视图变换（文档坐标→帧像素）
+    const QTransform& frameTransform() const { return mFrontTransform; }
+    void clearFrame();
+
+    // 最近一次完成的完整质量帧的渲染耗时（毫秒，尚无时为0）
+    qint64 lastFullFrameTime() const { return mLastFullFrameTime; }
+
+signals:
+    void frameReady();
+
+private:
+    void present(quint64 serial, const QImage& image, const QTransform& transform,
+                 SvgRenderer::Quality quality, qint64 elapsedMs);
+    // 渲染中途的部分结果：只替换前台图像，不计入耗时统计
+    void presentPartial(quint64 serial, const QImage& image, const QTransform& transform);
+
+    QThreadPool mPool;                    // 单线程：帧按请求顺序串行渲染
+    QImage mFront;                        // 前台缓冲（paintEvent读取）
+    QTransform mFrontTransform;
+    QImage mSpare;                        // 上一帧的前台缓冲，尺寸相同时复用为下一帧的后台缓冲
+    std::shared_ptr<QAtomicInt> mCancel;  // 当前请求的取消标志
+    quint64 mSerial = 0;                  // 最新请求序号，过期结果不上屏
+    QAtomicInt mInFlight{0};
+    qint64 mLastFullFrameTime = 0;
+};
+
+#endif // SVGFRAMERENDERER_H
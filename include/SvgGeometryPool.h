@@ -0,0 +1,78 @@
+#ifndef SVGGEOMETRYPOOL_H
+#define SVGGEOMETRYPOOL_H
+
+#include "SvgPathData.h"
+#include <QHash>
+#include <QMutex>
+#include <QPolygonF>
+#include <QRectF>
+#include <QString>
+#include <QStringView>
+#include <functional>
+
+// 几何去重池（hash-consing）：图标表、CAD导出中同一d字符串/points列表常重复成千上万次，
+// 只是变换不同。池以源文本的哈希为键，相同数据只解析一次，解析结果借助Qt隐式共享
+// 被所有引用它的元素共用同一份只读数组（只有修改方才会分离出自己的副本）。
+// 键不保存源文本副本（大文件的d字符串本身可达数百MB）：同一哈希下再以长度和另一种子的
+// 校验哈希区分，懒加载的d则直接与保存的字符串比较。
+// 池只在加载期间由文档持有，加载结束即释放，元素之间的共享不受影响。
+// 并行构建时多个工作线程同时查询：查找与登记加锁，解析在锁外进行
+class SvgGeometryPool
+{
+public:
+    struct PathEntry {
+        SvgPathData data;
+        QRectF bounds;        // 紧致包围盒（随几何一起缓存，避免逐元素重算曲线极值）
+    };
+    struct PointsEntry {
+        QPolygonF points;
+        QRectF bounds;
+        QRectF viewBox;       // 解析时的viewBox（百分比坐标依赖它）
+    };
+    struct LazyPathEntry {
+        QString d;            // 共享的d字符串
+        QRectF estimate;      // 快速估算的边界
+    };
+
+    struct Statistics {
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+
+    // 按源文本取几何，未命中时调用parse解析并登记
+    PathEntry path(QStringView d, const std::function<PathEntry()>& parse);
+    PointsEntry points(QStringView text, const QRectF& viewBox, const std::function<PointsEntry()>& parse);
+    LazyPathEntry lazyPath(QStringView d, const std::function<QRectF()>& estimate);
+
+    // 按内容去重（二进制缓存还原时没有源文本）
+    SvgPathData internPath(const SvgPathData& data);
+    QPolygonF internPoints(const QPolygonF& points);
+
+    Statistics statistics() const;
+
+private:
+    // 源文本的标识：哈希桶内逐项比较长度与校验哈希
+    struct SourceKey {
+        size_t hash = 0;
+        size_t check = 0;
+        qsizetype length = 0;
+    };
+    template <typename Entry>
+    struct Keyed {
+        SourceKey key;
+        Entry entry;
+    };
+    static SourceKey sourceKey(QStringView source);
+    template <typename Entry>
+    static const Entry* find(const QHash<size_t, QList<Keyed<Entry>>>& table, const SourceKey& key);
+
+    mutable QMutex mMutex;
+    QHash<size_t, QList<Keyed<PathEntry>>> mPaths;
+    QHash<size_t, QList<Keyed<PointsEntry>>> mPoints;
+    QHash<size_t, QList<Keyed<LazyPathEntry>>> mLazyPaths;
+    QHash<size_t, QList<SvgPathData>> mPathsByContent;   // 内容哈希→同哈希的几何
+    QHash<size_t, QList<QPolygonF>> mPointsByContent;
+    Statistics mStatistics;
+};
+
+#endif // SVGGEOMETRYPOOL_H
@@ -7,19 +7,39 @@
 class SvgGroup : public SvgElement
 {
 public:
+    // 图层缓存提示（data-layer属性）：static声明子树内容不再变化，编辑其他内容后即栅格化为图层复用；
+    // auto由分块缓存观察到连续若干次编辑都未触及该子树后才缓存
+    enum LayerHint {
+        LayerAuto,
+        LayerStatic
+    };
+
     explicit SvgGroup(const QString& id = "");
     ~SvgGroup() override; // 需手动释放子元素
 
     void draw(SvgRenderer* renderer) const override;
     QRectF boundingBox() const override;
 
+    // defs/symbol等定义容器返回false：子树只经由<use>引用绘制，遍历可见内容时整体跳过
+    virtual bool isRendered() const { return true; }
+
     // 子元素管理
     void addChild(SvgElement* child);
+    // 插入到index位置（越界时追加）
+    void insertChild(int index, SvgElement* child);
     void removeChild(SvgElement* child);
+    // 移出子元素但不释放，返回是否找到
+    bool takeChild(SvgElement* child);
     QList<SvgElement*> children() const { return mChildren; }
+    // 整体替换子元素列表（不释放原有子元素，由调用方接管），用于批量重排
+    void setChildren(const QList<SvgElement*>& children);
+
+    LayerHint layerHint() const { return mLayerHint; }
+    void setLayerHint(LayerHint hint) { mLayerHint = hint; }
 
 private:
     QList<SvgElement*> mChildren; // 组内子元素列表
+    LayerHint mLayerHint = LayerAuto;
 };
 
 #endif // SVGGROUP_H
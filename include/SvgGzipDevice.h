@@ -0,0 +1,36 @@
+#ifndef SVGGZIPDEVICE_H
+#define SVGGZIPDEVICE_H
+
+#include <QIODevice>
+#include <QByteArray>
+
+struct z_stream_s;
+
+// gzip解压设备：包装一个压缩数据源，按需逐块解压（.svgz）。
+// 解析器每次read只解出所需的一小段，完整的解压文本不会驻留内存
+class SvgGzipDevice : public QIODevice
+{
+public:
+    explicit SvgGzipDevice(QIODevice* source);
+    ~SvgGzipDevice() override;
+
+    // 判断数据头是否为gzip魔数（1f 8b）
+    static bool isGzipData(const QByteArray& head);
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+    bool atEnd() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    QIODevice* mSource;      // 压缩数据源（不持有）
+    z_stream_s* mStream;     // zlib解压状态
+    QByteArray mInput;       // 当前压缩输入块
+    bool mFinished = false;  // 所有gzip成员均已解压完毕
+};
+
+#endif // SVGGZIPDEVICE_H
@@ -0,0 +1,96 @@
+#ifndef SVGLAYERCACHE_H
+#define SVGLAYERCACHE_H
+
+#include <QImage>
+#include <QPoint>
+#include <QRectF>
+#include <QSize>
+#include <QTransform>
+#include <QVector>
+
+class SvgDisplayList;
+class SvgGroup;
+struct SvgDocumentChange;
+
+// 一个已栅格化的图层：显示列表中连续图元区间[first, end)按transform绘制成的图像
+struct SvgLayerImage
+{
+    int first = 0;
+    int end = 0;
+    QImage image;
+    QTransform transform;   // 文档坐标→图层图像像素
+};
+
+// 需要栅格化的图层（由分块缓存在线程池中渲染后交回storeLayer）
+struct SvgLayerRequest
+{
+    const SvgGroup* group = nullptr;
+    int first = 0;
+    int end = 0;
+    qreal scale = 1.0;
+    QPoint origin;          // 图层图像左上角在缩放后文档坐标（文档坐标×scale）中的位置
+    QSize size;
+};
+
+// 静态子树的图层缓存：编辑频繁时，每次编辑后与脏区相交的分块都要重绘其中全部图元，
+// 背景等未变化的大组被反复光栅化。图层缓存把这些组按设备分辨率栅格化一次，
+// 之后分块重绘时直接合成图层图像，代替区间内的全部图元。
+// - 候选：显示列表登记的组区间（图元足够多，或声明了data-layer="static"），不含文本
+//   （文本包围盒不可靠，图层图像会裁掉越界部分）；
+// - 启用：声明static的组立即启用（只读浏览时同样受益）；其余组需在kStableRenders次
+//   与其相交的分块渲染中保持不变；
+// - 失效：组内任何元素、组的祖先（变换）或引用它的实例被修改时丢弃图像并重新计数；
+//   缩放与图像缩放相差超过kScaleTolerance时按新缩放重新栅格化。
+//   图层以文档坐标为基准，同一缩放下视图只平移（分块坐标不同）时图像原样复用。
+// 只在GUI线程访问；栅格化与合成由分块缓存在工作线程中完成
+class SvgLayerCache
+{
+public:
+    static const int kStableRenders = 3;
+    static constexpr qreal kScaleTolerance = 0.01;
+    static const qint64 kMaxLayerPixels = 4096 * 4096;   // 单个图层的像素上限，超出时该缩放下不缓存
+
+    // 显示列表已重新编译：按组重新登记区间，内容未变化（区间内图元相同）的组保留图像
+    void rebuild(const SvgDisplayList& list);
+    // 文档已编辑（在显示列表更新之后调用）
+    void documentChanged(const SvgDocumentChange& change, const SvgDisplayList& list);
+    void clear();
+    // 渲染任务被取消：正在栅格化的图层回到未请求状态
+    void cancelPending();
+
+    // 渲染一个分块（文档坐标矩形rect）前调用：与rect相交的组累计一次未变化的渲染；
+    // 返回与rect相交、已启用但在scale下没有可用图像的图层（返回的图层标记为栅格化中）
+    QVector<SvgLayerRequest> takeRequests(qreal scale, const QRectF& rect);
+    void storeLayer(const SvgLayerRequest& request, const QImage& image);
+    // scale下可用的图层（互不重叠，嵌套时取外层），供渲染任务合成
+    QVector<SvgLayerImage> layers(qreal scale) const;
+
+    void setMaxBytes(qint64 bytes) { mMaxBytes = bytes; }
+    qint64 bytes() const { return mBytes; }
+
+private:
+    struct Entry {
+        const SvgGroup* group = nullptr;
+        int first = 0;
+        int end = 0;
+        size_t signature = 0;     // 区间内图元元素的哈希，重新编译后据此判断内容是否变化
+        bool cacheable = true;    // 区间内没有文本
+        QRectF bounds;            // 区间内图元的文档坐标范围
+        int unchangedRenders = 0; // 最近一次内容变化后，与组相交的分块渲染次数（达到kStableRenders即停止计数）
+        bool pending = false;
+        QImage image;
+        qreal scale = 0;
+        QPoint origin;
+    };
+
+    bool isEnabled(const Entry& entry) const;
+    void dropImage(Entry* entry);
+    void invalidate(const SvgDocumentChange& change, const SvgDisplayList& list);
+    static QRectF rangeBounds(const SvgDisplayList& list, int first, int end);
+
+    QVector<Entry> mEntries;      // 与显示列表的组区间顺序一致
+    qint64 mBytes = 0;
+    qint64 mMaxBytes = 64 * 1024 * 1024;
+};
+
+#endif // SVGLAYERCACHE_H
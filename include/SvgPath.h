@@ -2,17 +2,59 @@
 #define SVG_PATH_H
 
 #include "SvgElement.h"
+#include "SvgPathData.h"
+#include <QAtomicInteger>
 #include <QPainterPath>
+#include <QMutex>
 
 class SvgPath : public SvgElement {
 public:
     SvgPath() : SvgElement(TypeShape) {}
-    void setPath(const QPainterPath& path) { mPath = path; }
-    QPainterPath path() const { return mPath; }
+    ~SvgPath() override;
+    void setPath(const QPainterPath& path);
+    // 转换为QPainterPath（绘制时使用），首次访问时生成并缓存在元素上；懒加载模式下同时解析d属性
+    QPainterPath path() const;
     void draw(SvgRenderer* renderer) const override;  // 重写draw
 
+    // 紧凑几何（float坐标 + 指令数组），路径在内存中的实际存储形式
+    void setGeometry(const SvgPathData& data);
+    // 包围盒已知时（如来自几何去重池）跳过重算
+    void setGeometry(const SvgPathData& data, const QRectF& bounds);
+    SvgPathData geometry() const;
+
+    // 几何已加载时返回紧致包围盒（曲线取极值），否则返回加载时估算的边界
+    QRectF boundingBox() const override;
+
+    // 懒加载：只保存原始d字符串，几何在首次使用时生成
+    void setPathData(const QString& d);
+    const QString& pathData() const { return mPathData; }
+    bool isLazy() const { return !mPathData.isEmpty(); }
+    bool isGeometryLoaded() const;
+
+    // 内存紧张时丢弃缓存的QPainterPath与懒加载路径已生成的几何（下次访问重新生成），返回释放的字节数
+    qint64 releaseGeometry() const;
+    // 进程内所有路径当前缓存的QPainterPath与懒加载几何的字节数，均可释放（内存预算检查用）
+    static qint64 materializedBytes() { return sMaterializedBytes.loadRelaxed(); }
+
 private:
-    QPainterPath mPath;
+    // 调用方需已持有mMutex
+    void ensureLoaded() const;
+    // 从进程计数中扣除本路径已生成的几何（调用方需已持有mMutex）
+    qint64 forgetMaterialized() const;
+    // 丢弃缓存的QPainterPath并从进程计数中扣除（调用方需已持有mMutex）
+    qint64 dropPainterPath() const;
+
+    QString mPathData;               // 懒加载模式下的原始路径数据
+    mutable SvgPathData mData;
+    mutable QRectF mBounds;          // 几何的紧致包围盒（随几何一起生成）
+    mutable bool mPathLoaded = true;
+    mutable qint64 mMaterialized = 0;   // 懒加载生成的几何计入sMaterializedBytes的字节数
+    mutable QPainterPath mPainterPath;  // 绘制用路径（首次绘制时生成）
+    mutable qint64 mPainterPathBytes = 0;
+    mutable bool mPainterPathCached = false;
+    mutable QMutex mMutex;           // 多线程渲染时保护懒加载状态
+
+    static QAtomicInteger<qint64> sMaterializedBytes;
 };
 
 #endif // SVG_PATH_H
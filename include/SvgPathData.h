@@ -0,0 +1,55 @@
+#ifndef SVG_PATH_DATA_H
+#define SVG_PATH_DATA_H
+
+#include <QVector>
+#include <QRectF>
+#include <QPainterPath>
+#include <QTransform>
+
+// 紧凑路径存储：指令与坐标分开保存，坐标使用float并按x,y交错排列。
+// 相比QPainterPath（每个点2个qreal + 类型标记），每段内存约减半；
+// 变换与包围盒计算直接在连续的float数组上做SIMD批处理
+class SvgPathData
+{
+public:
+    enum Verb : quint8 {
+        MoveTo,    // 1个点
+        LineTo,    // 1个点
+        CubicTo    // 3个点（两个控制点 + 终点）
+    };
+
+    SvgPathData() = default;
+
+    static SvgPathData fromPainterPath(const QPainterPath& path);
+    // 由指令与坐标数组直接构造（坐标数量与指令不匹配时返回空路径）
+    static SvgPathData fromArrays(const QVector<quint8>& verbs, const QVector<float>& coords);
+    // 绘制时才转换为QPainterPath
+    QPainterPath toPainterPath() const;
+
+    void moveTo(qreal x, qreal y);
+    void lineTo(qreal x, qreal y);
+    void cubicTo(qreal c1x, qreal c1y, qreal c2x, qreal c2y, qreal x, qreal y);
+
+    bool isEmpty() const { return mVerbs.isEmpty(); }
+    int verbCount() const { return mVerbs.size(); }
+    int pointCount() const { return mCoords.size() / 2; }
+    const QVector<quint8>& verbs() const { return mVerbs; }
+    const QVector<float>& coords() const { return mCoords; }
+
+    // 对所有坐标做仿射变换（忽略透视分量）
+    void transform(const QTransform& matrix);
+
+    // 控制点外包矩形（所有坐标的最小/最大值）
+    QRectF controlBounds() const;
+    // 紧致包围盒：三次曲线取导数零点处的极值，而非控制点
+    QRectF bounds() const;
+
+    // 实际占用的堆内存（字节）
+    qsizetype memoryUsage() const;
+
+private:
+    QVector<quint8> mVerbs;
+    QVector<float> mCoords;
+};
+
+#endif // SVG_PATH_DATA_H
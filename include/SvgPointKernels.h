@@ -0,0 +1,38 @@
+#ifndef SVGPOINTKERNELS_H
+#define SVGPOINTKERNELS_H
+
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QTransform>
+
+// 点数组的批处理内核：仿射变换与包围盒。大型折线/多边形（地图、曲线数据）动辄几十万个顶点，
+// 逐点调用QTransform::map或逐点比较min/max是绘制与加载中的热点。
+// 首次使用时按CPU选择实现：AVX2（每次两个点）、SSE2（每次一个点的x/y）或标量。
+// SIMD只用于GCC/Clang的x86目标（运行时检测AVX2）与MSVC的x64目标（SSE2为基线），
+// 其他平台及qreal不是double的构建使用标量实现；各实现的运算顺序相同，结果逐位一致
+class SvgPointKernels
+{
+public:
+    enum Isa {
+        IsaScalar,
+        IsaSse2,
+        IsaAvx2
+    };
+
+    // 当前选用的实现
+    static Isa isa();
+    static const char* isaName(Isa isa);
+
+    // dst[i] = transform.map(src[i])；src与dst可以是同一数组。透视变换逐点退回QTransform::map
+    static void map(const QTransform& transform, const QPointF* src, QPointF* dst, qsizetype count);
+    static QList<QPointF> map(const QTransform& transform, const QList<QPointF>& points);
+
+    // 点的包围盒（空数组为空矩形）
+    static QRectF bounds(const QPointF* points, qsizetype count);
+    static QRectF bounds(const QList<QPointF>& points) { return bounds(points.constData(), points.size()); }
+    // 变换后的点的包围盒，不生成中间数组（旋转/斜切下比变换包围盒更紧）
+    static QRectF mappedBounds(const QTransform& transform, const QList<QPointF>& points);
+};
+
+#endif // SVGPOINTKERNELS_H
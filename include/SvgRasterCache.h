@@ -0,0 +1,61 @@
+#ifndef SVGRASTERCACHE_H
+#define SVGRASTERCACHE_H
+
+#include <QByteArray>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include "SvgRasterWriter.h"
+#include "SvgRenderer.h"
+
+// 磁盘栅格缓存：以（SVG内容哈希、输出尺寸、视口、质量、格式、渲染器版本）的哈希为键，
+// 保存已编码的导出结果。命中时直接拷贝缓存文件，完全跳过解析与渲染。
+// 写入用QSaveFile原子替换，多个批处理进程可共享同一目录；总大小超过上限时按最近使用时间淘汰。
+// 命中/未命中统计在进程结束前合并进目录中的统计文件（QLockFile保护）
+class SvgRasterCache
+{
+public:
+    // 渲染结果会变化的修改（绘制、抗锯齿、编码器）都应递增，旧缓存自动失效。
+    // 2：use/symbol/defs参与绘制；3：折线/多边形按变换后的顶点范围跳过视口外的绘制；
+    // 4：包围盒计入方头端点的外伸（分块/单元边界处不再截断线端）；
+    // 5：懒加载路径的估算边界按放大后的弧线半径计算（过小的半径不再导致弧线被裁掉）
+    static const quint32 kRendererVersion = 5;
+    static const qint64 kDefaultMaxBytes = qint64(2) * 1024 * 1024 * 1024;
+
+    struct Statistics {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 stores = 0;
+        quint64 evictions = 0;
+    };
+
+    explicit SvgRasterCache(const QString& cacheDir);
+
+    void setMaxBytes(qint64 bytes) { mMaxBytes = bytes; }
+
+    // 计算缓存键。size中为0的边表示按viewBox推导；viewport为空表示整个文档
+    static QByteArray renderKey(const QString& sourceFile, const QSize& size, const QRectF& viewport,
+                                SvgRenderer::Quality quality, SvgRasterWriter::Format format);
+
+    // 命中时把缓存结果原子写入outputFile并返回true
+    bool fetch(const QByteArray& key, const QString& outputFile);
+    // 把已渲染的文件存入缓存，随后按上限淘汰
+    bool store(const QByteArray& key, const QString& renderedFile);
+
+    // 本进程内的统计
+    const Statistics& sessionStatistics() const { return mSession; }
+    // 把本进程的统计累加进缓存目录的统计文件并清零，返回所有进程的累计结果
+    Statistics flushStatistics();
+
+    QString cacheFilePath(const QByteArray& key) const;
+
+private:
+    static bool copyFile(const QString& from, const QString& to);
+    void evict();
+
+    QString mCacheDir;
+    qint64 mMaxBytes = kDefaultMaxBytes;
+    Statistics mSession;
+};
+
+#endif // SVGRASTERCACHE_H
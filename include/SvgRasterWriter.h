@@ -0,0 +1,48 @@
+#ifndef SVGRASTERWRITER_H
+#define SVGRASTERWRITER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <memory>
+
+class QIODevice;
+
+// 逐行写出RGBA栅格的流式编码器：先begin声明整幅尺寸，再按从上到下的顺序分批writeRows，
+// 最后finish。编码器只缓冲压缩输出的一小块，内存占用与图像高度无关（QImage::save需要整幅图像）
+class SvgRasterWriter
+{
+public:
+    enum Format {
+        FormatPng,   // 8位RGBA PNG（zlib压缩）
+        FormatPam    // Netpbm PAM，RGB_ALPHA不压缩，写出最快
+    };
+
+    virtual ~SvgRasterWriter() = default;
+
+    // 按文件扩展名选择格式（.pam为PAM，其余为PNG）
+    static Format formatForFileName(const QString& fileName);
+    // 创建写入device的编码器（不持有device）
+    static std::unique_ptr<SvgRasterWriter> create(Format format, QIODevice* device);
+
+    virtual bool begin(int width, int height) = 0;
+    // 写出若干整行：rows宽度须等于图像宽度，任意格式均可（内部转换为非预乘RGBA）
+    virtual bool writeRows(const QImage& rows) = 0;
+    virtual bool finish() = 0;
+
+    QString errorString() const { return mError; }
+
+protected:
+    explicit SvgRasterWriter(QIODevice* device) : mDevice(device) {}
+
+    bool writeBytes(const char* data, qint64 size);
+    bool fail(const QString& message);
+
+    QIODevice* mDevice;
+    int mWidth = 0;
+    int mHeight = 0;
+    int mRowsWritten = 0;
+    QString mError;
+};
+
+#endif // SVGRASTERWRITER_H
@@ -0,0 +1,89 @@
+#ifndef SVGRENDERSCHEDULER_H
+#define SVGRENDERSCHEDULER_H
+
+#include <QImage>
+#include <QRect>
+#include <QTransform>
+#include <QVector>
+#include <QAtomicInt>
+#include <limits>
+#include "SvgRenderer.h"
+#include "SvgLayerCache.h"
+
+class SvgDisplayList;
+
+// 按时间预算增量渲染显示列表：目标图像划分为若干裁剪单元，按离中心由近到远的顺序逐个绘制，
+// 每个单元只绘制网格索引查询到的相交图元。renderSlice在预算用完时返回，下次调用从中断处继续，
+// 两次调用之间image()即为可上屏的部分结果。begin只重置进度（O(单元数)），视图变化时重启代价很小。
+// 设置了图层时，图层区间内的图元不再逐个绘制，而是在区间首个相交图元的位置合成一次图层图像。
+// 遮挡剔除（默认开启）：每个单元查询后逆序扫描，跳过完全落在后绘制的不透明填充内部的图元，
+// 遮挡体只取轴对齐的不透明矩形与大块纯色填充的内接矩形，并向内留出抗锯齿余量，输出与不剔除时一致
+class SvgRenderScheduler
+{
+public:
+    static const int kCellSize = 256;
+
+    // 开始新一帧。target的现有内容保留到对应单元被重绘为止（未完成区域显示旧内容）；
+    // 传入时应不与其他QImage共享数据，否则首次绘制会整幅拷贝
+    void begin(const SvgDisplayList* list, const QTransform& viewTransform,
+               QImage target, SvgRenderer::Quality quality);
+    // 取出结果图像（之后调度器不再持有该图像）
+    QImage takeImage() { return std::move(mImage); }
+    // 在budgetMs毫秒内继续渲染，返回true表示整帧已完成
+    bool renderSlice(qint64 budgetMs);
+
+    // 一次性渲染：把显示列表按viewTransform绘制到size大小的透明图像（无界面环境与工作线程均可使用）
+    static QImage renderImage(const SvgDisplayList* list, const QTransform& viewTransform, const QSize& size,
+                              SvgRenderer::Quality quality = SvgRenderer::QualityFull,
+                              const QAtomicInt* abortFlag = nullptr,
+                              const QVector<SvgLayerImage>& layers = QVector<SvgLayerImage>());
+    // 一次性渲染图元区间[first, end)（栅格化图层）
+    static QImage renderRange(const SvgDisplayList* list, int first, int end, const QTransform& viewTransform,
+                              const QSize& size, SvgRenderer::Quality quality = SvgRenderer::QualityFull,
+                              const QAtomicInt* abortFlag = nullptr);
+
+    // 全局开关（用于对比验证）与进程内累计被遮挡跳过的图元数
+    static void setOcclusionCulling(bool enabled);
+    static bool occlusionCulling();
+    static quint64 totalOccludedItems();
+
+    void setAbortFlag(const QAtomicInt* flag) { mAbortFlag = flag; }
+    // 本帧被遮挡跳过的图元数（同一图元在多个单元中各计一次）
+    int occludedItems() const { return mOccludedItems; }
+    // 只绘制下标在[first, end)内的图元（在begin之前设置）
+    void setItemRange(int first, int end);
+    // 可合成的图层（互不重叠，按first升序；在begin之前设置）
+    void setLayers(const QVector<SvgLayerImage>& layers) { mLayers = layers; }
+    bool isFinished() const { return mCellIndex >= mCells.size(); }
+    const QImage& image() const { return mImage; }
+
+private:
+    bool isAborted() const { return mAbortFlag && mAbortFlag->loadRelaxed() != 0; }
+    // 包含图元index的图层下标，没有时返回-1
+    int layerAt(int index) const;
+    // 从mCellItems中移除被后绘制的不透明内容完全遮住的图元
+    void cullOccluded(const QRect& cell);
+
+    static bool sOcclusionCulling;
+    static QAtomicInteger<quint64> sOccludedItems;
+
+    const SvgDisplayList* mList = nullptr;
+    QTransform mView;
+    QTransform mInverseView;
+    QImage mImage;
+    SvgRenderer::Quality mQuality = SvgRenderer::QualityFull;
+    const QAtomicInt* mAbortFlag = nullptr;
+    int mFirstItem = 0;
+    int mEndItem = std::numeric_limits<int>::max();
+    QVector<SvgLayerImage> mLayers;
+    QVector<QTransform> mLayerPlacements;   // 图层像素→目标图像像素
+
+    QVector<QRect> mCells;        // 中心优先排序的裁剪单元（图像像素）
+    int mCellIndex = 0;
+    bool mCellStarted = false;
+    QVector<int> mCellItems;      // 当前单元的相交图元
+    int mItemIndex = 0;
+    int mOccludedItems = 0;
+};
+
+#endif // SVGRENDERSCHEDULER_H
@@ -2,6 +2,7 @@
 #define SVG_RENDERER_H
 
 #include "SvgStyle.h"
+#include <QAtomicInt>
 #include <QPainter>
 #include <QRectF>
 #include <QTransform>
@@ -10,10 +11,21 @@
 class SvgDocument;
 class SvgElement;
 class SvgTransform;
+struct SvgDisplayItem;
 
 class SvgRenderer
 {
 public:
+    // 渲染质量：草稿用于交互期间（关闭抗锯齿、跳过亚像素图形、文本使用预排版字形缓存，
+    // 并由调用方降低分辨率），完整质量用于静止时
+    enum Quality {
+        QualityDraft,
+        QualityFull
+    };
+
+    // 草稿渲染的分辨率比例
+    static constexpr qreal kDraftResolution = 0.5;
+
     SvgRenderer();
     ~SvgRenderer();
 
@@ -30,10 +42,34 @@ public:
     const QTransform& currentTransform() const { return mCurrentTransform; }
 
     void render(const SvgDocument* document, QPainter* painter, const QRectF& viewport);
+    // 按给定的视图变换（文档坐标→设备坐标）绘制，用于缩放/平移与分块渲染
+    void render(const SvgDocument* document, QPainter* painter, const QTransform& viewTransform);
+
+    // 将viewBox等比例居中适配到视口的变换
+    static QTransform fitTransform(const QRectF& viewBox, const QRectF& viewport);
+
+    // 绘制单个元素：先叠加元素自身的变换再调用draw（组绘制子元素时也经由此处，变换只应用一次）
+    void renderElement(const SvgElement* element, QPainter* painter);
+    // 绘制显示列表中的一个图元（需先setPainter）：图元累积变换叠加视图变换后直接绘制叶子元素
+    void renderItem(const SvgDisplayItem& item, const QTransform& viewTransform);
+    // 按当前质量设置画笔的渲染提示
+    void applyQualityHints(QPainter* painter) const;
 
     // 获取当前样式（用于继承）
     const SvgStyle& currentStyle() const { return mCurrentStyle; }
 
+    void setQuality(Quality quality) { mQuality = quality; }
+    Quality quality() const { return mQuality; }
+    // 草稿质量下，设备空间中宽高都不足1像素的图形直接跳过（细节层次简化）
+    bool isBelowDetailThreshold(const SvgElement* element) const;
+    // 折线/多边形的顶点批量变换到设备坐标后（含描边半宽与1像素抗锯齿余量）是否与可见区域相交。
+    // 显示列表按变换后的包围盒剔除，旋转/斜切时包围盒偏大，这里按顶点的实际范围判断
+    bool isPointsVisible(const QList<QPointF>& points, qreal strokeWidth) const;
+
+    // 取消标志：由后台渲染任务持有，置位后绘制在下一个元素处提前结束
+    void setAbortFlag(const QAtomicInt* flag) { mAbortFlag = flag; }
+    bool isAborted() const { return mAbortFlag && mAbortFlag->loadRelaxed() != 0; }
+
     // 应用变换（用于嵌套元素）
     void applyTransform(const QTransform& transform) {
         mCurrentTransform *= transform;
@@ -46,7 +82,8 @@ private:
     SvgStyle mCurrentStyle;   // 当前样式（用于继承）
     // 2. 添加缺失的mCurrentTransform成员变量
     QTransform mCurrentTransform;  // 存储当前变换矩阵
-    void renderElement(const SvgElement* element, QPainter* painter);
+    const QAtomicInt* mAbortFlag = nullptr;
+    Quality mQuality = QualityFull;
 
 };
 
@@ -0,0 +1,105 @@
+#ifndef SVGSCENESTORE_H
+#define SVGSCENESTORE_H
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QRgb>
+#include <QTransform>
+#include <QVector>
+#include "SvgElement.h"
+
+// 绘制相关的样式热数据（颜色与线宽），按值去重后以句柄引用
+struct SvgHotStyle
+{
+    QRgb fill = 0;          // 无填充记为0
+    QRgb stroke = 0;
+    qreal strokeWidth = 0;
+
+    // 填充必然完全不透明（遮挡剔除只需这一列，不必访问元素的完整样式）
+    bool opaqueFill() const { return qAlpha(fill) == 255; }
+
+    bool operator==(const SvgHotStyle& other) const
+    {
+        return fill == other.fill && stroke == other.stroke && strokeWidth == other.strokeWidth;
+    }
+};
+
+inline size_t qHash(const SvgHotStyle& style, size_t seed = 0)
+{
+    return qHashMulti(seed, style.fill, style.stroke, style.strokeWidth);
+}
+
+// 元素热数据的列式存储（structure of arrays）：元素按文档前序编号（序号），
+// 类型、父序号、子树末尾、世界变换、包围盒、样式句柄与可见性各存一个连续数组。
+// 包围盒合并（视图的分块范围）只顺序扫描需要的几列，
+// 不再沿指针逐个访问散落在堆上的元素对象（包围盒四列可被编译器向量化）。
+// 子树对应连续的序号区间[i, subtreeEnd(i))，父序号总小于子序号。
+// 由SvgDocument在加载完成后建立并随编辑更新；读取期间文档不得修改
+class SvgSceneStore
+{
+public:
+    enum Flag : quint8 {
+        FlagRendered = 0x01,    // 不在defs/symbol中（直接参与绘制）
+        FlagLeaf = 0x02,        // 非组元素（显示列表中的一个图元）
+        FlagUnbounded = 0x04    // 包围盒不可靠（文本），不计入包围盒四列
+    };
+
+    // 描边超出几何的距离（元素局部坐标）：SvgStyle::applyToPainter的画笔为方头端点、斜角连接，
+    // 斜线端点处方头的角最远伸出半线宽的√2倍（斜角连接不超过半线宽）；
+    // 零宽/零高的几何（水平线）也需要可相交的面积，至少0.5
+    static qreal strokeMargin(qreal strokeWidth);
+    // 叶子元素在文档坐标下的包围盒：几何四周放宽strokeMargin
+    static QRectF leafBounds(const SvgElement* element, const QTransform& world);
+
+    void build(const QList<SvgElement*>& roots);
+    void clear();
+    // 元素的属性、样式或变换已修改（子树结构不变）：原地重算其子树的世界变换、包围盒与样式，
+    // 并更新祖先的子树包围盒。返回false表示元素不在存储中
+    bool updateElement(const SvgElement* element);
+
+    int size() const { return mElements.size(); }
+    bool isEmpty() const { return mElements.isEmpty(); }
+    int ordinalOf(const SvgElement* element) const { return mOrdinals.value(element, -1); }
+
+    const SvgElement* element(int ordinal) const { return mElements.at(ordinal); }
+    SvgElement::ElementType type(int ordinal) const { return SvgElement::ElementType(mTypes.at(ordinal)); }
+    int parent(int ordinal) const { return mParents.at(ordinal); }
+    int subtreeEnd(int ordinal) const { return mSubtreeEnds.at(ordinal); }
+    quint8 flags(int ordinal) const { return mFlags.at(ordinal); }
+    const QTransform& worldTransform(int ordinal) const { return mWorlds.at(ordinal); }
+    // 叶子：自身包围盒（已含描边半宽）；组：子树内可见有界叶子的并集；不计入包围盒的元素为空
+    QRectF bounds(int ordinal) const;
+    int styleHandle(int ordinal) const { return mStyleHandles.at(ordinal); }
+    const SvgHotStyle& style(int handle) const { return mStyles.at(handle); }
+    // 去重后的样式表（隐式共享，显示列表按句柄引用）
+    const QVector<SvgHotStyle>& styles() const { return mStyles; }
+
+    // 全部可见有界叶子包围盒的并集
+    QRectF unitedBounds() const;
+
+private:
+    void computeEntry(int ordinal);
+    // 叶子区间[first, end)的包围盒并集（四列顺序扫描，空区间为空矩形）
+    QRectF rangeBounds(int first, int end) const;
+    int internStyle(const SvgStyle& style);
+
+    QVector<const SvgElement*> mElements;
+    QVector<quint8> mTypes;
+    QVector<int> mParents;            // 顶层元素为-1
+    QVector<int> mSubtreeEnds;
+    QVector<quint8> mFlags;
+    QVector<QTransform> mWorlds;
+    // 可见有界叶子的包围盒，其余元素为(+inf, +inf, -inf, -inf)，在并集与相交比较中自然不起作用
+    QVector<qreal> mMinX;
+    QVector<qreal> mMinY;
+    QVector<qreal> mMaxX;
+    QVector<qreal> mMaxY;
+    QVector<QRectF> mSubtreeBounds;   // 组的子树包围盒（叶子直接用上面四列）
+    QVector<int> mStyleHandles;
+    QVector<SvgHotStyle> mStyles;
+    QHash<SvgHotStyle, int> mStyleIndex;
+    QHash<const SvgElement*, int> mOrdinals;
+};
+
+#endif // SVGSCENESTORE_H
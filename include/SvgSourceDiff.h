@@ -0,0 +1,50 @@
+#ifndef SVGSOURCEDIFF_H
+#define SVGSOURCEDIFF_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class SvgDocument;
+
+// 源文本子树签名：与SvgStreamLoader相同的遍历规则，每个被支持的元素对应一个节点，
+// 因此签名树与文档元素树一一对应
+struct SvgSubtreeSignature
+{
+    QString tagName;
+    QString id;
+    size_t selfHash = 0;     // 标签、属性与文本
+    size_t attributeNames = 0;         // 属性名序列的hash
+    QVector<size_t> attributes;        // 每个属性（名与值）的hash，按源文本顺序
+    size_t hash = 0;         // selfHash与全部子节点hash的组合
+    int ordinal = 0;         // 文档顺序中的序号（只计被支持的元素）
+    int count = 1;           // 子树中的元素数（含自身）
+    bool nestedSvg = false;  // 子树中含嵌套svg（会改写文档viewBox）
+    QVector<SvgSubtreeSignature> children;
+};
+
+// 增量重新加载：只扫描新源文本计算子树签名（不创建元素），与上一次的签名按id与位置对齐比较，
+// 签名相同的子树原样保留。属性名不变、只有属性值变化的叶子经由setAttribute原地修改
+// （监听者增量更新，不重新编译）；其余变化的子树重建，全部结构修改合并为一次批量编辑。
+// 修改经由文档编辑接口，视图只重绘变化的区域
+class SvgSourceDiff
+{
+public:
+    struct Result {
+        int removed = 0;
+        int inserted = 0;     // 新建的子树数（含替换）
+        int rebuiltElements = 0;
+        int updatedElements = 0;   // 只有属性值变化、经由setAttribute原地修改的叶子
+    };
+
+    // 读取文件全部内容（gzip压缩的SVGZ自动解压）
+    static bool readSource(const QString& fileName, QByteArray* data);
+    // 扫描源数据生成签名树；XML不完整（如文件正在写入）时返回false
+    static bool scan(const QByteArray& data, SvgSubtreeSignature* root);
+    // 把document从oldRoot对应的内容更新为newData（其签名为newRoot）。
+    // 根元素自身变化、含嵌套svg的子树变化、文档已做过树优化或与签名不对应时不做任何修改并返回false，调用方应整体重新加载
+    static bool apply(SvgDocument* document, const SvgSubtreeSignature& oldRoot,
+                      const SvgSubtreeSignature& newRoot, const QByteArray& newData, Result* result);
+};
+
+#endif // SVGSOURCEDIFF_H
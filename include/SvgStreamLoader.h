@@ -0,0 +1,109 @@
+#ifndef SVGSTREAMLOADER_H
+#define SVGSTREAMLOADER_H
+
+#include <QRectF>
+#include <QStack>
+#include <QString>
+#include <QTransform>
+#include <QVector>
+#include <QXmlStreamReader>
+#include <memory>
+#include <vector>
+
+class QThreadPool;
+class SvgDocument;
+class SvgElement;
+class SvgGroup;
+class SvgNodeSource;
+
+// 标签记录：一个元素的标签名、属性与文本（text元素），以及容器元素的子记录。
+// 并行构建时把超过阈值的子树余下的部分读成记录，再交给工作线程生成元素
+struct SvgNodeRecord
+{
+    QString tagName;
+    QXmlStreamAttributes attributes;
+    QString text;
+    QVector<SvgNodeRecord> children;
+};
+
+// 流式加载器：用QXmlStreamReader逐个读取标签并即时构建元素树，不生成完整DOM。
+// 每个元素的属性表直接交给SvgElementFactory，属性值以QStringView读取、不再复制到中间元素，
+// 因此峰值内存约为“输入缓冲 + 元素树”
+class SvgStreamLoader
+{
+public:
+    explicit SvgStreamLoader(SvgDocument* document);
+    ~SvgStreamLoader();
+
+    // 解析整个输入，返回根元素（调用方负责释放）；失败时返回nullptr
+    SvgElement* parse(QXmlStreamReader& reader);
+
+    // 增量解析：最多处理maxElements个元素后返回，用于边加载边绘制。
+    // 返回true表示还有剩余输入；返回false表示已结束（成功或失败，见hasError）
+    bool parseChunk(QXmlStreamReader& reader, int maxElements);
+
+    // 已创建的根元素（解析过程中即可访问，后续块会继续向其中追加子元素）
+    SvgElement* root() const { return mRoot; }
+    // 取得根元素的所有权（之后加载器仍可向其追加子元素，但出错时不再释放它）
+    SvgElement* takeRoot();
+
+    // 已加入元素树的元素（含已拼接的并行子树）在根元素坐标下的范围并集，随每个新元素累计，
+    // 不重算已有子树；渐进加载期间据此估算临时viewBox
+    QRectF loadedBounds() const { return mLoadedBounds; }
+
+    bool hasError() const { return !mErrorString.isEmpty(); }
+    QString errorString() const { return mErrorString; }
+
+    // 从reader当前的开始标签读取并构建整棵子树（读完其结束标签）；标签不被支持时返回nullptr
+    static SvgElement* buildSubtree(QXmlStreamReader& reader, SvgDocument* document);
+
+    // 并行构建（0表示关闭）：根元素的直接子树照常在当前线程流式构建，元素数超过阈值后，
+    // 该子树余下的部分整体记录并交给线程池构建，小子树不产生任何记录
+    static void setParallelThreshold(int elementCount) { sParallelThreshold = elementCount; }
+    static int parallelThreshold() { return sParallelThreshold; }
+
+private:
+    // 并行模式下根元素的一个子树槽位，按文档顺序拼接
+    struct BuildSlot;
+
+    // 当前开始标签的属性表（以及text元素的文本内容），作为工厂的输入
+    static SvgNodeSource currentSource(QXmlStreamReader& reader, const QString& tagName);
+
+    // 从当前开始标签读取整棵子树到记录中，返回子树元素数量
+    static int recordSubtree(QXmlStreamReader& reader, SvgNodeRecord& record, bool& hasNestedSvg);
+    // 读取stack栈顶容器余下的子元素到记录中，直到栈中所有容器的结束标签都已读完；
+    // includeCurrent为true时reader当前的开始标签也计入。返回读取的元素数量
+    static int recordChildren(QXmlStreamReader& reader, QStack<SvgNodeRecord*>& stack, bool includeCurrent,
+                              bool& hasNestedSvg);
+    // 从reader当前的开始标签起，把正在流式构建的根子树余下的部分交给线程池，返回读取的元素数量
+    int offloadRemainder(QXmlStreamReader& reader);
+    // 由分流的记录构建元素并追加到对应容器（可在工作线程中调用）
+    static void buildRemainder(BuildSlot* slot, SvgDocument* document);
+    // 由记录构建元素子树（显式栈；可在工作线程中调用）
+    static SvgElement* buildFromRecord(const SvgNodeRecord& record, SvgDocument* document);
+
+    // 等待并行任务完成，按文档顺序把子树拼接到根元素
+    // wait为false时只拼接已完成的前缀（渐进加载的安全点），不阻塞
+    void spliceSlots(SvgGroup* root, bool wait);
+    void discardSlots();
+    // 把新加入的元素（在parentWorld坐标系下，组为整棵子树）并入mLoadedBounds
+    void includeBounds(const SvgElement* element, const QTransform& parentWorld);
+
+    SvgDocument* mDocument;
+    QString mErrorString;
+    SvgElement* mRoot = nullptr;
+    bool mOwnsRoot = false;
+    bool mFinished = false;
+    QStack<SvgGroup*> mOpenGroups;   // 当前尚未闭合的容器（显式栈，不递归）
+    QStack<QTransform> mOpenTransforms;   // 与mOpenGroups对应：容器局部坐标→根元素坐标
+    QRectF mLoadedBounds;
+    size_t mSpliced = 0;             // 已拼接进根元素的槽位数
+    BuildSlot* mStreamingSlot = nullptr;   // 正在当前线程流式构建的根子树（尚未超过阈值）
+    int mStreamedCount = 0;                // 该根子树已读取的元素数
+    std::vector<std::unique_ptr<BuildSlot>> mSlots;
+    std::unique_ptr<QThreadPool> mPool;   // 本次加载专用线程池，空闲线程按需领取子树任务
+
+    static int sParallelThreshold;
+};
+
+#endif // SVGSTREAMLOADER_H
@@ -4,6 +4,7 @@
 #include "SvgPen.h"
 #include "SvgBrush.h"
 #include <QString>
+#include <QStringView>
 #include <QFont>
 
 class SvgStyle
@@ -31,8 +32,10 @@ public:
 
     void applyToPainter(QPainter* painter, bool isText) const;
 
-    void parseStyleString(const QString& styleStr);
+    void parseStyleString(QStringView styleStr);
     void parseAttribute(const QString& name, const QString& value);
+    // parseAttribute能识别的样式属性名
+    static bool isStyleProperty(const QString& name);
 
     // 合并样式：用other的属性覆盖当前未设置的属性
     void merge(const SvgStyle& other);
@@ -41,6 +44,9 @@ public:
     void setFill(const QColor& fill) { mFill = fill; }
     void setStroke(const QColor& stroke) { mStroke = stroke; }
     void setStrokeWidth(qreal width) { mStrokeWidth = width; }
+    void setFontFamily(const QString& family) { mFontFamily = family; }
+    void setFontSize(qreal size) { mFontSize = size; }
+    void setTextAnchor(const QString& anchor) { mTextAnchor = anchor; }
 
     // 判断属性是否有效
     bool hasFill() const { return mFill.isValid(); }
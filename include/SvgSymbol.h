@@ -0,0 +1,29 @@
+#ifndef SVGSYMBOL_H
+#define SVGSYMBOL_H
+
+#include "SvgGroup.h"
+
+// <symbol>：可复用的图形模板。与defs一样不直接绘制，只作为<use>的实例内容；
+// 有viewBox且use给出宽高时，内容按viewBox适配到该区域
+class SvgSymbol : public SvgGroup
+{
+public:
+    explicit SvgSymbol(const QString& id = "");
+
+    void draw(SvgRenderer* renderer) const override;
+    QRectF boundingBox() const override { return QRectF(); }
+    bool isRendered() const override { return false; }
+
+    // 实例化时绘制子元素（symbol自身的变换不参与，由use决定位置）
+    void drawContent(SvgRenderer* renderer) const;
+    // 子元素在symbol坐标下的范围
+    QRectF contentBounds() const { return SvgGroup::boundingBox(); }
+
+    QRectF viewBox() const { return mViewBox; }
+    void setViewBox(const QRectF& viewBox) { mViewBox = viewBox; }
+
+private:
+    QRectF mViewBox;
+};
+
+#endif // SVGSYMBOL_H
@@ -4,6 +4,9 @@
 #include "SvgElement.h"
 #include <QPointF>
 #include <QString>
+#include <QStaticText>
+#include <QFont>
+#include <QMutex>
 
 class SvgText : public SvgElement
 {
@@ -23,9 +26,18 @@ public:
     void setTextAnchor(const QString& anchor) { mTextAnchor = anchor; }
 
 private:
+    // 草稿质量：使用预排版的QStaticText绘制，不再逐帧整形；设备字号过小时不绘制
+    void drawDraft(QPainter* painter, const QFont& font, const SvgStyle& style) const;
+
     QPointF mPosition{0.0, 0.0};
     QString mText;
     QString mTextAnchor = "middle";
+
+    // 草稿绘制的字形缓存（多个后台渲染任务可能同时绘制同一文本，由互斥量保护）
+    mutable QMutex mStaticTextMutex;
+    mutable QStaticText mStaticText;
+    mutable QFont mStaticTextFont;
+    mutable qreal mStaticTextAscent = 0;
 };
 
 #endif // SVGTEXT_H
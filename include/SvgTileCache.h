@@ -0,0 +1,110 @@
+#ifndef SVGTILECACHE_H
+#define SVGTILECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QRectF>
+#include <QSet>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <memory>
+#include "SvgRenderer.h"
+#include "SvgDisplayList.h"
+#include "SvgLayerCache.h"
+
+class SvgDocument;
+struct SvgDocumentChange;
+
+// 分块键：缩放级别 + 该级别像素空间中的分块坐标
+struct SvgTileKey
+{
+    int level = 0;
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const SvgTileKey& other) const
+    {
+        return level == other.level && x == other.x && y == other.y;
+    }
+};
+
+inline size_t qHash(const SvgTileKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.level, key.x, key.y);
+}
+
+// 多分辨率分块缓存：级别L的缩放为 baseScale * 2^L（像素/文档单位），
+// 每个分块是该级别像素空间中kTileSize×kTileSize的一块。
+// 缺失的分块在线程池中异步渲染，完成后发出tileReady；按字节预算做LRU淘汰。
+// 编辑后重绘分块时，未变化的大组由图层缓存提供整块图像合成（见SvgLayerCache）
+class SvgTileCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kTileSize = 256;
+
+    explicit SvgTileCache(QObject* parent = nullptr);
+    ~SvgTileCache() override;
+
+    // 绑定文档与级别0的缩放（清空已有分块并编译显示列表）；文档在渲染期间必须保持不变
+    void setDocument(const SvgDocument* document, qreal baseScale);
+    // 清空所有分块，并等待正在渲染的任务结束（文档即将修改或销毁前调用）
+    void clear();
+    // 丢弃尚未开始的渲染请求（视图级别变化后旧请求已无意义）
+    void cancelPending();
+    // 文档即将被编辑：取消所有渲染任务并等待其退出（已缓存的分块保留）
+    void suspend();
+    // 文档已编辑：增量更新显示列表，与dirtyRect相交的分块标记为过期——
+    // 继续显示旧内容，下次绘制时按完整质量重绘，其余分块不受影响
+    void documentChanged(const SvgDocumentChange& change);
+
+    qreal baseScale() const { return mBaseScale; }
+    qreal levelScale(int level) const;
+    // 分块在文档坐标中覆盖的矩形
+    QRectF tileRect(const SvgTileKey& key) const;
+
+    // 取已缓存的分块（未缓存时返回空图像），并更新LRU次序
+    QImage tile(const SvgTileKey& key);
+    // 已缓存的分块是否为草稿质量或内容已过期（需要在静止时重绘）
+    bool isDraft(const SvgTileKey& key) const { return mDraftTiles.contains(key); }
+    // 请求异步渲染分块（已缓存同等或更高质量、或已在渲染队列中时忽略）。
+    // 草稿分块以降低的分辨率渲染，绘制时按同一目标矩形放大
+    void requestTile(const SvgTileKey& key, SvgRenderer::Quality quality = SvgRenderer::QualityFull);
+    // 完整质量分块的平均渲染耗时（毫秒），用于决定交互期间是否改用草稿
+    qreal averageTileTime() const { return mAverageTileTime; }
+
+    void setMaxBytes(qint64 bytes) { mMaxBytes = bytes; }
+    void setMaxLayerBytes(qint64 bytes) { mLayers.setMaxBytes(bytes); }
+
+signals:
+    void tileReady();
+
+private:
+    void storeTile(int generation, const SvgTileKey& key, const QImage& image,
+                   SvgRenderer::Quality quality, qint64 elapsedMs);
+    void evict();
+    // 为即将渲染的完整质量分块提交所需图层的栅格化任务
+    void requestLayers(qreal scale, const QRectF& rect);
+
+    const SvgDocument* mDocument = nullptr;
+    SvgDisplayList mDisplayList;   // 分块只绘制与自身相交的图元
+    SvgLayerCache mLayers;
+    qreal mBaseScale = 1.0;
+
+    QHash<SvgTileKey, QImage> mTiles;
+    QHash<SvgTileKey, quint64> mLastUse;   // LRU时间戳
+    QSet<SvgTileKey> mPending;             // 已提交但尚未完成的分块
+    QSet<SvgTileKey> mDraftTiles;          // 以草稿质量缓存或编辑后过期的分块
+    qreal mAverageTileTime = 0;            // 指数滑动平均
+    quint64 mClock = 0;
+    qint64 mBytes = 0;
+    qint64 mMaxBytes = 256 * 1024 * 1024;
+
+    QThreadPool mPool;
+    int mGeneration = 0;                   // 清空时递增，旧任务的结果被丢弃
+    std::shared_ptr<QAtomicInt> mAbort;    // 当前一代任务的取消标志，清空时置位使其尽快退出
+};
+
+#endif // SVGTILECACHE_H
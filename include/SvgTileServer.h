@@ -0,0 +1,91 @@
+#ifndef SVGTILESERVER_H
+#define SVGTILESERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QLocalServer>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+#include <memory>
+
+class QLocalSocket;
+
+// 常驻分块渲染服务：通过QLocalServer接收 z/x/y 分块请求，返回PNG。
+// 已解析的文档按内存预算做LRU缓存（文件修改后自动重新加载），编码后的分块另有一级缓存，
+// 渲染在工作线程池中进行；同一连接上的请求按顺序应答。
+//
+// 协议（每行一个请求）：
+//   TILE <z> <x> <y> <size> <path>\n  →  OK <字节数>\n<PNG数据>  或  ERR <原因>\n
+//   STATS\n                           →  OK <字节数>\n<统计文本>
+// 级别z时viewBox的长边被划分为2^z个分块，每个分块size×size像素
+class SvgTileServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kDefaultTileSize = 256;
+
+    explicit SvgTileServer(QObject* parent = nullptr);
+    ~SvgTileServer() override;
+
+    bool listen(const QString& serverName);
+    QString errorString() const { return mServer.errorString(); }
+
+    void setDocumentBudget(qint64 bytes) { mDocumentBudget = bytes; }
+    void setTileCacheBudget(qint64 bytes);
+    void setWorkerCount(int count) { mPool.setMaxThreadCount(count); }
+
+    // 客户端：连接服务并同步请求一个分块（命令行客户端与测试用）
+    static bool fetchTile(const QString& serverName, const QString& filePath,
+                          int z, int x, int y, int tileSize,
+                          QByteArray* png, QString* error, int timeoutMs = 30000);
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Request {
+        QString path;
+        int z = 0;
+        int x = 0;
+        int y = 0;
+        int size = kDefaultTileSize;
+    };
+    struct Connection {
+        QByteArray buffer;   // 尚未处理的输入
+        bool busy = false;   // 是否有请求正在工作线程中处理
+    };
+    struct CachedDocument;
+
+    // 处理连接缓冲中的下一个完整请求行（GUI线程）
+    void processNext(QLocalSocket* socket);
+    static bool parseRequest(const QByteArray& line, Request* request, QString* error);
+
+    // 以下在工作线程中调用
+    QByteArray handleTile(const Request& request);
+    std::shared_ptr<CachedDocument> acquireDocument(const QString& path, QString* error);
+    QByteArray statsText();
+
+    void evictDocuments();   // 调用方持有mMutex
+
+    QLocalServer mServer;
+    QHash<QLocalSocket*, Connection> mConnections;
+    QThreadPool mPool;
+
+    QMutex mMutex;   // 保护以下所有成员
+    QHash<QString, std::shared_ptr<CachedDocument>> mDocuments;
+    QHash<QString, std::shared_ptr<QMutex>> mLoadLocks;   // 同一文件只解析一次
+    QCache<QString, QByteArray> mTiles;                   // 编码后的分块，代价为字节数
+    qint64 mDocumentBytes = 0;
+    qint64 mDocumentBudget = qint64(1024) * 1024 * 1024;
+    quint64 mClock = 0;
+    quint64 mRequests = 0;
+    quint64 mTileHits = 0;
+    quint64 mDocumentHits = 0;
+    quint64 mDocumentLoads = 0;
+};
+
+#endif // SVGTILESERVER_H
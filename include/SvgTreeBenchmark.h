@@ -0,0 +1,45 @@
+#ifndef SVGTREEBENCHMARK_H
+#define SVGTREEBENCHMARK_H
+
+#include <QByteArray>
+#include <QString>
+
+// 元素树遍历的基准测试（命令行--tree-bench，默认不运行）：生成深层嵌套（每层一个<g>）与
+// 超宽（一个组下大量图元）的合成文档，分别计时加载、元素计数、包围盒、绘制与二进制缓存往返。
+// 深层文档能完整走完所有步骤，即说明这些遍历不再依赖调用栈深度
+class SvgTreeBenchmark
+{
+public:
+    static const int kDefaultDepth = 10000;
+    static const int kDefaultWidth = 100000;
+
+    struct Result {
+        QString name;
+        int elements = 0;
+        qint64 loadMs = 0;
+        qint64 countMs = 0;
+        qint64 boundsMs = 0;
+        qint64 drawMs = 0;
+        qint64 cacheStoreMs = 0;
+        qint64 cacheRestoreMs = 0;
+        bool ok = false;
+        QString error;
+    };
+
+    void setDepth(int depth) { mDepth = depth; }
+    void setWidth(int width) { mWidth = width; }
+
+    // 依次运行深层与超宽两个场景，每个场景用qInfo输出一行结果；任一场景失败返回false
+    bool run();
+
+    static QByteArray deepDocument(int depth);
+    static QByteArray wideDocument(int width);
+
+private:
+    static Result runScenario(const QString& name, const QByteArray& source, const QString& cacheDir);
+
+    int mDepth = kDefaultDepth;
+    int mWidth = kDefaultWidth;
+};
+
+#endif // SVGTREEBENCHMARK_H
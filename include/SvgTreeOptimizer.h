@@ -0,0 +1,29 @@
+#ifndef SVGTREEOPTIMIZER_H
+#define SVGTREEOPTIMIZER_H
+
+class SvgDocument;
+class SvgElement;
+
+// 加载后的树优化（可选）：导出工具生成的SVG常有长串只带平移的嵌套<g>，
+// 每层都要一次painter save/restore和一次变换压栈。
+// 1. 展开没有id、样式为默认值的组：子元素上移到父组，组变换合并进子元素变换；
+// 2. 只含平移/缩放的变换直接烘焙进图形坐标（rect/circle/line/polyline/polygon/path），元素变换变为单位矩阵。
+// 组样式目前不向子元素继承、子元素各自设置画笔，因此展开不改变绘制结果；
+// 带可见描边的元素只在等比缩放时烘焙（描边宽度同比缩放），非等比缩放保留原变换。
+// 优化后元素坐标与源文本不再一一对应，文档被标记为已优化（增量重新加载随之退化为整体重新加载）
+class SvgTreeOptimizer
+{
+public:
+    struct Result {
+        int flattenedGroups = 0;    // 被展开（删除）的组
+        int mergedTransforms = 0;   // 与上层组变换合并的元素变换
+        int bakedTransforms = 0;    // 烘焙进坐标的变换
+    };
+
+    static Result optimize(SvgDocument* document);
+
+    // 把element自身只含平移/缩放的变换烘焙进坐标，成功时返回true（元素变换已重置为单位矩阵）
+    static bool bakeTransform(SvgElement* element);
+};
+
+#endif // SVGTREEOPTIMIZER_H
@@ -0,0 +1,32 @@
+#ifndef SVGTREEWALKER_H
+#define SVGTREEWALKER_H
+
+#include <QList>
+#include <functional>
+
+class SvgElement;
+
+// 元素树访问者：enter在进入元素时（前序）调用，返回false则跳过其子树、也不再调用leave；
+// leave在元素的子树全部访问完之后（后序）调用
+class SvgTreeVisitor
+{
+public:
+    virtual ~SvgTreeVisitor() = default;
+    virtual bool enter(const SvgElement* element) = 0;
+    virtual void leave(const SvgElement* element) { Q_UNUSED(element); }
+};
+
+// 显式栈的元素树遍历：嵌套深度只受堆内存限制（机器生成的上万层<g>也不会栈溢出），
+// 组的子元素按文档顺序访问，defs/symbol等定义容器同样展开（是否跳过由访问者决定）。
+// 遍历期间不得增删正在遍历的子树
+class SvgTreeWalker
+{
+public:
+    static void walk(const SvgElement* root, SvgTreeVisitor* visitor);
+    static void walk(const QList<SvgElement*>& roots, SvgTreeVisitor* visitor);
+    // 只需前序访问时的简便形式：visit返回false跳过子树
+    static void preOrder(const SvgElement* root, const std::function<bool(const SvgElement*)>& visit);
+    static void preOrder(const QList<SvgElement*>& roots, const std::function<bool(const SvgElement*)>& visit);
+};
+
+#endif // SVGTREEWALKER_H
@@ -0,0 +1,66 @@
+#ifndef SVGUSE_H
+#define SVGUSE_H
+
+#include "SvgElement.h"
+#include <QMutex>
+#include <QTransform>
+#include <memory>
+
+// <use>实例：只保存被引用元素的id、位置与解析后的目标指针，不复制目标的几何。
+// 大量实例引用同一符号时，内存只随实例数增长；绘制时在实例变换下重放目标子树。
+// 目标由SvgDocument按id索引解析（加载完成、结构编辑或id/href修改后重新解析），未解析时不绘制
+class SvgUse : public SvgElement
+{
+public:
+    // 目标内容在目标父坐标系下的外观范围（含描边半宽），由引用同一目标的所有实例共享，
+    // 只在首次查询时遍历目标子树
+    struct TargetBounds {
+        QMutex mutex;
+        QRectF bounds;
+        bool valid = false;
+        quint64 generation = 0;   // 每次失效递增，遍历期间失效时丢弃结果
+    };
+
+    explicit SvgUse(const QString& id = "");
+
+    void draw(SvgRenderer* renderer) const override;
+    // 目标内容在use坐标下的外观范围（含描边半宽）；目标未解析时为空
+    QRectF boundingBox() const override;
+
+    // 被引用元素的id（不含'#'）
+    const QString& href() const { return mHref; }
+    void setHref(const QString& href) { mHref = href; }
+
+    qreal x() const { return mX; }
+    void setX(qreal x) { mX = x; }
+    qreal y() const { return mY; }
+    void setY(qreal y) { mY = y; }
+    // 引用带viewBox的symbol时的实例尺寸（0表示不缩放）
+    qreal width() const { return mWidth; }
+    void setWidth(qreal width) { mWidth = width; }
+    qreal height() const { return mHeight; }
+    void setHeight(qreal height) { mHeight = height; }
+
+    const SvgElement* target() const { return mTarget; }
+    // bounds为引用同一目标的实例共享的范围缓存（为空时单独建立一份）
+    void setTarget(const SvgElement* target, const std::shared_ptr<TargetBounds>& bounds = nullptr);
+    // 目标子树被修改后由文档调用：共享缓存失效，引用同一目标的所有实例下次查询时重算
+    void invalidateTargetBounds() const;
+
+    // 目标坐标→use坐标：x/y平移，引用symbol时再叠加viewBox到实例尺寸的适配
+    QTransform instanceTransform() const;
+
+private:
+    // 遍历目标子树，计算目标父坐标系下的范围（symbol取其子元素，不含symbol自身变换）
+    QRectF targetBounds() const;
+
+    QString mHref;
+    qreal mX = 0;
+    qreal mY = 0;
+    qreal mWidth = 0;
+    qreal mHeight = 0;
+    const SvgElement* mTarget = nullptr;
+    std::shared_ptr<TargetBounds> mTargetBounds;
+};
+
+#endif // SVGUSE_H
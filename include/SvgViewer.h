@@ -2,30 +2,110 @@
 #define SVGVIEWER_H
 
 #include <QWidget>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <memory>
 #include "SvgDocument.h"
 #include "SvgRenderer.h"
+#include "SvgTileCache.h"
+#include "SvgFrameRenderer.h"
+#include "SvgSourceDiff.h"
 
-class SvgViewer : public QWidget
+class QFileSystemWatcher;
+
+class SvgViewer : public QWidget, public SvgDocumentListener
 {
     Q_OBJECT
 
 public:
     explicit SvgViewer(const QString& svgFilePath, QWidget *parent = nullptr);
-    ~SvgViewer() override = default;
+    ~SvgViewer() override;
 
     bool loadSvgFile(const QString& filePath);
+    // 当前文档（通过其编辑接口修改时视图只重绘受影响的分块）
+    SvgDocument* document() const { return mSvgDocument.get(); }
+
+    // 渐进加载时每个时间片的解析预算（毫秒），超出后让出事件循环以便重绘
+    static void setLoadSliceBudget(int ms) { sLoadSliceBudget = ms; }
+
+    // 监视模式：文件保存后只重建变化的子树并重绘其区域（签名不对齐时退回整体重新加载）
+    void setWatchEnabled(bool enabled);
 
 protected:
     // 重写绘制事件
     void paintEvent(QPaintEvent *event) override;
     // 重写窗口大小变化事件
     void resizeEvent(QResizeEvent *event) override;
+    // 滚轮缩放（以光标为中心）、左键拖动平移、双击恢复适配窗口
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+    // 文档编辑：修改前停止后台渲染，修改后只让受影响的分块过期
+    void documentAboutToChange(const SvgDocument* document) override;
+    void documentChanged(const SvgDocument* document, const SvgDocumentChange& change) override;
+
+private slots:
+    // 渐进加载：解析一个时间片，按节流间隔刷新画面
+    void continueLoading();
+    // 手势结束：切换到与当前缩放匹配的分块级别并请求清晰分块
+    void settleGesture();
+    // 后台帧完成：上屏，并恢复因渲染而暂停的渐进加载
+    void onFrameReady();
+    // 窗口尺寸停止变化：按最终尺寸做一次完整质量的渲染
+    void settleResize();
+    // 监视的文件已变化（合并连续的写入后调用）
+    void reloadChangedFile();
 
 private:
+    // 当前视图变换：文档坐标→窗口坐标
+    QTransform viewTransform() const;
+    // 加载期间请求一帧后台渲染（渲染期间暂停解析，文档保持不变）
+    void requestLoadingFrame();
+    // 恢复为整幅适配窗口
+    void fitToWindow();
+    // 文档加载完成：计算分块范围、适配窗口并重建分块缓存
+    void resetView();
+    // 质量策略：静止时完整质量；交互或加载期间完整质量的耗时超出预算则改用草稿
+    SvgRenderer::Quality chooseQuality(qreal fullRenderMs, qreal budgetMs) const;
+    // 与当前缩放匹配的分块级别（分块分辨率不低于屏幕分辨率）
+    int desiredTileLevel() const;
+    // 手势进行中：先缩放已有分块，停顿后再异步重绘
+    void beginGesture();
+    // 绘制可见区域的分块（缺失的分块用更粗级别的分块放大代替）
+    void paintTiles(QPainter& painter);
+    bool drawCoarserTile(QPainter& painter, const SvgTileKey& key, const QRectF& target);
+    // 加载完成后记录源签名并开始监视当前文件
+    void startWatching();
+
     std::unique_ptr<SvgDocument> mSvgDocument;  // SVG文档
-    SvgRenderer mRenderer;                      // SVG渲染器
     QString mCurrentFilePath;                   // 当前加载的SVG文件路径
+    QString mLoadingFilePath;                   // 正在渐进加载的文件路径
+    QTimer* mLoadTimer;                         // 驱动渐进加载的零间隔定时器
+    QElapsedTimer mSinceRepaint;                // 距上次加载期间重绘的时间
+
+    SvgFrameRenderer mFrameRenderer;            // 后台整帧渲染（双缓冲）
+    SvgTileCache mTileCache;                    // 多分辨率分块缓存
+    QRectF mContentRect;                        // 需要分块的文档范围（viewBox与内容边界的并集）
+    qreal mViewScale = 1.0;                     // 像素/文档单位
+    QPointF mViewOffset;                        // 文档原点在窗口中的位置
+    bool mFitMode = true;                       // 未缩放/平移时随窗口大小重新适配
+    int mTileLevel = 0;                         // 当前绘制使用的分块级别
+    bool mGestureActive = false;
+    QTimer* mSettleTimer;                       // 手势停顿判定
+    bool mResizing = false;                     // 拖动窗口边缘期间只缩放已有画面
+    QTimer* mResizeTimer;                       // 尺寸变化停顿判定（合并连续的resize事件）
+    bool mDragging = false;
+    QPointF mLastDragPos;
+
+    bool mWatchEnabled = false;
+    QFileSystemWatcher* mWatcher = nullptr;
+    QTimer* mReloadTimer;                       // 合并编辑器保存时的多次写入
+    std::unique_ptr<SvgSubtreeSignature> mSourceSignature;   // 当前文档对应的源签名
+
+    static int sLoadSliceBudget;
 };
 
 #endif // SVGVIEWER_H
@@ -0,0 +1,119 @@
+#include "SvgBandExporter.h"
+#include "SvgDocument.h"
+#include "SvgDisplayList.h"
+#include "SvgRenderScheduler.h"
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QDebug>
+#include <deque>
+#include <future>
+#include <memory>
+
+int SvgBandExporter::bandHeightFor(int width) const
+{
+    if (mBandHeight > 0) return mBandHeight;
+    const qint64 rowBytes = qint64(width) * 4;
+    return int(qBound<qint64>(1, kDefaultBandBytes / rowBytes, 4096));
+}
+
+bool SvgBandExporter::exportToFile(const SvgDocument* document, const QSize& size, const QString& fileName)
+{
+    // QSaveFile先写临时文件再原子替换，中途失败不会留下半幅图像
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        mError = "cannot open " + fileName + ": " + file.errorString();
+        return false;
+    }
+    if (!exportToDevice(document, size, &file, SvgRasterWriter::formatForFileName(fileName))) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        mError = "cannot write " + fileName + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SvgBandExporter::exportToDevice(const SvgDocument* document, const QSize& size, QIODevice* device,
+                                     SvgRasterWriter::Format format)
+{
+    mError.clear();
+    if (!document || size.isEmpty()) {
+        mError = "nothing to export";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const quint64 occludedBefore = SvgRenderScheduler::totalOccludedItems();
+
+    // 显示列表只与文档有关，所有条带共享（只读，可多线程同时查询）
+    SvgDisplayList displayList;
+    displayList.compile(document);
+    const QTransform fit = SvgRenderer::fitTransform(document->viewBox(), QRectF(QPointF(0, 0), size));
+
+    const int bandHeight = qMin(bandHeightFor(size.width()), size.height());
+    const int bandCount = (size.height() + bandHeight - 1) / bandHeight;
+    QAtomicInt abort;
+    auto renderBand = [&](int band) {
+        const int top = band * bandHeight;
+        const QSize bandSize(size.width(), qMin(bandHeight, size.height() - top));
+        // 条带即整幅图像向上平移top行后的视口
+        return SvgRenderScheduler::renderImage(&displayList, fit * QTransform::fromTranslate(0, -top),
+                                               bandSize, mQuality, &abort);
+    };
+
+    std::unique_ptr<SvgRasterWriter> writer = SvgRasterWriter::create(format, device);
+    if (!writer->begin(size.width(), size.height())) {
+        mError = writer->errorString();
+        return false;
+    }
+
+    // 并行时最多mParallelBands个条带在途；编码器按条带顺序取结果
+    QThreadPool pool;
+    pool.setMaxThreadCount(mParallelBands);
+    std::deque<std::future<QImage>> pending;
+    int scheduled = 0;
+
+    bool ok = true;
+    for (int band = 0; band < bandCount && ok; ++band) {
+        QImage image;
+        if (mParallelBands > 1) {
+            while (scheduled < bandCount && scheduled < band + mParallelBands) {
+                auto promise = std::make_shared<std::promise<QImage>>();
+                pending.push_back(promise->get_future());
+                const int index = scheduled++;
+                pool.start([promise, index, &renderBand]() { promise->set_value(renderBand(index)); });
+            }
+            image = pending.front().get();
+            pending.pop_front();
+        } else {
+            image = renderBand(band);
+        }
+
+        if (image.isNull()) {
+            mError = QString("cannot allocate band of %1x%2").arg(size.width()).arg(bandHeight);
+            ok = false;
+        } else if (!writer->writeRows(image)) {
+            mError = writer->errorString();
+            ok = false;
+        }
+    }
+
+    // 失败时让仍在渲染的条带尽快退出
+    if (!ok) abort.storeRelaxed(1);
+    pool.waitForDone();
+    if (!ok) return false;
+
+    if (!writer->finish()) {
+        mError = writer->errorString();
+        return false;
+    }
+    qDebug() << "分带导出完成：" << size << "，条带：" << bandCount << "x" << bandHeight
+             << "行，并行：" << mParallelBands << "，遮挡剔除图元：" << SvgRenderScheduler::totalOccludedItems() - occludedBefore
+             << "，耗时(ms)：" << timer.elapsed();
+    return true;
+}
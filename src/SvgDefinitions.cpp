@@ -0,0 +1,10 @@
+#include "SvgDefinitions.h"
+
+SvgDefinitions::SvgDefinitions(const QString& id)
+    : SvgGroup(id)
+{}
+
+void SvgDefinitions::draw(SvgRenderer* renderer) const
+{
+    Q_UNUSED(renderer);   // 定义内容只经由<use>实例绘制
+}
@@ -0,0 +1,240 @@
+#include "SvgDisplayList.h"
+#include "SvgDocument.h"
+#include "SvgElement.h"
+#include "SvgGroup.h"
+#include "SvgSceneStore.h"
+#include <QStack>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// 网格每边的单元数上限
+const int kMaxGridSide = 256;
+// 平均每个网格单元期望容纳的图元数
+const int kItemsPerCell = 4;
+}
+
+void SvgDisplayList::clear()
+{
+    mItems.clear();
+    mGroups.clear();
+    mStyles.clear();
+    mUnbounded.clear();
+    mGrid.clear();
+    mGridColumns = 0;
+    mGridRows = 0;
+    mBounds = QRectF();
+    mIndexOf.clear();
+}
+
+void SvgDisplayList::compile(const SvgDocument* document)
+{
+    clear();
+    if (!document) return;
+
+    // 加载期间文档还没有场景存储（渐进绘制已解析的部分），临时建立一份
+    SvgSceneStore local;
+    const SvgSceneStore* store = document->sceneStore();
+    if (!store) {
+        local.build(document->elements());
+        store = &local;
+    }
+
+    // 序号即文档前序，可见叶子按序号顺序就是绘制顺序；
+    // itemsBefore记录每个序号之前的图元数，组的子树区间[i, subtreeEnd)据此换算成图元区间
+    const int count = store->size();
+    QVector<int> itemsBefore(count + 1);
+    mItems.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        itemsBefore[i] = mItems.size();
+        const quint8 flags = store->flags(i);
+        if (!(flags & SvgSceneStore::FlagLeaf) || !(flags & SvgSceneStore::FlagRendered)) continue;
+
+        SvgDisplayItem item;
+        item.element = store->element(i);
+        item.transform = store->worldTransform(i);
+        item.style = store->styleHandle(i);
+        if (flags & SvgSceneStore::FlagUnbounded) {
+            mUnbounded.append(mItems.size());
+        } else {
+            item.bounds = store->bounds(i);
+        }
+        mItems.append(item);
+    }
+    itemsBefore[count] = mItems.size();
+    mBounds = store->unitedBounds();
+    mStyles = store->styles();
+
+    // 组按序号顺序登记，天然是起点升序、同起点时外层在前
+    for (int i = 0; i < count; ++i) {
+        if (store->type(i) != SvgElement::TypeGroup || !(store->flags(i) & SvgSceneStore::FlagRendered)) continue;
+        auto* group = static_cast<const SvgGroup*>(store->element(i));
+        const int first = itemsBefore.at(i);
+        const int end = itemsBefore.at(store->subtreeEnd(i));
+        const int items = end - first;
+        if (items >= kMinGroupItems || (items > 0 && group->layerHint() != SvgGroup::LayerAuto)) {
+            mGroups.append({group, first, end});
+        }
+    }
+
+    buildGrid();
+    qDebug() << "显示列表编译完成，图元数量：" << mItems.size() << "，组区间：" << mGroups.size()
+             << "，网格：" << mGridColumns << "x" << mGridRows;
+}
+
+void SvgDisplayList::buildGrid()
+{
+    const int bounded = mItems.size() - mUnbounded.size();
+    if (bounded <= 0 || mBounds.isEmpty()) return;
+
+    const int side = qBound(1, int(qSqrt(qreal(bounded) / kItemsPerCell)), kMaxGridSide);
+    mGridColumns = side;
+    mGridRows = side;
+    mGrid.resize(mGridColumns * mGridRows);
+
+    // 按下标顺序插入，每个单元内的列表天然有序
+    int next = 0;
+    for (int i = 0; i < mItems.size(); ++i) {
+        if (next < mUnbounded.size() && mUnbounded.at(next) == i) {
+            ++next;
+            continue;
+        }
+        const QRect range = gridRange(mItems.at(i).bounds);
+        for (int y = range.top(); y <= range.bottom(); ++y) {
+            for (int x = range.left(); x <= range.right(); ++x) {
+                mGrid[y * mGridColumns + x].append(i);
+            }
+        }
+    }
+}
+
+void SvgDisplayList::gridInsert(int index)
+{
+    const QRect range = gridRange(mItems.at(index).bounds);
+    for (int y = range.top(); y <= range.bottom(); ++y) {
+        for (int x = range.left(); x <= range.right(); ++x) {
+            QVector<int>& cell = mGrid[y * mGridColumns + x];
+            cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+        }
+    }
+}
+
+void SvgDisplayList::gridRemove(int index)
+{
+    const QRect range = gridRange(mItems.at(index).bounds);
+    for (int y = range.top(); y <= range.bottom(); ++y) {
+        for (int x = range.left(); x <= range.right(); ++x) {
+            QVector<int>& cell = mGrid[y * mGridColumns + x];
+            const auto it = std::lower_bound(cell.begin(), cell.end(), index);
+            if (it != cell.end() && *it == index) cell.erase(it);
+        }
+    }
+}
+
+void SvgDisplayList::updateElement(const SvgDocument* document, const SvgElement* element)
+{
+    if (!element || mItems.isEmpty()) return;
+    // 场景存储先于显示列表更新，修改后的样式已在其样式表中
+    const SvgSceneStore* store = document ? document->sceneStore() : nullptr;
+    if (store) mStyles = store->styles();
+    if (mIndexOf.isEmpty()) {
+        mIndexOf.reserve(mItems.size());
+        for (int i = 0; i < mItems.size(); ++i) {
+            mIndexOf.insert(mItems.at(i).element, i);
+        }
+    }
+
+    struct Frame {
+        const SvgElement* element;
+        QTransform parent;
+    };
+    QStack<Frame> stack;
+    stack.push({element, element->parent() ? element->parent()->worldTransform() : QTransform()});
+
+    bool outside = false;   // 有图元移出了网格覆盖范围
+    int updated = 0;
+    while (!stack.isEmpty()) {
+        const Frame frame = stack.pop();
+        const QTransform total = frame.element->transform().toQTransform() * frame.parent;
+        if (frame.element->type() == SvgElement::TypeGroup) {
+            auto* group = static_cast<const SvgGroup*>(frame.element);
+            if (!group->isRendered()) continue;
+            for (const SvgElement* child : group->children()) {
+                if (child) stack.push({child, total});
+            }
+            continue;
+        }
+
+        const int index = mIndexOf.value(frame.element, -1);
+        if (index < 0) continue;
+        SvgDisplayItem& item = mItems[index];
+        item.transform = total;
+        if (store) {
+            const int ordinal = store->ordinalOf(frame.element);
+            if (ordinal >= 0) item.style = store->styleHandle(ordinal);
+        }
+        ++updated;
+        if (frame.element->type() == SvgElement::TypeText) continue;   // 不在网格中
+
+        if (mGridColumns > 0) gridRemove(index);
+        item.bounds = SvgSceneStore::leafBounds(frame.element, total);
+        if (mGridColumns > 0 && mBounds.contains(item.bounds)) {
+            gridInsert(index);
+        } else {
+            outside = true;
+        }
+    }
+
+    if (outside) {
+        // 网格单元尺寸由整体范围决定，范围扩大后整体重建
+        mBounds = QRectF();
+        int next = 0;
+        for (int i = 0; i < mItems.size(); ++i) {
+            if (next < mUnbounded.size() && mUnbounded.at(next) == i) {
+                ++next;
+                continue;
+            }
+            const QRectF& bounds = mItems.at(i).bounds;
+            mBounds = mBounds.isEmpty() ? bounds : mBounds.united(bounds);
+        }
+        mGrid.clear();
+        mGridColumns = 0;
+        mGridRows = 0;
+        buildGrid();
+    }
+    qDebug() << "显示列表增量更新，图元数量：" << updated << "，重建网格：" << outside;
+}
+
+QRect SvgDisplayList::gridRange(const QRectF& rect) const
+{
+    const qreal cellWidth = mBounds.width() / mGridColumns;
+    const qreal cellHeight = mBounds.height() / mGridRows;
+    const int x0 = qBound(0, int(qFloor((rect.left() - mBounds.left()) / cellWidth)), mGridColumns - 1);
+    const int x1 = qBound(0, int(qFloor((rect.right() - mBounds.left()) / cellWidth)), mGridColumns - 1);
+    const int y0 = qBound(0, int(qFloor((rect.top() - mBounds.top()) / cellHeight)), mGridRows - 1);
+    const int y1 = qBound(0, int(qFloor((rect.bottom() - mBounds.top()) / cellHeight)), mGridRows - 1);
+    return QRect(QPoint(x0, y0), QPoint(x1, y1));
+}
+
+QVector<int> SvgDisplayList::query(const QRectF& rect) const
+{
+    QVector<int> result = mUnbounded;
+    if (mGridColumns > 0 && rect.intersects(mBounds)) {
+        const QRect range = gridRange(rect);
+        for (int y = range.top(); y <= range.bottom(); ++y) {
+            for (int x = range.left(); x <= range.right(); ++x) {
+                for (int index : mGrid.at(y * mGridColumns + x)) {
+                    if (mItems.at(index).bounds.intersects(rect)) {
+                        result.append(index);
+                    }
+                }
+            }
+        }
+    }
+
+    // 跨多个网格单元的图元会重复出现；排序去重后即为绘制顺序
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
@@ -5,10 +5,47 @@
 #include "SvgRect.h"
 #include "SvgStyle.h"
 #include "SvgGroup.h"
-#include <QDomDocument>
+#include "SvgPath.h"
+#include "SvgDocumentCache.h"
+#include "SvgStreamLoader.h"
+#include "SvgGzipDevice.h"
+#include "SvgTreeOptimizer.h"
+#include "SvgGeometryPool.h"
+#include "SvgUse.h"
+#include "SvgTreeWalker.h"
+#include "SvgSceneStore.h"
+#include <QBuffer>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QXmlStreamReader>
-#include <QRegularExpression>
+#include <QSet>
+#include <QStack>
+#include <limits>
+#include <memory>
+
+QString SvgDocument::sCacheDirectory;
+bool SvgDocument::sOptimizeOnLoad = false;
+
+// 进行中的加载：持有源数据（文件映射或内存副本）以及解析器的全部中间状态
+struct SvgDocument::PendingLoad
+{
+    explicit PendingLoad(SvgDocument* document) : loader(document) {}
+    ~PendingLoad()
+    {
+        buffer.close();
+        if (mapped) file.unmap(mapped);
+    }
+
+    QString filePath;
+    QFile file;
+    uchar* mapped = nullptr;
+    QByteArray sourceData;
+    QByteArray sourceHash;
+    QBuffer buffer;
+    std::unique_ptr<SvgGzipDevice> gzipDevice;
+    QXmlStreamReader reader;
+    SvgStreamLoader loader;
+};
 
 SvgDocument::SvgDocument()
 {
@@ -16,6 +53,7 @@ SvgDocument::SvgDocument()
 
 SvgDocument::~SvgDocument()
 {
+    mPending.reset();
     foreach (SvgElement* element, mElements) {
         delete element;
     }
@@ -23,145 +61,568 @@ SvgDocument::~SvgDocument()
 }
 
 bool SvgDocument::load(const QString& filePath) {
-    // 清空原有数据（递归删除所有元素）
-    qDeleteAll(mElements);
-    mElements.clear();
-    mIsValid = false;
-    mViewBox = QRectF();
+    if (!beginLoad(filePath)) {
+        return false;
+    }
+    // 一次性解析剩余全部内容
+    while (continueLoad(std::numeric_limits<int>::max())) {
+    }
+    return mIsValid;
+}
 
-    // 加载并解析XML文件
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+bool SvgDocument::beginLoad(const QString& filePath)
+{
+    // 清空原有数据（递归删除所有元素，并放弃未完成的加载）
+    clear();
+
+    auto pending = std::make_unique<PendingLoad>(this);
+    pending->filePath = filePath;
+
+    // 打开文件并整体映射到内存：后续解析直接从映射区按块读取，不再整文件读入
+    pending->file.setFileName(filePath);
+    if (!pending->file.open(QIODevice::ReadOnly)) {
         qDebug() << "无法打开文件：" << filePath;
         return false;
     }
 
-    QDomDocument domDoc;
-    if (!domDoc.setContent(&file)) {
-        file.close();
-        qDebug() << "XML解析失败：" << filePath;
-        return false;
+    const qint64 fileSize = pending->file.size();
+    pending->mapped = fileSize > 0 ? pending->file.map(0, fileSize) : nullptr;
+    if (pending->mapped) {
+        pending->sourceData = QByteArray::fromRawData(reinterpret_cast<const char*>(pending->mapped), fileSize);
+    } else {
+        // 映射失败（如特殊文件系统）时退回到普通读取
+        qDebug() << "文件映射失败，改为整体读取：" << filePath;
+        pending->sourceData = pending->file.readAll();
     }
-    file.close();
 
-    // 解析根元素（必须是svg标签）
-    QDomElement rootElem = domDoc.documentElement();
-    if (rootElem.tagName().toLower() != "svg") {
-        qDebug() << "根元素不是svg标签";
+    // 启用缓存时，先按源内容哈希查找预编译的二进制缓存
+    if (!sCacheDirectory.isEmpty()) {
+        pending->sourceHash = SvgDocumentCache::contentHash(pending->sourceData);
+        mGeometryPool = std::make_unique<SvgGeometryPool>();
+        if (SvgDocumentCache(sCacheDirectory).restore(pending->sourceHash, this)) {
+            mIsValid = !mElements.isEmpty() && mViewBox.width() > 0 && mViewBox.height() > 0;
+            if (mIsValid) {
+                releaseGeometryPool();
+                resolveReferences();
+                optimizeLoadedTree();
+                buildSceneStore();
+                return true;  // 缓存命中，无需渐进解析
+            }
+            // 缓存内容不可用，清空后走完整解析
+            clear();
+        }
+    }
+
+    // QBuffer包装映射区（不拷贝），QXmlStreamReader经设备接口每次读取8K字节并解码（gzip输入同样适用）。
+    // 不直接把映射区交给QXmlStreamReader：以QByteArray构造时它会一次把整个文件解码成UTF-16，
+    // 大文件的峰值内存会翻倍以上；QBuffer本身只是读指针，没有额外复制
+    pending->buffer.setData(pending->sourceData);
+    pending->buffer.open(QIODevice::ReadOnly);
+    mPending = std::move(pending);
+    mGeometryPool = std::make_unique<SvgGeometryPool>();
+    return beginLoadFromDevice(&mPending->buffer);
+}
+
+bool SvgDocument::loadFromData(const QByteArray& data)
+{
+    // 清空现有元素
+    clear();
+
+    mPending = std::make_unique<PendingLoad>(this);
+    mGeometryPool = std::make_unique<SvgGeometryPool>();
+    mPending->buffer.setData(data);
+    mPending->buffer.open(QIODevice::ReadOnly);
+    if (!beginLoadFromDevice(&mPending->buffer)) {
         return false;
     }
+    while (continueLoad(std::numeric_limits<int>::max())) {
+    }
+    return mIsValid;
+}
+
+bool SvgDocument::beginLoadFromDevice(QIODevice* device)
+{
+    // gzip压缩输入（.svgz）：套一层解压设备，解析器按块拉取解压数据
+    if (SvgGzipDevice::isGzipData(device->peek(2))) {
+        mPending->gzipDevice = std::make_unique<SvgGzipDevice>(device);
+        if (!mPending->gzipDevice->open(QIODevice::ReadOnly)) {
+            qDebug() << "gzip解压初始化失败：" << mPending->gzipDevice->errorString();
+            mPending.reset();
+            return false;
+        }
+        device = mPending->gzipDevice.get();
+        qDebug() << "检测到gzip压缩输入，启用流式解压";
+    }
+
+    // 流式解析：边读取标签边构建元素（工厂同时解析根元素的viewBox）
+    mPending->reader.setDevice(device);
+    return true;
+}
+
+bool SvgDocument::continueLoad(int maxElements)
+{
+    if (!mPending) return false;
 
-    // 1. 解析viewBox属性（优先使用SVG中定义的）
-    QString viewBoxStr = rootElem.attribute("viewBox");
-    if (!viewBoxStr.isEmpty()) {
-        QStringList parts = viewBoxStr.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (parts.size() == 4) {
-            bool xOk, yOk, wOk, hOk;
-            qreal x = parts[0].toDouble(&xOk);
-            qreal y = parts[1].toDouble(&yOk);
-            qreal w = parts[2].toDouble(&wOk);
-            qreal h = parts[3].toDouble(&hOk);
-            if (xOk && yOk && wOk && hOk && w > 0 && h > 0) {
-                mViewBox = QRectF(x, y, w, h);
-                qDebug() << "从SVG解析到viewBox：" << mViewBox;
-            } else {
-                qDebug() << "viewBox数值无效，将计算默认值";
+    const bool more = mPending->loader.parseChunk(mPending->reader, maxElements);
+
+    // 根元素一经创建就存入文档（svg容器元素），后续块继续向其追加子元素，
+    // 因此两次continueLoad之间文档始终是一棵完整可绘制的树
+    if (mElements.isEmpty() && mPending->loader.root()) {
+        mElements.append(mPending->loader.takeRoot());
+    }
+
+    if (more) {
+        // 未声明viewBox时按已解析内容估算临时范围，随内容流入而扩大（加载器逐个累计新元素的范围），
+        // 结束时再正式计算。临时范围与声明的viewBox分开保存：百分比坐标不按它换算
+        if (mViewBox.width() <= 0 || mViewBox.height() <= 0) {
+            const QRectF bounds = mPending->loader.loadedBounds();
+            if (bounds.width() > 0 && bounds.height() > 0) {
+                mProvisionalViewBox = bounds;
             }
-        } else {
-            qDebug() << "viewBox格式错误（需4个数值），将计算默认值";
         }
-    } else {
-        qDebug() << "SVG无viewBox属性，将计算默认值";
+        return true;
     }
 
-    // 2. 通过工厂类创建根元素及其所有子元素（递归解析）
-    SvgElement* root = SvgElementFactory::createElement(rootElem, this); // 传入document指针
-    if (root) {
-        mElements.append(root); // 根元素存入文档（可能是svg或g等容器元素）
-    } else {
-        qDebug() << "根元素创建失败";
+    finishLoad(!mPending->loader.hasError());
+    return false;
+}
+
+bool SvgDocument::finishLoad(bool parsed)
+{
+    // 取出加载状态，函数返回时释放（关闭设备并解除文件映射）
+    const std::unique_ptr<PendingLoad> pending = std::move(mPending);
+
+    if (!parsed) {
+        qDebug() << "根元素创建失败：" << pending->loader.errorString();
+        if (!pending->filePath.isEmpty()) {
+            qDebug() << "SVG加载失败：" << pending->filePath;
+        }
+        clear();
         return false;
     }
 
-    // 3. 若viewBox无效，计算默认值（包含所有元素的最小边界框）
+    releaseGeometryPool();
+    // <use>可以引用后出现的元素，整棵树就绪后统一解析（默认viewBox的计算也需要实例范围）
+    resolveReferences();
+
+    // 1. 若viewBox无效，计算默认值（包含所有元素的最小边界框），加载期间的临时估算不再需要
+    mProvisionalViewBox = QRectF();
     if (mViewBox.width() <= 0 || mViewBox.height() <= 0) {
+        qDebug() << "SVG无有效viewBox，将计算默认值";
         calculateDefaultViewBox();
     }
 
-    // 4. 验证文档有效性（有元素且viewBox有效）
+    // 2. 验证文档有效性（有元素且viewBox有效）
     mIsValid = !mElements.isEmpty() && mViewBox.width() > 0 && mViewBox.height() > 0;
     qDebug() << "SVG加载完成，是否有效：" << mIsValid
              << "，元素数量：" << totalElementCount() // 新增：统计所有元素（含子元素）
              << "，最终viewBox：" << mViewBox;
 
+    // 3. 解析成功后写入（或重建过期的）缓存
+    if (mIsValid && !pending->sourceHash.isEmpty()) {
+        SvgDocumentCache(sCacheDirectory).store(pending->sourceHash, this);
+    }
+
+    // 4. 可选的树优化（在写入缓存之后：缓存保存未优化的树，关闭优化时仍可直接使用）
+    if (mIsValid) {
+        optimizeLoadedTree();
+        buildSceneStore();
+    }
+
     return mIsValid;
 }
 
-bool SvgDocument::loadFromData(const QByteArray& data)
+void SvgDocument::clear()
 {
-    // 清空现有元素
-    foreach (SvgElement* element, mElements) {
+    mPending.reset();
+    qDeleteAll(mElements);
+    mElements.clear();
+    mIsValid = false;
+    mViewBox = QRectF();
+    mProvisionalViewBox = QRectF();
+    mOptimized = false;
+    mGeometryPool.reset();
+    mIdIndex.clear();
+    mInstances.clear();
+    mSceneStore.reset();
+}
+
+void SvgDocument::releaseGeometryPool()
+{
+    if (!mGeometryPool) return;
+    // 元素已持有共享几何的引用，池本身不再需要
+    const SvgGeometryPool::Statistics statistics = mGeometryPool->statistics();
+    qDebug() << "几何去重：复用" << statistics.hits << "次，解析" << statistics.misses << "份";
+    mGeometryPool.reset();
+}
+
+void SvgDocument::optimizeLoadedTree()
+{
+    if (!sOptimizeOnLoad || mOptimized) return;
+    SvgTreeOptimizer::optimize(this);
+    mOptimized = true;
+    // 优化会改写目标子树中的变换，计算默认viewBox时建立的实例范围缓存不再可靠
+    const QList<const SvgUse*> instances = mInstances.values();
+    invalidateInstanceBounds(QVector<const SvgUse*>(instances.cbegin(), instances.cend()));
+}
+
+void SvgDocument::buildSceneStore()
+{
+    QElapsedTimer timer;
+    timer.start();
+    if (!mSceneStore) mSceneStore = std::make_unique<SvgSceneStore>();
+    mSceneStore->build(mElements);
+    qDebug() << "场景存储已建立，元素数量：" << mSceneStore->size() << "，耗时(ms)：" << timer.elapsed();
+}
+
+void SvgDocument::addElement(SvgElement* element)
+{
+    if (element) {
+        mElements.append(element);
+        if (mSceneStore) buildSceneStore();
+    }
+}
+
+void SvgDocument::removeElement(SvgElement* element)
+{
+    if (element) {
+        mElements.removeAll(element);
         delete element;
+        if (mSceneStore) buildSceneStore();
     }
-    mElements.clear();
+}
 
-    QDomDocument domDoc;
-    QString errorMsg;
-    int errorLine, errorColumn;
+void SvgDocument::addListener(SvgDocumentListener* listener)
+{
+    if (listener && !mListeners.contains(listener)) {
+        mListeners.append(listener);
+    }
+}
 
-    if (!domDoc.setContent(data, &errorMsg, &errorLine, &errorColumn)) {
-        return false;
+void SvgDocument::removeListener(SvgDocumentListener* listener)
+{
+    mListeners.removeAll(listener);
+}
+
+namespace {
+
+// 子树在文档坐标下的外观范围：沿路径累积变换，叶子按显示列表相同的规则放宽
+// （描边按SvgSceneStore::strokeMargin外扩；文本包围盒按默认字体估算，按字号放宽）
+class DocumentBoundsVisitor : public SvgTreeVisitor
+{
+public:
+    DocumentBoundsVisitor(const SvgElement* root, const QTransform& parentWorld) : mRoot(root)
+    {
+        mWorlds.push(parentWorld);
     }
 
-    QDomElement root = domDoc.documentElement();
-    if (root.tagName() != "svg") {
-        return false;
+    bool enter(const SvgElement* element) override
+    {
+        const QTransform total = element->transform().toQTransform() * mWorlds.top();
+        if (element->type() == SvgElement::TypeGroup) {
+            // 定义容器不直接绘制，只有被修改的元素本身位于其中时才计入（其实例另行计算）
+            if (!static_cast<const SvgGroup*>(element)->isRendered() && element != mRoot) return false;
+        } else {
+            const qreal margin = element->type() == SvgElement::TypeText
+                                     ? qMax<qreal>(element->style().fontSize(), 16)
+                                     : SvgSceneStore::strokeMargin(element->style().strokeWidth());
+            const QRectF local = total.mapRect(element->boundingBox().adjusted(-margin, -margin, margin, margin));
+            mBounds = mBounds.isEmpty() ? local : mBounds.united(local);
+        }
+        mWorlds.push(total);
+        return true;
     }
 
-    // 解析 viewBox，使用QRegularExpression替代QRegExp
-    if (root.hasAttribute("viewBox")) {
-        QString viewBoxStr = root.attribute("viewBox");
-        // 使用QRegularExpression分割空白字符
-        QStringList parts = viewBoxStr.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (parts.size() == 4) {
-            bool ok;
-            qreal x = parts[0].toDouble(&ok); if (!ok) return false;
-            qreal y = parts[1].toDouble(&ok); if (!ok) return false;
-            qreal w = parts[2].toDouble(&ok); if (!ok) return false;
-            qreal h = parts[3].toDouble(&ok); if (!ok) return false;
-            mViewBox = QRectF(x, y, w, h);
+    void leave(const SvgElement* element) override
+    {
+        Q_UNUSED(element);
+        mWorlds.pop();
+    }
+
+    QRectF bounds() const { return mBounds; }
+
+private:
+    const SvgElement* mRoot;
+    QStack<QTransform> mWorlds;
+    QRectF mBounds;
+};
+
+} // namespace
+
+QRectF SvgDocument::documentBounds(const SvgElement* element) const
+{
+    if (!element) return QRectF();
+    DocumentBoundsVisitor visitor(element, element->parent() ? element->parent()->worldTransform() : QTransform());
+    SvgTreeWalker::walk(element, &visitor);
+    return visitor.bounds();
+}
+
+bool SvgDocument::beginChange(const SvgElement* element)
+{
+    // 加载期间元素树仍在增长，不接受编辑
+    if (!element || isLoading()) return false;
+    if (mEditBatch.depth > 0) {
+        if (mEditBatch.notified) return true;
+        mEditBatch.notified = true;
+    }
+    for (SvgDocumentListener* listener : mListeners) {
+        listener->documentAboutToChange(this);
+    }
+    return true;
+}
+
+void SvgDocument::commitChange(SvgDocumentChange::Kind kind, const SvgElement* element, const QRectF& dirtyRect,
+                               const QVector<const SvgUse*>& instances)
+{
+    if (mEditBatch.depth > 0) {
+        mEditBatch.dirty = mEditBatch.dirty.united(dirtyRect);
+        return;
+    }
+
+    SvgDocumentChange change;
+    change.kind = kind;
+    change.element = element;
+    change.dirtyRect = dirtyRect;
+    change.revision = ++mRevision;
+    change.instances.reserve(instances.size());
+    for (const SvgUse* use : instances) change.instances.append(use);
+
+    // 场景存储先于监听者更新（显示列表按它重新编译）：结构变化时重建，否则只重算受影响的子树
+    if (mSceneStore) {
+        bool updated = kind == SvgDocumentChange::ElementChanged && mSceneStore->updateElement(element);
+        for (int i = 0; updated && i < change.instances.size(); ++i) {
+            updated = mSceneStore->updateElement(change.instances.at(i));
         }
+        if (!updated) buildSceneStore();
     }
+    for (SvgDocumentListener* listener : mListeners) {
+        listener->documentChanged(this, change);
+    }
+}
 
-    // 解析子元素
-    QDomNode node = root.firstChild();
-    while (!node.isNull()) {
-        if (node.isElement()) {
-            QDomElement elem = node.toElement();
-            SvgElement* svgElement = createElementFromDom(elem);
-            if (svgElement) {
-                mElements.append(svgElement);
+void SvgDocument::beginEditBatch()
+{
+    ++mEditBatch.depth;
+}
+
+void SvgDocument::endEditBatch()
+{
+    if (mEditBatch.depth <= 0 || --mEditBatch.depth > 0) return;
+    const EditBatch batch = mEditBatch;
+    mEditBatch = EditBatch();
+    if (batch.notified) commitChange(SvgDocumentChange::StructureChanged, nullptr, batch.dirty);
+}
+
+namespace {
+
+// 子树中是否有可被引用的元素（带id）或<use>实例：插入/删除这样的子树需要重新解析引用
+bool hasReferences(const SvgElement* element)
+{
+    bool found = false;
+    SvgTreeWalker::preOrder(element, [&found](const SvgElement* current) {
+        if (!current->id().isEmpty() || current->type() == SvgElement::TypeUse) found = true;
+        return !found;   // 找到后不再展开其余子树
+    });
+    return found;
+}
+
+bool isReferenceAttribute(const QString& name)
+{
+    return name == "id" || name == "href" || name == "xlink:href";
+}
+
+std::shared_ptr<SvgUse::TargetBounds> sharedTargetBounds(
+    QHash<const SvgElement*, std::shared_ptr<SvgUse::TargetBounds>>& shared, const SvgElement* target)
+{
+    std::shared_ptr<SvgUse::TargetBounds>& bounds = shared[target];
+    if (!bounds) bounds = std::make_shared<SvgUse::TargetBounds>();
+    return bounds;
+}
+
+} // namespace
+
+void SvgDocument::resolveReferences()
+{
+    mIdIndex.clear();
+    mInstances.clear();
+
+    // 前序（文档顺序）遍历，重复的id保留文档顺序中的第一个。元素归文档所有，可以去掉const
+    QVector<SvgUse*> uses;
+    SvgTreeWalker::preOrder(mElements, [this, &uses](const SvgElement* visited) {
+        SvgElement* element = const_cast<SvgElement*>(visited);
+        if (!element->id().isEmpty() && !mIdIndex.contains(element->id())) {
+            mIdIndex.insert(element->id(), element);
+        }
+        if (element->type() == SvgElement::TypeUse) {
+            uses.append(static_cast<SvgUse*>(element));
+        }
+        return true;
+    });
+
+    int unresolved = 0;
+    // 引用同一目标的实例共享一份目标范围缓存
+    QHash<const SvgElement*, std::shared_ptr<SvgUse::TargetBounds>> targetBounds;
+    for (SvgUse* use : uses) {
+        const SvgElement* target = mIdIndex.value(use->href());
+        // 引用自身所在的子树会无限展开，视为无效引用
+        for (const SvgElement* ancestor = use; ancestor && target; ancestor = ancestor->parent()) {
+            if (ancestor == target) target = nullptr;
+        }
+        use->setTarget(target, target ? sharedTargetBounds(targetBounds, target) : nullptr);
+        if (target) {
+            mInstances.insert(target, use);
+        } else {
+            ++unresolved;
+        }
+    }
+    if (!uses.isEmpty()) {
+        qDebug() << "解析<use>引用：实例" << uses.size() << "，id" << mIdIndex.size() << "，未解析" << unresolved;
+    }
+}
+
+QVector<const SvgUse*> SvgDocument::dependentInstances(const SvgElement* element) const
+{
+    QVector<const SvgUse*> result;
+    if (!element || mInstances.isEmpty()) return result;
+
+    QSet<const SvgUse*> seen;
+    QVector<const SvgUse*> pending;
+    auto collect = [this, &seen, &pending](const SvgElement* target) {
+        for (auto it = mInstances.constFind(target); it != mInstances.cend() && it.key() == target; ++it) {
+            if (!seen.contains(it.value())) {
+                seen.insert(it.value());
+                pending.append(it.value());
+            }
+        }
+    };
+
+    // 1. 目标位于element子树内（含element自身）
+    const QList<const SvgElement*> targets = mInstances.uniqueKeys();
+    for (const SvgElement* target : targets) {
+        for (const SvgElement* ancestor = target; ancestor; ancestor = ancestor->parent()) {
+            if (ancestor == element) {
+                collect(target);
+                break;
             }
         }
-        node = node.nextSibling();
     }
+    // 2. 目标是element的祖先；3. 受影响的实例又位于被引用的内容中时逐层传播
+    for (const SvgElement* ancestor = element->parent(); ancestor; ancestor = ancestor->parent()) {
+        collect(ancestor);
+    }
+    while (!pending.isEmpty()) {
+        const SvgUse* use = pending.takeLast();
+        result.append(use);
+        for (const SvgElement* ancestor = use->parent(); ancestor; ancestor = ancestor->parent()) {
+            collect(ancestor);
+        }
+    }
+    return result;
+}
+
+void SvgDocument::invalidateInstanceBounds(const QVector<const SvgUse*>& instances) const
+{
+    for (const SvgUse* use : instances) use->invalidateTargetBounds();
+}
+
+QRectF SvgDocument::affectedBounds(const SvgElement* element, const QVector<const SvgUse*>& instances) const
+{
+    QRectF bounds = documentBounds(element);
+    for (const SvgUse* use : instances) {
+        bounds = bounds.united(documentBounds(use));
+    }
+    return bounds;
+}
 
+bool SvgDocument::setAttribute(SvgElement* element, const QString& name, const QString& value)
+{
+    // 先校验再通知：documentAboutToChange之后必须有对应的documentChanged，监听者才会恢复被取消的任务
+    if (!SvgElementFactory::supportsAttribute(element, name, value)) {
+        qDebug() << "不支持修改的属性：" << name;
+        return false;
+    }
+    if (!beginChange(element)) return false;
+    QVector<const SvgUse*> instances = dependentInstances(element);
+    const QRectF before = affectedBounds(element, instances);
+    SvgElementFactory::applyAttribute(element, name, value, this);
+    invalidateInstanceBounds(instances);
+    if (isReferenceAttribute(name)) {
+        // 引用关系变化：重新解析后，新旧引用者都受影响
+        resolveReferences();
+        const QVector<const SvgUse*> after = dependentInstances(element);
+        const QSet<const SvgUse*> known(instances.cbegin(), instances.cend());
+        for (const SvgUse* use : after) {
+            if (!known.contains(use)) instances.append(use);
+        }
+    }
+    commitChange(SvgDocumentChange::ElementChanged, element, before.united(affectedBounds(element, instances)),
+                 instances);
     return true;
 }
 
-void SvgDocument::addElement(SvgElement* element)
+bool SvgDocument::setStyleProperty(SvgElement* element, const QString& name, const QString& value)
 {
-    if (element) {
-        mElements.append(element);
+    if (!SvgStyle::isStyleProperty(name)) {
+        qDebug() << "不支持修改的样式属性：" << name;
+        return false;
     }
+    if (!beginChange(element)) return false;
+    const QVector<const SvgUse*> instances = dependentInstances(element);
+    const QRectF before = affectedBounds(element, instances);
+    SvgStyle style = element->style();
+    style.parseAttribute(name, value);
+    element->setStyle(style);
+    invalidateInstanceBounds(instances);
+    // 线宽变化会改变外观范围
+    commitChange(SvgDocumentChange::ElementChanged, element, before.united(affectedBounds(element, instances)),
+                 instances);
+    return true;
 }
 
-void SvgDocument::removeElement(SvgElement* element)
+bool SvgDocument::setElementTransform(SvgElement* element, const SvgTransform& transform)
 {
-    if (element) {
-        mElements.removeAll(element);
-        delete element;
+    if (!beginChange(element)) return false;
+    const QVector<const SvgUse*> instances = dependentInstances(element);
+    const QRectF before = affectedBounds(element, instances);
+    element->setTransform(transform);
+    invalidateInstanceBounds(instances);
+    commitChange(SvgDocumentChange::ElementChanged, element, before.united(affectedBounds(element, instances)),
+                 instances);
+    return true;
+}
+
+bool SvgDocument::insertChild(SvgGroup* parent, int index, SvgElement* child)
+{
+    if (!parent || !child || child->parent()) return false;
+    if (!beginChange(child)) return false;
+    parent->insertChild(index, child);
+    if (hasReferences(child)) resolveReferences();
+    // 插入到被引用的内容中时，引用它的实例一并改变（图元下标整体变化，监听者会重新编译）
+    const QVector<const SvgUse*> instances = dependentInstances(child);
+    invalidateInstanceBounds(instances);
+    commitChange(SvgDocumentChange::ChildInserted, child, affectedBounds(child, instances));
+    return true;
+}
+
+bool SvgDocument::removeChild(SvgElement* child)
+{
+    if (!child || (!child->parent() && !mElements.contains(child))) return false;
+    if (!beginChange(child)) return false;
+    const QVector<const SvgUse*> instances = dependentInstances(child);
+    const QRectF before = affectedBounds(child, instances);
+    const bool references = hasReferences(child);
+    if (SvgGroup* parent = child->parent()) {
+        parent->takeChild(child);
+    } else {
+        mElements.removeAll(child);
     }
+    // 子树内的实例此时仍然存在，释放前让缓存失效
+    invalidateInstanceBounds(instances);
+    // 先解除其他实例对被删除子树的引用，再释放
+    if (references) resolveReferences();
+    delete child;
+    commitChange(SvgDocumentChange::ChildRemoved, nullptr, before);
+    return true;
 }
 
 QList<SvgElement*> SvgDocument::elements() const {
@@ -179,6 +640,12 @@ void SvgDocument::setViewBox(const QRectF& viewBox)
     mViewBox = viewBox;
 }
 
+QRectF SvgDocument::displayViewBox() const
+{
+    if (isLoading() && (mViewBox.width() <= 0 || mViewBox.height() <= 0)) return mProvisionalViewBox;
+    return mViewBox;
+}
+
 QString SvgDocument::title() const
 {
     return mTitle;
@@ -202,38 +669,22 @@ void SvgDocument::setDescription(const QString& description)
 // 新增：辅助函数，统计所有元素（含嵌套子元素）的数量
 int SvgDocument::totalElementCount() const {
     int count = 0;
-    for (SvgElement* elem : mElements) {
-        count += countElementRecursive(elem);
-    }
+    SvgTreeWalker::preOrder(mElements, [&count](const SvgElement*) {
+        ++count;
+        return true;
+    });
     return count;
 }
 
-// 递归统计单个元素及其子元素数量
-int SvgDocument::countElementRecursive(SvgElement* elem) const {
-    if (!elem) return 0;
-    int count = 1; // 自身
-    // 若为容器元素（如g），递归统计子元素
-    if (elem->type() == SvgElement::TypeGroup) {
-        auto* group = static_cast<SvgGroup*>(elem);
-        for (SvgElement* child : group->children()) {
-            count += countElementRecursive(child);
-        }
-    }
-    return count;
-}
-
-// 辅助：递归扩展边界框以包含元素及其子元素
-void SvgDocument::expandBboxWithElement(SvgElement* elem, QRectF& bbox) const {
-    if (!elem) return;
-    // 合并当前元素的边界框
-    bbox = bbox.united(elem->boundingBox());
-    // 若为容器元素，递归处理子元素
-    if (elem->type() == SvgElement::TypeGroup) {
-        auto* group = static_cast<SvgGroup*>(elem);
-        for (SvgElement* child : group->children()) {
-            expandBboxWithElement(child, bbox);
-        }
-    }
+qint64 SvgDocument::releaseCachedGeometry() const
+{
+    // 释放所有路径缓存的绘制路径，以及懒加载路径已生成的几何
+    qint64 released = 0;
+    SvgTreeWalker::preOrder(mElements, [&released](const SvgElement* element) {
+        if (auto* path = dynamic_cast<const SvgPath*>(element)) released += path->releaseGeometry();
+        return true;
+    });
+    return released;
 }
 
 // 计算默认viewBox：包含所有元素的最小矩形
@@ -264,34 +715,3 @@ void SvgDocument::calculateDefaultViewBox() {
 
     qDebug() << "计算默认viewBox（含元素）：" << mViewBox;
 }
-
-bool SvgDocument::parseSvgElement(const QDomElement& domElement)
-{
-    // 调用工厂创建元素
-    SvgElement* element = SvgElementFactory::createElement(domElement, this);
-    if (element) {
-        mElements.append(element);
-        qDebug() << "添加元素：" << domElement.tagName()
-                 << "，当前元素总数：" << mElements.size();
-    }
-    else{
-        qDebug() << "未支持的元素：" << domElement.tagName();
-    }
-
-    QDomNode childNode = domElement.firstChild();
-    while (!childNode.isNull()) {
-        if (childNode.isElement()) {
-            QDomElement childElement = childNode.toElement();
-            parseSvgElement(childElement);  // 必须执行：确保子元素被解析
-        }
-        childNode = childNode.nextSibling();
-    }
-
-    return true;
-}
-
-SvgElement* SvgDocument::createElementFromDom(const QDomElement& domElement)
-{
-    // 委托给工厂类创建元素（核心修改）
-    return SvgElementFactory::createElement(domElement, this);
-}
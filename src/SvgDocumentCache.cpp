@@ -0,0 +1,460 @@
+#include "SvgDocumentCache.h"
+#include "SvgDocument.h"
+#include "SvgElement.h"
+#include "SvgStyle.h"
+#include "SvgRect.h"
+#include "SvgCircle.h"
+#include "SvgEllipse.h"
+#include "SvgLine.h"
+#include "SvgPolyline.h"
+#include "SvgPolygon.h"
+#include "SvgPath.h"
+#include "SvgText.h"
+#include "SvgGroup.h"
+#include "SvgDefinitions.h"
+#include "SvgSymbol.h"
+#include "SvgUse.h"
+#include "SvgTreeWalker.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QStack>
+#include <QSaveFile>
+#include <QPolygonF>
+#include <QTransform>
+#include <QDebug>
+
+namespace {
+
+const quint32 kCacheMagic = 0x53564743;   // "SVGC"
+const quint32 kCacheVersion = 4;          // 序列化格式变化时递增，旧缓存自动失效
+
+// 元素记录类型（与具体子类一一对应）
+enum RecordKind : quint8 {
+    RecordRect = 1,
+    RecordCircle,
+    RecordEllipse,
+    RecordLine,
+    RecordPolyline,
+    RecordPolygon,
+    RecordPath,
+    RecordText,
+    RecordGroup,
+    RecordDefinitions,
+    RecordSymbol,
+    RecordUse
+};
+
+} // namespace
+
+SvgDocumentCache::SvgDocumentCache(const QString& cacheDir)
+    : mCacheDir(cacheDir)
+{
+}
+
+QByteArray SvgDocumentCache::contentHash(const QByteArray& sourceData)
+{
+    return QCryptographicHash::hash(sourceData, QCryptographicHash::Sha1).toHex();
+}
+
+QString SvgDocumentCache::cacheFilePath(const QByteArray& hash) const
+{
+    return QDir(mCacheDir).filePath(QString::fromLatin1(hash) + ".svgc");
+}
+
+bool SvgDocumentCache::restore(const QByteArray& hash, SvgDocument* document) const
+{
+    if (!document || hash.isEmpty()) return false;
+
+    QFile file(cacheFilePath(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;  // 缓存未命中
+    }
+
+    // 直接映射缓存文件，QDataStream在映射内存上读取，避免整文件拷贝
+    const qint64 size = file.size();
+    uchar* mapped = file.map(0, size);
+    if (!mapped) {
+        qDebug() << "缓存文件映射失败：" << file.fileName();
+        return false;
+    }
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size);
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_6_2);
+
+    quint32 magic = 0, version = 0;
+    QByteArray storedHash;
+    in >> magic >> version >> storedHash;
+    if (in.status() != QDataStream::Ok || magic != kCacheMagic
+        || version != kCacheVersion || storedHash != hash) {
+        qDebug() << "缓存已过期或格式不符，将重新解析：" << file.fileName();
+        file.unmap(mapped);
+        return false;
+    }
+
+    QRectF viewBox;
+    QString title, description;
+    quint32 count = 0;
+    in >> viewBox >> title >> description >> count;
+
+    QList<SvgElement*> elements;
+    bool ok = in.status() == QDataStream::Ok;
+    for (quint32 i = 0; ok && i < count; ++i) {
+        SvgElement* element = readElement(in, document->geometryPool());
+        if (!element) {
+            ok = false;
+            break;
+        }
+        elements.append(element);
+    }
+    file.unmap(mapped);
+
+    if (!ok || in.status() != QDataStream::Ok) {
+        qDebug() << "缓存文件损坏，将重新解析：" << file.fileName();
+        qDeleteAll(elements);
+        return false;
+    }
+
+    document->setViewBox(viewBox);
+    document->setTitle(title);
+    document->setDescription(description);
+    for (SvgElement* element : elements) {
+        document->addElement(element);
+    }
+    qDebug() << "从缓存还原文档：" << file.fileName() << "，顶层元素数量：" << elements.size();
+    return true;
+}
+
+bool SvgDocumentCache::store(const QByteArray& hash, const SvgDocument* document) const
+{
+    if (!document || hash.isEmpty()) return false;
+
+    if (!QDir().mkpath(mCacheDir)) {
+        qDebug() << "无法创建缓存目录：" << mCacheDir;
+        return false;
+    }
+
+    // QSaveFile先写临时文件再原子替换，读取方不会看到写了一半的缓存
+    QSaveFile file(cacheFilePath(hash));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "无法写入缓存文件：" << file.fileName();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << kCacheMagic << kCacheVersion << hash;
+    out << document->viewBox() << document->title() << document->description();
+
+    const QList<SvgElement*> elements = document->elements();
+    out << quint32(elements.size());
+    for (const SvgElement* element : elements) {
+        writeElement(out, element);
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void SvgDocumentCache::writeStyle(QDataStream& out, const SvgStyle& style)
+{
+    out << style.fill() << style.stroke() << style.strokeWidth()
+        << style.fontFamily() << style.fontSize() << style.textAnchor();
+}
+
+void SvgDocumentCache::readStyle(QDataStream& in, SvgStyle& style)
+{
+    QColor fill, stroke;
+    qreal strokeWidth = 1.0, fontSize = 16.0;
+    QString fontFamily, textAnchor;
+    in >> fill >> stroke >> strokeWidth >> fontFamily >> fontSize >> textAnchor;
+
+    style.setFill(fill);
+    style.setStroke(stroke);
+    style.setStrokeWidth(strokeWidth);
+    style.setFontFamily(fontFamily);
+    style.setFontSize(fontSize);
+    style.setTextAnchor(textAnchor);
+}
+
+void SvgDocumentCache::writeElement(QDataStream& out, const SvgElement* element)
+{
+    // 前序写出：组记录之后紧跟其子元素的记录（显式栈遍历，深层嵌套不会栈溢出）
+    SvgTreeWalker::preOrder(element, [&out](const SvgElement* current) {
+        writeRecord(out, current);
+        return true;
+    });
+}
+
+void SvgDocumentCache::writeRecord(QDataStream& out, const SvgElement* element)
+{
+    // 1. 记录类型
+    RecordKind kind;
+    if (dynamic_cast<const SvgRect*>(element)) kind = RecordRect;
+    else if (dynamic_cast<const SvgCircle*>(element)) kind = RecordCircle;
+    else if (dynamic_cast<const SvgEllipse*>(element)) kind = RecordEllipse;
+    else if (dynamic_cast<const SvgLine*>(element)) kind = RecordLine;
+    else if (dynamic_cast<const SvgPolyline*>(element)) kind = RecordPolyline;
+    else if (dynamic_cast<const SvgPolygon*>(element)) kind = RecordPolygon;
+    else if (dynamic_cast<const SvgPath*>(element)) kind = RecordPath;
+    else if (dynamic_cast<const SvgText*>(element)) kind = RecordText;
+    else if (dynamic_cast<const SvgUse*>(element)) kind = RecordUse;
+    else if (dynamic_cast<const SvgSymbol*>(element)) kind = RecordSymbol;
+    else if (dynamic_cast<const SvgDefinitions*>(element)) kind = RecordDefinitions;
+    else kind = RecordGroup;
+    out << quint8(kind);
+
+    // 2. 通用属性：id、变换、样式、边界框
+    out << element->id() << element->transform().toQTransform();
+    writeStyle(out, element->style());
+    // 组的包围盒按子元素实时计算、还原后不读取；逐组计算在深层嵌套时是平方级的，直接写空矩形
+    out << (element->type() == SvgElement::TypeGroup ? QRectF() : element->boundingBox());
+
+    // 3. 专属属性
+    switch (kind) {
+    case RecordRect: {
+        auto* rect = static_cast<const SvgRect*>(element);
+        out << rect->x() << rect->y() << rect->width() << rect->height()
+            << rect->rx() << rect->ry();
+        break;
+    }
+    case RecordCircle: {
+        auto* circle = static_cast<const SvgCircle*>(element);
+        out << circle->center() << circle->radius();
+        break;
+    }
+    case RecordEllipse: {
+        auto* ellipse = static_cast<const SvgEllipse*>(element);
+        out << ellipse->cx() << ellipse->cy() << ellipse->rx() << ellipse->ry();
+        break;
+    }
+    case RecordLine: {
+        auto* line = static_cast<const SvgLine*>(element);
+        out << line->x1() << line->y1() << line->x2() << line->y2();
+        break;
+    }
+    case RecordPolyline:
+        out << static_cast<const SvgPolyline*>(element)->points();
+        break;
+    case RecordPolygon:
+        out << static_cast<const SvgPolygon*>(element)->points();
+        break;
+    case RecordPath: {
+        // 路径直接写出紧凑几何：指令数组 + 单精度坐标数组
+        auto* svgPath = static_cast<const SvgPath*>(element);
+        const bool wasLoaded = svgPath->isGeometryLoaded();
+        const SvgPathData geometry = svgPath->geometry();
+        out << geometry.verbs();
+        out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        out << geometry.coords();
+        out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        // 懒加载路径写完缓存后恢复未加载状态，不因写缓存而常驻几何
+        if (!wasLoaded) svgPath->releaseGeometry();
+        break;
+    }
+    case RecordText: {
+        auto* text = static_cast<const SvgText*>(element);
+        out << text->position() << text->text();
+        break;
+    }
+    case RecordUse: {
+        // 只写引用，目标在还原后按id重新解析
+        auto* use = static_cast<const SvgUse*>(element);
+        out << use->href() << use->x() << use->y() << use->width() << use->height();
+        break;
+    }
+    case RecordSymbol:
+        out << static_cast<const SvgSymbol*>(element)->viewBox();
+        Q_FALLTHROUGH();
+    case RecordDefinitions:
+    case RecordGroup: {
+        // 只写子元素数量，子元素的记录由writeElement按前序随后写出
+        if (kind == RecordGroup) out << quint8(static_cast<const SvgGroup*>(element)->layerHint());
+        out << quint32(static_cast<const SvgGroup*>(element)->children().size());
+        break;
+    }
+    }
+}
+
+SvgElement* SvgDocumentCache::readElement(QDataStream& in, SvgGeometryPool* pool)
+{
+    // 与writeElement对应的前序读入：打开的组记录剩余子元素数，读满后出栈（显式栈，不递归）
+    struct Open {
+        SvgGroup* group;
+        quint32 remaining;
+    };
+    QStack<Open> open;
+    SvgElement* root = nullptr;
+    do {
+        quint32 childCount = 0;
+        SvgElement* element = readRecord(in, pool, &childCount);
+        if (!element) {
+            delete root;   // 已读入的部分都挂在根上，一并释放
+            return nullptr;
+        }
+        if (open.isEmpty()) {
+            root = element;
+        } else {
+            open.top().group->addChild(element);
+            --open.top().remaining;
+        }
+        if (childCount > 0) open.push({static_cast<SvgGroup*>(element), childCount});
+        while (!open.isEmpty() && open.top().remaining == 0) open.pop();
+    } while (!open.isEmpty());
+    return root;
+}
+
+SvgElement* SvgDocumentCache::readRecord(QDataStream& in, SvgGeometryPool* pool, quint32* childCount)
+{
+    quint8 kind = 0;
+    QString id;
+    QTransform transform;
+    SvgStyle style;
+    QRectF bbox;
+    in >> kind >> id >> transform;
+    readStyle(in, style);
+    in >> bbox;
+    if (in.status() != QDataStream::Ok) return nullptr;
+
+    SvgElement* element = nullptr;
+    switch (kind) {
+    case RecordRect: {
+        qreal x, y, w, h, rx, ry;
+        in >> x >> y >> w >> h >> rx >> ry;
+        auto* rect = new SvgRect();
+        rect->setX(x);
+        rect->setY(y);
+        rect->setWidth(w);
+        rect->setHeight(h);
+        rect->setRx(rx);
+        rect->setRy(ry);
+        element = rect;
+        break;
+    }
+    case RecordCircle: {
+        QPointF center;
+        qreal radius;
+        in >> center >> radius;
+        auto* circle = new SvgCircle();
+        circle->setCenter(center);
+        circle->setRadius(radius);
+        element = circle;
+        break;
+    }
+    case RecordEllipse: {
+        qreal cx, cy, rx, ry;
+        in >> cx >> cy >> rx >> ry;
+        auto* ellipse = new SvgEllipse();
+        ellipse->setCx(cx);
+        ellipse->setCy(cy);
+        ellipse->setRx(rx);
+        ellipse->setRy(ry);
+        element = ellipse;
+        break;
+    }
+    case RecordLine: {
+        qreal x1, y1, x2, y2;
+        in >> x1 >> y1 >> x2 >> y2;
+        auto* line = new SvgLine();
+        line->setX1(x1);
+        line->setY1(y1);
+        line->setX2(x2);
+        line->setY2(y2);
+        element = line;
+        break;
+    }
+    case RecordPolyline: {
+        QPolygonF points;
+        in >> points;
+        auto* polyline = new SvgPolyline();
+        polyline->setPoints(pool ? pool->internPoints(points) : points);
+        element = polyline;
+        break;
+    }
+    case RecordPolygon: {
+        QPolygonF points;
+        in >> points;
+        auto* polygon = new SvgPolygon();
+        polygon->setPoints(pool ? pool->internPoints(points) : points);
+        element = polygon;
+        break;
+    }
+    case RecordPath: {
+        QVector<quint8> verbs;
+        QVector<float> coords;
+        in >> verbs;
+        in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        in >> coords;
+        in.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        auto* svgPath = new SvgPath();
+        const SvgPathData data = SvgPathData::fromArrays(verbs, coords);
+        // 缓存中每个副本各存一份，还原时按内容重新合并为共享几何
+        svgPath->setGeometry(pool ? pool->internPath(data) : data);
+        element = svgPath;
+        break;
+    }
+    case RecordText: {
+        QPointF position;
+        QString text;
+        in >> position >> text;
+        auto* svgText = new SvgText();
+        svgText->setPosition(position);
+        svgText->setText(text);
+        element = svgText;
+        break;
+    }
+    case RecordUse: {
+        QString href;
+        qreal x, y, width, height;
+        in >> href >> x >> y >> width >> height;
+        auto* use = new SvgUse();
+        use->setHref(href);
+        use->setX(x);
+        use->setY(y);
+        use->setWidth(width);
+        use->setHeight(height);
+        element = use;
+        break;
+    }
+    case RecordSymbol:
+    case RecordDefinitions:
+    case RecordGroup: {
+        SvgGroup* group = nullptr;
+        if (kind == RecordSymbol) {
+            QRectF viewBox;
+            in >> viewBox;
+            auto* symbol = new SvgSymbol();
+            symbol->setViewBox(viewBox);
+            group = symbol;
+        } else if (kind == RecordDefinitions) {
+            group = new SvgDefinitions();
+        } else {
+            quint8 hint = 0;
+            in >> hint;
+            group = new SvgGroup();
+            group->setLayerHint(hint == SvgGroup::LayerStatic ? SvgGroup::LayerStatic : SvgGroup::LayerAuto);
+        }
+        in >> *childCount;   // 子元素记录随后由readElement读入
+        element = group;
+        break;
+    }
+    default:
+        qDebug() << "缓存中出现未知的元素记录类型：" << kind;
+        return nullptr;
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        delete element;
+        return nullptr;
+    }
+
+    element->setId(id);
+    element->setTransform(SvgTransform(transform));
+    element->setStyle(style);
+    element->setBoundingBox(bbox);
+    return element;
+}
@@ -1,5 +1,6 @@
 #include "SvgElement.h"
 #include "SvgRenderer.h"
+#include "SvgGroup.h"
 #include <QDebug>
 
 // 构造函数
@@ -80,3 +81,13 @@ void SvgElement::setBoundingBox(const QRectF& bbox)
 {
     mBoundingBox = bbox;
 }
+
+// 世界变换：沿父指针向上组合（显示列表的累积变换同为 元素 * 父级）
+QTransform SvgElement::worldTransform() const
+{
+    QTransform world = mTransform.toQTransform();
+    for (const SvgElement* ancestor = mParent; ancestor; ancestor = ancestor->parent()) {
+        world = world * ancestor->transform().toQTransform();
+    }
+    return world;
+}
@@ -8,26 +8,40 @@
 #include "SvgPolyline.h"  // 新增：折线元素
 #include "SvgPolygon.h"   // 新增：多边形元素
 #include "SvgPath.h"      // 新增：路径元素
+#include "SvgDefinitions.h"
+#include "SvgSymbol.h"
+#include "SvgUse.h"
 #include "SvgTransform.h"
 #include "SvgStyle.h"
-#include <QDomElement>
+#include "SvgGeometryPool.h"
+#include "SvgPointKernels.h"
 #include <QDebug>
 #include <QRegularExpression>
 #include <QFont>
 #include <QFontMetricsF>
+#include <initializer_list>
 
-// 核心：扩展标签识别
-SvgElement* SvgElementFactory::createElement(const QDomElement& domElement, SvgDocument* document) {
-    const QString tagName = domElement.tagName().toLower();
+bool SvgElementFactory::sLazyPathParsing = false;
+
+bool SvgElementFactory::isSupportedTag(const QString& tagName)
+{
+    return tagName == "svg" || tagName == "g" || tagName == "rect" || tagName == "circle"
+           || tagName == "ellipse" || tagName == "line" || tagName == "polyline"
+           || tagName == "polygon" || tagName == "path" || tagName == "text" || tagName == "defs"
+           || tagName == "symbol" || tagName == "use";
+}
+
+// 核心：按标签创建单个元素（容器只创建自身，子元素由调用方添加）
+SvgElement* SvgElementFactory::createElement(const SvgNodeSource& node, SvgDocument* document) {
+    const QString& tagName = node.tagName();
 
     if (tagName == "svg") {
         auto* rootGroup = new SvgGroup();
-        parseCommonAttributes(rootGroup, domElement);
+        parseCommonAttributes(rootGroup, node);
 
         // 解析viewBox（此时document参数有效）
-        if (domElement.hasAttribute("viewBox")) {
-            QString viewBoxStr = domElement.attribute("viewBox");
-            QList<qreal> viewBoxVals = parseNumbers(viewBoxStr);
+        if (node.hasAttribute("viewBox")) {
+            QList<qreal> viewBoxVals = parseNumbers(node.attribute("viewBox"));
             if (viewBoxVals.size() == 4 && document) {  // 这里document已通过参数传入
                 document->setViewBox(QRectF(
                     viewBoxVals[0], viewBoxVals[1],
@@ -35,37 +49,37 @@ SvgElement* SvgElementFactory::createElement(const QDomElement& domElement, SvgD
                     ));
             }
         }
-
-        // 递归解析子元素（必须传递document参数）
-        QDomNode childNode = domElement.firstChild();
-        while (!childNode.isNull()) {
-            if (childNode.isElement()) {
-                // 调用带document参数的重载版本
-                SvgElement* childElem = createElement(childNode.toElement(), document);
-                if (childElem) rootGroup->addChild(childElem);
-            }
-            childNode = childNode.nextSibling();
-        }
         return rootGroup;
     } else if (tagName == "rect") {
-        return createRectElement(domElement);
+        return createRectElement(node);
     } else if (tagName == "circle") {
-        return createCircleElement(domElement);
+        return createCircleElement(node);
     } else if (tagName == "ellipse") {
-        return createEllipseElement(domElement);
+        return createEllipseElement(node);
     } else if (tagName == "line") {
-        return createLineElement(domElement);
+        return createLineElement(node);
     } else if (tagName == "polyline") {
-        return createPolylineElement(domElement, document);
+        return createPolylineElement(node, document);
     } else if (tagName == "polygon") {
-        return createPolygonElement(domElement, document);
+        return createPolygonElement(node, document);
     } else if (tagName == "path") {
-        return createPathElement(domElement);
+        return createPathElement(node, document);
     } else if (tagName == "text") {
-        qDebug() << "解析文本元素，内容：" << domElement.text();
-        return createTextElement(domElement);
+        qDebug() << "解析文本元素，内容：" << node.text();
+        return createTextElement(node);
     } else if (tagName == "g") {
-        return createGroupElement(domElement, document);
+        return createGroupElement(node);
+    } else if (tagName == "defs") {
+        return initContainer(new SvgDefinitions(), node);
+    } else if (tagName == "symbol") {
+        auto* symbol = new SvgSymbol();
+        const QList<qreal> viewBoxVals = parseNumbers(node.attribute("viewBox"));
+        if (viewBoxVals.size() == 4) {
+            symbol->setViewBox(QRectF(viewBoxVals[0], viewBoxVals[1], viewBoxVals[2], viewBoxVals[3]));
+        }
+        return initContainer(symbol, node);
+    } else if (tagName == "use") {
+        return createUseElement(node);
     }
 
     qDebug() << "未支持的元素：" << tagName;
@@ -73,41 +87,41 @@ SvgElement* SvgElementFactory::createElement(const QDomElement& domElement, SvgD
 }
 
 // 通用属性解析（无需修改，已支持所有元素的通用样式/变换）
-void SvgElementFactory::parseCommonAttributes(SvgElement* element, const QDomElement& domElement)
+void SvgElementFactory::parseCommonAttributes(SvgElement* element, const SvgNodeSource& node)
 {
     if (!element) return;
 
     // 1. 解析ID
-    if (domElement.hasAttribute("id")) {
-        element->setId(domElement.attribute("id"));
+    if (node.hasAttribute("id")) {
+        element->setId(node.attribute("id").toString());
     }
 
-    // 2. 解析Transform（修正变量名：domElem→domElement，elem→element）
-    if (domElement.hasAttribute("transform")) {  // 修正：domElem→domElement
-        QString transformStr = domElement.attribute("transform");  // 修正：domElem→domElement
+    // 2. 解析Transform
+    if (node.hasAttribute("transform")) {
+        const QString transformStr = node.attribute("transform").toString();
         SvgTransform transform;
         transform.parse(transformStr);
-        element->setTransform(transform);  // 修正：elem→element
-        qDebug() << "解析元素transform：" << transformStr << "（元素类型：" << domElement.tagName() << "）";  // 修正：domElem→domElement
+        element->setTransform(transform);
+        qDebug() << "解析元素transform：" << transformStr << "（元素类型：" << node.tagName() << "）";
     }
     // 3. 解析样式（复用现有逻辑，支持inline style和单独属性）
     SvgStyle style;
-    if (domElement.hasAttribute("style")) {
-        style.parseStyleString(domElement.attribute("style"));
+    if (node.hasAttribute("style")) {
+        style.parseStyleString(node.attribute("style"));
     }
     // 解析单独的样式属性（fill/stroke等）
-    if (domElement.hasAttribute("fill")) {
-        QString fillValue = domElement.attribute("fill");
+    if (node.hasAttribute("fill")) {
+        const QString fillValue = node.attribute("fill").toString();
         style.parseAttribute("fill", fillValue);
         qDebug() << "解析fill：" << fillValue;
     }
-    if (domElement.hasAttribute("stroke")) {
-        QString strokeValue = domElement.attribute("stroke");
+    if (node.hasAttribute("stroke")) {
+        const QString strokeValue = node.attribute("stroke").toString();
         style.parseAttribute("stroke", strokeValue);
         qDebug() << "解析stroke：" << strokeValue;
     }
-    if (domElement.hasAttribute("stroke-width")) {
-        QString strokeWidthValue = domElement.attribute("stroke-width");
+    if (node.hasAttribute("stroke-width")) {
+        const QString strokeWidthValue = node.attribute("stroke-width").toString();
         style.parseAttribute("stroke-width", strokeWidthValue);
         qDebug() << "解析stroke-width：" << strokeWidthValue;
     }
@@ -118,18 +132,18 @@ void SvgElementFactory::parseCommonAttributes(SvgElement* element, const QDomEle
 }
 
 // 以下为原有元素的创建函数（保持不变）
-SvgElement* SvgElementFactory::createRectElement(const QDomElement& domElement)
+SvgElement* SvgElementFactory::createRectElement(const SvgNodeSource& node)
 {
     auto* rect = new SvgRect();
-    parseCommonAttributes(rect, domElement);
+    parseCommonAttributes(rect, node);
 
     // 直接解析矩形属性（替换attrs）
-    qreal x = parseDoubleAttr(domElement, "x");
-    qreal y = parseDoubleAttr(domElement, "y");
-    qreal width = parseDoubleAttr(domElement, "width");
-    qreal height = parseDoubleAttr(domElement, "height");
-    qreal rx = parseDoubleAttr(domElement, "rx", QRectF(), 0);  // 默认为0（直角）
-    qreal ry = parseDoubleAttr(domElement, "ry", QRectF(), 0);
+    qreal x = parseDoubleAttr(node, "x");
+    qreal y = parseDoubleAttr(node, "y");
+    qreal width = parseDoubleAttr(node, "width");
+    qreal height = parseDoubleAttr(node, "height");
+    qreal rx = parseDoubleAttr(node, "rx", QRectF(), 0);  // 默认为0（直角）
+    qreal ry = parseDoubleAttr(node, "ry", QRectF(), 0);
 
     // 设置矩形属性
     rect->setX(x);
@@ -144,15 +158,15 @@ SvgElement* SvgElementFactory::createRectElement(const QDomElement& domElement)
     return rect;
 }
 
-SvgElement* SvgElementFactory::createCircleElement(const QDomElement& domElement)
+SvgElement* SvgElementFactory::createCircleElement(const SvgNodeSource& node)
 {
     auto* circle = new SvgCircle();
-    parseCommonAttributes(circle, domElement);
+    parseCommonAttributes(circle, node);
 
     // 直接解析圆形属性（替换attrs）
-    qreal cx = parseDoubleAttr(domElement, "cx");
-    qreal cy = parseDoubleAttr(domElement, "cy");
-    qreal r = parseDoubleAttr(domElement, "r");
+    qreal cx = parseDoubleAttr(node, "cx");
+    qreal cy = parseDoubleAttr(node, "cy");
+    qreal r = parseDoubleAttr(node, "r");
 
     // 设置圆形属性
     circle->setCenter(QPointF(cx, cy));
@@ -168,38 +182,37 @@ SvgElement* SvgElementFactory::createCircleElement(const QDomElement& domElement
     return circle;
 }
 
-SvgElement* SvgElementFactory::createTextElement(const QDomElement& domElement)
+SvgElement* SvgElementFactory::createTextElement(const SvgNodeSource& node)
 {
     auto* text = new SvgText();
     // 1. 解析通用属性（确保包含text-anchor等文本特有属性）
-    parseCommonAttributes(text, domElement);
+    parseCommonAttributes(text, node);
 
     // 2. 解析文本位置（支持带单位的属性值，如"250px"）
-    qreal x = parseDimensionAttr(domElement, "x", 0);  // 替换为支持单位的解析函数
-    qreal y = parseDimensionAttr(domElement, "y", 0);
+    qreal x = parseDimensionAttr(node, "x", 0);  // 替换为支持单位的解析函数
+    qreal y = parseDimensionAttr(node, "y", 0);
     text->setPosition(QPointF(x, y));
 
     // 3. 解析文本内容（保留原始内容，避免trim误删有效空格）
-    text->setText(domElement.text());  // 仅在确认需要时trim（如用户明确要求去空格）
+    text->setText(node.text());  // 仅在确认需要时trim（如用户明确要求去空格）
 
     // 4. 解析字体属性（完善单位处理和容错）
     SvgStyle style = text->style();  // 获取通用属性解析后的基础样式
     // 解析font-family（支持多字体备选，如" Arial, sans-serif"）
-    if (domElement.hasAttribute("font-family")) {
-        QString family = domElement.attribute("font-family").trimmed();
+    if (node.hasAttribute("font-family")) {
+        QString family = node.attribute("font-family").trimmed().toString();
         // 移除可能的引号（SVG中font-family可能带引号，如font-family="'Arial'"）
         family.remove(QRegularExpression("^['\"]|['\"]$"));
         style.parseAttribute("font-family", family);
     }
     // 解析font-size（处理单位，如"20px" -> 20）
-    if (domElement.hasAttribute("font-size")) {
-        QString sizeStr = domElement.attribute("font-size");
-        qreal fontSize = parseDimension(sizeStr, 12);  // 自定义函数：提取数值（默认12）
+    if (node.hasAttribute("font-size")) {
+        qreal fontSize = parseDimension(node.attribute("font-size"), 12);  // 自定义函数：提取数值（默认12）
         style.parseAttribute("font-size", QString::number(fontSize));
     }
     // 解析text-anchor（确保覆盖通用属性未处理的情况）
-    if (domElement.hasAttribute("text-anchor")) {
-        style.parseAttribute("text-anchor", domElement.attribute("text-anchor"));
+    if (node.hasAttribute("text-anchor")) {
+        style.parseAttribute("text-anchor", node.attribute("text-anchor").toString());
     }
     text->setStyle(style);  // 更新样式
 
@@ -223,44 +236,46 @@ SvgElement* SvgElementFactory::createTextElement(const QDomElement& domElement)
     return text;
 }
 
-SvgElement* SvgElementFactory::createGroupElement(const QDomElement& domElement, SvgDocument* document)
+SvgElement* SvgElementFactory::createGroupElement(const SvgNodeSource& node)
 {
     auto* group = new SvgGroup();
-    parseCommonAttributes(group, domElement);
-
-    QDomNode childNode = domElement.firstChild();
-    while (!childNode.isNull()) {
-        if (childNode.isElement()) {
-            SvgElement* child = createElement(childNode.toElement(), document);
-            if (child) group->addChild(child);
-        }
-        childNode = childNode.nextSibling();
-    }
+    if (node.attribute("data-layer") == QLatin1String("static")) group->setLayerHint(SvgGroup::LayerStatic);
+    return initContainer(group, node);
+}
 
-    // 计算组的边界框（合并所有子元素的边界框）
-    QRectF groupBbox;
-    foreach (const SvgElement* child, group->children()) {
-        if (groupBbox.isEmpty()) {
-            groupBbox = child->boundingBox();
-        } else {
-            groupBbox = groupBbox.united(child->boundingBox());
-        }
-    }
-    group->setBoundingBox(groupBbox);
+SvgElement* SvgElementFactory::initContainer(SvgGroup* group, const SvgNodeSource& node)
+{
+    parseCommonAttributes(group, node);
     return group;
 }
 
+// use元素：只记录引用与位置，目标在加载结束后由文档按id解析
+SvgElement* SvgElementFactory::createUseElement(const SvgNodeSource& node)
+{
+    auto* use = new SvgUse();
+    parseCommonAttributes(use, node);
+
+    // SVG 2使用href，旧文件使用xlink:href
+    const QStringView href = node.hasAttribute("href") ? node.attribute("href") : node.attribute("xlink:href");
+    use->setHref((href.startsWith(u'#') ? href.mid(1) : href).toString());
+    use->setX(parseDoubleAttr(node, "x"));
+    use->setY(parseDoubleAttr(node, "y"));
+    use->setWidth(parseDoubleAttr(node, "width"));
+    use->setHeight(parseDoubleAttr(node, "height"));
+    return use;
+}
+
 // 椭圆元素创建与属性解析
-SvgElement* SvgElementFactory::createEllipseElement(const QDomElement& domElement)
+SvgElement* SvgElementFactory::createEllipseElement(const SvgNodeSource& node)
 {
     auto* ellipse = new SvgEllipse();
-    parseCommonAttributes(ellipse, domElement);
+    parseCommonAttributes(ellipse, node);
 
     // 直接解析椭圆属性（替换attrs）
-    qreal cx = parseDoubleAttr(domElement, "cx");
-    qreal cy = parseDoubleAttr(domElement, "cy");
-    qreal rx = parseDoubleAttr(domElement, "rx");
-    qreal ry = parseDoubleAttr(domElement, "ry");
+    qreal cx = parseDoubleAttr(node, "cx");
+    qreal cy = parseDoubleAttr(node, "cy");
+    qreal rx = parseDoubleAttr(node, "rx");
+    qreal ry = parseDoubleAttr(node, "ry");
 
     // 设置椭圆属性
     ellipse->setCx(cx);
@@ -279,16 +294,16 @@ SvgElement* SvgElementFactory::createEllipseElement(const QDomElement& domElemen
 }
 
 // 直线元素创建与属性解析
-SvgElement* SvgElementFactory::createLineElement(const QDomElement& domElement)
+SvgElement* SvgElementFactory::createLineElement(const SvgNodeSource& node)
 {
     auto* line = new SvgLine();
-    parseCommonAttributes(line, domElement);
+    parseCommonAttributes(line, node);
 
     // 直接解析x1/y1/x2/y2属性（替换attrs）
-    qreal x1 = parseDoubleAttr(domElement, "x1");  // 假设已实现parseDoubleAttr（支持单位）
-    qreal y1 = parseDoubleAttr(domElement, "y1");
-    qreal x2 = parseDoubleAttr(domElement, "x2");
-    qreal y2 = parseDoubleAttr(domElement, "y2");
+    qreal x1 = parseDoubleAttr(node, "x1");  // 假设已实现parseDoubleAttr（支持单位）
+    qreal y1 = parseDoubleAttr(node, "y1");
+    qreal x2 = parseDoubleAttr(node, "x2");
+    qreal y2 = parseDoubleAttr(node, "y2");
 
     // 设置直线属性
     line->setX1(x1);
@@ -308,66 +323,293 @@ SvgElement* SvgElementFactory::createLineElement(const QDomElement& domElement)
 }
 
 // 折线元素创建与属性解析
-SvgElement* SvgElementFactory::createPolylineElement(const QDomElement& domElement, SvgDocument* document)
+SvgElement* SvgElementFactory::createPolylineElement(const SvgNodeSource& node, SvgDocument* document)
 {
     auto* polyline = new SvgPolyline();
-    parseCommonAttributes(polyline, domElement);
+    parseCommonAttributes(polyline, node);
 
     // 解析折线特有属性：points(坐标列表，如"0,0 100,50 200,0")
-    if (domElement.hasAttribute("points")) {
-        QRectF viewBox = document ? document->viewBox() : QRectF();
-        QList<QPointF> points = parsePoints(domElement.attribute("points"), viewBox);
-        polyline->setPoints(points);
+    SvgGeometryPool::PointsEntry geometry;
+    if (node.hasAttribute("points")) {
+        geometry = parsePointsShared(node.attribute("points"), document);
+        polyline->setPoints(geometry.points);
     }
 
     // 设置边界框（包含所有点的最小矩形）
-    polyline->setBoundingBox(calculatePointsBoundingBox(polyline->points()));
+    polyline->setBoundingBox(geometry.bounds);
     qDebug() << "创建折线元素：" << polyline->points().size() << "个点";
     return polyline;
 }
 
 // 多边形元素创建与属性解析（与折线类似，但自动闭合）
-SvgElement* SvgElementFactory::createPolygonElement(const QDomElement& domElement, SvgDocument* document)
+SvgElement* SvgElementFactory::createPolygonElement(const SvgNodeSource& node, SvgDocument* document)
 {
     auto* polygon = new SvgPolygon();
-    parseCommonAttributes(polygon, domElement);
+    parseCommonAttributes(polygon, node);
 
     // 解析多边形特有属性：points(坐标列表)
-    if (domElement.hasAttribute("points")) {
-        QRectF viewBox = document ? document->viewBox() : QRectF();
-        QList<QPointF> points = parsePoints(domElement.attribute("points"), viewBox);
-        polygon->setPoints(points);
+    SvgGeometryPool::PointsEntry geometry;
+    if (node.hasAttribute("points")) {
+        geometry = parsePointsShared(node.attribute("points"), document);
+        polygon->setPoints(geometry.points);
     }
 
     // 设置边界框
-    polygon->setBoundingBox(calculatePointsBoundingBox(polygon->points()));
+    polygon->setBoundingBox(geometry.bounds);
     qDebug() << "创建多边形元素：" << polygon->points().size() << "个点";
     return polygon;
 }
 
 // 路径元素创建与属性解析（最复杂，需解析d属性）
-SvgElement* SvgElementFactory::createPathElement(const QDomElement& domElement)
+SvgElement* SvgElementFactory::createPathElement(const SvgNodeSource& node, SvgDocument* document)
 {
     auto* path = new SvgPath();
-    parseCommonAttributes(path, domElement);
+    parseCommonAttributes(path, node);
+    SvgGeometryPool* pool = document ? document->geometryPool() : nullptr;
+    const QStringView d = node.attribute("d");
+
+    // 懒加载模式：只保存d字符串，边界框由快速扫描估算，几何延迟到首次绘制
+    if (sLazyPathParsing) {
+        if (pool) {
+            // 重复的d共用同一个字符串，估算也只做一次
+            const SvgGeometryPool::LazyPathEntry entry = pool->lazyPath(d, [d]() { return estimatePathBounds(d); });
+            path->setPathData(entry.d);
+            path->setBoundingBox(entry.estimate);
+        } else {
+            path->setPathData(d.toString());
+            path->setBoundingBox(estimatePathBounds(d));
+        }
+        return path;
+    }
 
-    // 解析路径特有属性：d(路径命令，如"M10,10 L100,10 Z")
-    if (domElement.hasAttribute("d")) {
-        QString d = domElement.attribute("d");
-        QPainterPath painterPath = parsePathData(d);
-        path->setPath(painterPath);
+    // 解析路径特有属性：d(路径命令，如"M10,10 L100,10 Z")，直接在属性值上解析
+    if (node.hasAttribute("d")) {
+        auto parse = [d]() {
+            SvgGeometryPool::PathEntry entry;
+            entry.data = SvgPathData::fromPainterPath(parsePathData(d));
+            entry.bounds = entry.data.bounds();
+            return entry;
+        };
+        // 相同的d只解析一次，所有引用它的路径共享同一份只读几何
+        const SvgGeometryPool::PathEntry entry = pool ? pool->path(d, parse) : parse();
+        path->setGeometry(entry.data, entry.bounds);
     }
 
-    // 设置边界框（路径的外接矩形）
-    path->setBoundingBox(path->path().boundingRect());
-    qDebug() << "创建路径元素：" << path->path().elementCount() << "个路径段";
+    // 设置边界框（紧凑几何的紧致包围盒）
+    path->setBoundingBox(path->boundingBox());
+    qDebug() << "创建路径元素：" << path->geometry().verbCount() << "个路径段";
     return path;
 }
 
-QList<qreal> SvgElementFactory::parseNumbers(const QString& str) {
+bool SvgElementFactory::applyAttribute(SvgElement* element, const QString& name, const QString& value,
+                                       const SvgDocument* document)
+{
+    if (!element) return false;
+
+    // 1. 通用属性
+    if (name == "id") {
+        element->setId(value);
+        return true;
+    }
+    if (name == "transform") {
+        SvgTransform transform;
+        transform.parse(value);
+        element->setTransform(transform);
+        return true;
+    }
+    if (name == "style" || SvgStyle::isStyleProperty(name)) {
+        SvgStyle style = element->style();
+        if (name == "style") {
+            style.parseStyleString(value);
+        } else if (name == "font-size") {
+            style.parseAttribute(name, QString::number(parseDimension(value, 12)));
+        } else {
+            style.parseAttribute(name, value);
+        }
+        element->setStyle(style);
+        return true;
+    }
+
+    // 2. 几何属性：与create*Element相同的解析方式，之后重算边界框
+    const qreal number = parseDoubleAttrFromString(value, QRectF());
+    if (auto* use = dynamic_cast<SvgUse*>(element)) {
+        // 引用变化后由文档重新解析目标
+        if (name == "href" || name == "xlink:href") use->setHref(value.startsWith('#') ? value.mid(1) : value);
+        else if (name == "x") use->setX(number);
+        else if (name == "y") use->setY(number);
+        else if (name == "width") use->setWidth(number);
+        else if (name == "height") use->setHeight(number);
+        else return false;
+        return true;
+    }
+    if (auto* symbol = dynamic_cast<SvgSymbol*>(element)) {
+        const QList<qreal> viewBoxVals = parseNumbers(value);
+        if (name != "viewBox" || viewBoxVals.size() != 4) return false;
+        symbol->setViewBox(QRectF(viewBoxVals[0], viewBoxVals[1], viewBoxVals[2], viewBoxVals[3]));
+        return true;
+    }
+    if (auto* group = dynamic_cast<SvgGroup*>(element)) {
+        if (name != "data-layer") return false;
+        group->setLayerHint(value == "static" ? SvgGroup::LayerStatic : SvgGroup::LayerAuto);
+        return true;
+    }
+    if (auto* rect = dynamic_cast<SvgRect*>(element)) {
+        if (name == "x") rect->setX(number);
+        else if (name == "y") rect->setY(number);
+        else if (name == "width") rect->setWidth(number);
+        else if (name == "height") rect->setHeight(number);
+        else if (name == "rx") rect->setRx(number);
+        else if (name == "ry") rect->setRy(number);
+        else return false;
+        rect->setBoundingBox(normalizeBbox(QRectF(rect->x(), rect->y(), rect->width(), rect->height())));
+        return true;
+    }
+    if (auto* circle = dynamic_cast<SvgCircle*>(element)) {
+        QPointF center = circle->center();
+        if (name == "cx") center.setX(number);
+        else if (name == "cy") center.setY(number);
+        else if (name == "r") circle->setRadius(number);
+        else return false;
+        circle->setCenter(center);
+        const qreal r = circle->radius();
+        circle->setBoundingBox(normalizeBbox(QRectF(center.x() - r, center.y() - r, r * 2, r * 2)));
+        return true;
+    }
+    if (auto* ellipse = dynamic_cast<SvgEllipse*>(element)) {
+        if (name == "cx") ellipse->setCx(number);
+        else if (name == "cy") ellipse->setCy(number);
+        else if (name == "rx") ellipse->setRx(number);
+        else if (name == "ry") ellipse->setRy(number);
+        else return false;
+        ellipse->setBoundingBox(normalizeBbox(QRectF(ellipse->cx() - ellipse->rx(), ellipse->cy() - ellipse->ry(),
+                                                     ellipse->rx() * 2, ellipse->ry() * 2)));
+        return true;
+    }
+    if (auto* line = dynamic_cast<SvgLine*>(element)) {
+        if (name == "x1") line->setX1(number);
+        else if (name == "y1") line->setY1(number);
+        else if (name == "x2") line->setX2(number);
+        else if (name == "y2") line->setY2(number);
+        else return false;
+        line->setBoundingBox(normalizeBbox(QRectF(QPointF(qMin(line->x1(), line->x2()), qMin(line->y1(), line->y2())),
+                                                  QPointF(qMax(line->x1(), line->x2()), qMax(line->y1(), line->y2())))));
+        return true;
+    }
+    if (name == "points") {
+        const QRectF viewBox = referenceViewBox(document);
+        if (auto* polyline = dynamic_cast<SvgPolyline*>(element)) {
+            polyline->setPoints(parsePoints(value, viewBox));
+            polyline->setBoundingBox(calculatePointsBoundingBox(polyline->points()));
+            return true;
+        }
+        if (auto* polygon = dynamic_cast<SvgPolygon*>(element)) {
+            polygon->setPoints(parsePoints(value, viewBox));
+            polygon->setBoundingBox(calculatePointsBoundingBox(polygon->points()));
+            return true;
+        }
+        return false;
+    }
+    if (auto* path = dynamic_cast<SvgPath*>(element)) {
+        if (name != "d") return false;
+        if (sLazyPathParsing) {
+            path->setPathData(value);
+            path->setBoundingBox(estimatePathBounds(value));
+        } else {
+            path->setPath(parsePathData(value));
+            path->setBoundingBox(path->boundingBox());
+        }
+        return true;
+    }
+    if (auto* text = dynamic_cast<SvgText*>(element)) {
+        // 文本边界框由位置即时计算
+        QPointF position = text->position();
+        if (name == "x") position.setX(parseDimension(value, 0));
+        else if (name == "y") position.setY(parseDimension(value, 0));
+        else return false;
+        text->setPosition(position);
+        return true;
+    }
+    return false;
+}
+
+bool SvgElementFactory::supportsAttribute(const SvgElement* element, const QString& name, const QString& value)
+{
+    if (!element) return false;
+    if (name == "id" || name == "transform" || name == "style" || SvgStyle::isStyleProperty(name)) return true;
+
+    // 与applyAttribute的分支一一对应
+    auto isOneOf = [&name](std::initializer_list<const char*> names) {
+        for (const char* candidate : names) {
+            if (name == QLatin1String(candidate)) return true;
+        }
+        return false;
+    };
+    if (dynamic_cast<const SvgUse*>(element)) return isOneOf({"href", "xlink:href", "x", "y", "width", "height"});
+    if (dynamic_cast<const SvgSymbol*>(element)) return name == "viewBox" && parseNumbers(value).size() == 4;
+    if (dynamic_cast<const SvgGroup*>(element)) return name == "data-layer";
+    if (dynamic_cast<const SvgRect*>(element)) return isOneOf({"x", "y", "width", "height", "rx", "ry"});
+    if (dynamic_cast<const SvgCircle*>(element)) return isOneOf({"cx", "cy", "r"});
+    if (dynamic_cast<const SvgEllipse*>(element)) return isOneOf({"cx", "cy", "rx", "ry"});
+    if (dynamic_cast<const SvgLine*>(element)) return isOneOf({"x1", "y1", "x2", "y2"});
+    if (name == "points") {
+        return dynamic_cast<const SvgPolyline*>(element) || dynamic_cast<const SvgPolygon*>(element);
+    }
+    if (dynamic_cast<const SvgPath*>(element)) return name == "d";
+    if (dynamic_cast<const SvgText*>(element)) return name == "x" || name == "y";
+    return false;
+}
+
+namespace {
+// 按空白拆分属性值；返回的片段直接指向原字符串，不复制
+QList<QStringView> splitOnSpace(QStringView str)
+{
+    QList<QStringView> parts;
+    int pos = 0;
+    const int size = str.size();
+    while (pos < size) {
+        while (pos < size && str[pos].isSpace()) pos++;
+        const int start = pos;
+        while (pos < size && !str[pos].isSpace()) pos++;
+        if (pos > start) parts.append(str.mid(start, pos - start));
+    }
+    return parts;
+}
+
+// 从pos处读取下一个数字（先跳过空白与逗号）；遇到命令字母或结尾时返回false且不移动pos
+bool readPathNumber(QStringView d, int& pos, qreal& value)
+{
+    const int size = d.size();
+    while (pos < size && (d[pos].isSpace() || d[pos] == u',')) pos++;
+    if (pos >= size) return false;
+    const int start = pos;
+    if (d[pos] == u'+' || d[pos] == u'-') pos++;
+    bool digits = false;
+    while (pos < size && d[pos].isDigit()) { pos++; digits = true; }
+    if (pos < size && d[pos] == u'.') {
+        pos++;
+        while (pos < size && d[pos].isDigit()) { pos++; digits = true; }
+    }
+    if (!digits) {
+        pos = start;
+        return false;
+    }
+    if (pos < size && (d[pos] == u'e' || d[pos] == u'E')) {
+        int expPos = pos + 1;
+        if (expPos < size && (d[expPos] == u'+' || d[expPos] == u'-')) expPos++;
+        if (expPos < size && d[expPos].isDigit()) {
+            pos = expPos;
+            while (pos < size && d[pos].isDigit()) pos++;
+        }
+    }
+    bool ok = false;
+    value = d.mid(start, pos - start).toDouble(&ok);
+    return ok;
+}
+}
+
+QList<qreal> SvgElementFactory::parseNumbers(QStringView str) {
     QList<qreal> numbers;
-    QStringList parts = str.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-    foreach (const QString& part, parts) {
+    for (const QStringView part : splitOnSpace(str)) {
         bool ok;
         qreal num = part.toDouble(&ok);
         if (ok) {
@@ -378,16 +620,15 @@ QList<qreal> SvgElementFactory::parseNumbers(const QString& str) {
 }
 
 // 辅助函数：解析points属性（将"x1,y1 x2,y2"转换为QPointF列表）
-QList<QPointF> SvgElementFactory::parsePoints(const QString& pointsStr, const QRectF& viewBox)
+QList<QPointF> SvgElementFactory::parsePoints(QStringView pointsStr, const QRectF& viewBox)
 {
     QList<QPointF> points;
     if (pointsStr.isEmpty()) return points;
 
     // 按空格拆分每个点
-    QStringList pointList = pointsStr.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-    foreach (const QString& pointStr, pointList) {
+    for (const QStringView pointStr : splitOnSpace(pointsStr)) {
         // 按逗号拆分x和y
-        QStringList coords = pointStr.split(',');
+        const QList<QStringView> coords = pointStr.split(u',');
         if (coords.size() != 2) {
             qDebug() << "无效的点格式：" << pointStr;
             continue;
@@ -402,21 +643,45 @@ QList<QPointF> SvgElementFactory::parsePoints(const QString& pointsStr, const QR
     return points;
 }
 
-// 辅助函数：计算点列表的边界框
-QRectF SvgElementFactory::calculatePointsBoundingBox(const QList<QPointF>& points)
+SvgGeometryPool::PointsEntry SvgElementFactory::parsePointsShared(QStringView pointsStr, SvgDocument* document)
 {
-    if (points.isEmpty()) return QRectF();
+    const QRectF viewBox = referenceViewBox(document);
+    auto parse = [pointsStr, &viewBox]() {
+        SvgGeometryPool::PointsEntry entry;
+        entry.points = parsePoints(pointsStr, viewBox);
+        entry.bounds = calculatePointsBoundingBox(entry.points);
+        return entry;
+    };
+    SvgGeometryPool* pool = document ? document->geometryPool() : nullptr;
+    return pool ? pool->points(pointsStr, viewBox, parse) : parse();
+}
 
-    qreal minX = points[0].x(), maxX = points[0].x();
-    qreal minY = points[0].y(), maxY = points[0].y();
+namespace {
+thread_local const QRectF* sViewBoxSnapshot = nullptr;
+}
 
-    foreach (const QPointF& p, points) {
-        minX = qMin(minX, p.x());
-        maxX = qMax(maxX, p.x());
-        minY = qMin(minY, p.y());
-        maxY = qMax(maxY, p.y());
-    }
-    return QRectF(minX, minY, maxX - minX, maxY - minY);
+SvgElementFactory::ViewBoxSnapshot::ViewBoxSnapshot(const QRectF& viewBox)
+    : mViewBox(viewBox), mPrevious(sViewBoxSnapshot)
+{
+    sViewBoxSnapshot = &mViewBox;
+}
+
+SvgElementFactory::ViewBoxSnapshot::~ViewBoxSnapshot()
+{
+    sViewBoxSnapshot = mPrevious;
+}
+
+QRectF SvgElementFactory::referenceViewBox(const SvgDocument* document)
+{
+    if (sViewBoxSnapshot) return *sViewBoxSnapshot;
+    return document ? document->viewBox() : QRectF();
+}
+
+// 辅助函数：计算点列表的边界框
+QRectF SvgElementFactory::calculatePointsBoundingBox(const QList<QPointF>& points)
+{
+    // 大型点列表（地图、曲线数据）的min/max由批处理内核完成
+    return SvgPointKernels::bounds(points);
 }
 
 QRectF SvgElementFactory::normalizeBbox(const QRectF& bbox) {
@@ -432,14 +697,13 @@ QRectF SvgElementFactory::normalizeBbox(const QRectF& bbox) {
 }
 
 // 辅助函数：解析路径d属性（转换为QPainterPath）
-QPainterPath SvgElementFactory::parsePathData(const QString& d)
+QPainterPath SvgElementFactory::parsePathData(QStringView d)
 {
     QPainterPath path;
     if (d.isEmpty()) return path;
 
-    QRegularExpression cmdRegex("[MLCZAQHVLmlczaqhvl]"); // 路径命令
-    // 支持整数、小数、科学计数法（含负数）
-    QRegularExpression numRegex("-?(?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][-+]?\\d+)?");
+    // 路径命令；数字支持整数、小数、科学计数法（含负数），由readPathNumber手工扫描
+    static const QLatin1String kCommands("MLCZAQHVLmlczaqhvl");
 
     int pos = 0;
     QPointF currentPos;
@@ -452,30 +716,17 @@ QPainterPath SvgElementFactory::parsePathData(const QString& d)
         }
 
         // 匹配路径命令
-        QRegularExpressionMatch cmdMatch = cmdRegex.match(d, pos);
-        if (cmdMatch.hasMatch() && cmdMatch.capturedStart() == pos) {
-            QChar cmd = cmdMatch.captured(0).at(0);
+        if (pos < d.size() && kCommands.contains(d[pos])) {
+            QChar cmd = d[pos];
             isRelative = cmd.isLower();
             char cmdUpper = cmd.toUpper().toLatin1();
-            pos += cmdMatch.capturedLength();
+            pos++;
 
-            // 提取当前命令的所有参数
+            // 提取当前命令的所有参数（跳过参数间的空格或逗号，遇到非数字退出）
             QList<qreal> params;
-            while (pos < d.size()) {
-                // 跳过参数间的分隔符（空格或逗号）
-                while (pos < d.size() && (d[pos].isSpace() || d[pos] == ',')) {
-                    pos++;
-                }
-                if (pos >= d.size()) break;
-
-                // 提取数字参数
-                QRegularExpressionMatch numMatch = numRegex.match(d, pos);
-                if (!numMatch.hasMatch() || numMatch.capturedStart() != pos) {
-                    break; // 非数字，退出参数提取
-                }
-
-                params.append(numMatch.captured(0).toDouble());
-                pos += numMatch.capturedLength();
+            qreal value;
+            while (readPathNumber(d, pos, value)) {
+                params.append(value);
             }
 
             // 处理不同命令（逻辑不变）
@@ -715,7 +966,125 @@ QPainterPath SvgElementFactory::parsePathData(const QString& d)
     return path;
 }
 
-SvgElementFactory::ParsedValue SvgElementFactory::parseValueWithUnit(const QString& str) {
+// 快速估算路径边界：手工扫描数字（不用正则、不生成QPainterPath），
+// 贝塞尔曲线取控制点外包（曲线必在控制点凸包内），弧线按半径向外扩展
+QRectF SvgElementFactory::estimatePathBounds(QStringView d)
+{
+    qreal minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool hasPoint = false;
+    auto include = [&](qreal x, qreal y) {
+        if (!hasPoint) {
+            minX = maxX = x;
+            minY = maxY = y;
+            hasPoint = true;
+            return;
+        }
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    };
+
+    const int size = d.size();
+    int pos = 0;
+    // 读取下一个数字；遇到命令字母或结尾时返回false
+    auto nextNumber = [&](qreal& value) -> bool { return readPathNumber(d, pos, value); };
+
+    QPointF current, subpathStart;
+    while (pos < size) {
+        const QChar c = d[pos];
+        if (!c.isLetter()) {
+            pos++;
+            continue;
+        }
+        pos++;
+        const bool relative = c.isLower();
+        const char cmd = c.toUpper().toLatin1();
+
+        switch (cmd) {
+        case 'M':
+        case 'L':
+        case 'Q':
+        case 'C': {
+            // 坐标成对出现：控制点与终点一并纳入
+            qreal x, y;
+            QPointF origin = current;
+            int pairIndex = 0;
+            bool firstSegment = true;
+            const int pairsPerSegment = cmd == 'Q' ? 2 : (cmd == 'C' ? 3 : 1);
+            while (nextNumber(x) && nextNumber(y)) {
+                if (relative) { x += origin.x(); y += origin.y(); }
+                include(x, y);
+                if (++pairIndex == pairsPerSegment) {
+                    current = QPointF(x, y);
+                    if (cmd == 'M' && firstSegment) subpathStart = current;
+                    firstSegment = false;
+                    origin = current;  // 相对坐标以上一段终点为基准
+                    pairIndex = 0;
+                }
+            }
+            break;
+        }
+        case 'H': {
+            qreal x;
+            while (nextNumber(x)) {
+                current.setX(relative ? current.x() + x : x);
+                include(current.x(), current.y());
+            }
+            break;
+        }
+        case 'V': {
+            qreal y;
+            while (nextNumber(y)) {
+                current.setY(relative ? current.y() + y : y);
+                include(current.x(), current.y());
+            }
+            break;
+        }
+        case 'A': {
+            qreal rx, ry, rot, large, sweep, x, y;
+            while (nextNumber(rx) && nextNumber(ry) && nextNumber(rot)
+                   && nextNumber(large) && nextNumber(sweep)
+                   && nextNumber(x) && nextNumber(y)) {
+                if (relative) { x += current.x(); y += current.y(); }
+                rx = qAbs(rx);
+                ry = qAbs(ry);
+                if (rx > 0 && ry > 0) {
+                    // 半径不足以连接两端点时按规范放大（F.6.6）：Λ = x1'²/rx² + y1'²/ry²，Λ > 1时乘以√Λ
+                    const qreal rad = qDegreesToRadians(rot);
+                    const qreal dx = (current.x() - x) / 2.0;
+                    const qreal dy = (current.y() - y) / 2.0;
+                    const qreal x1 = qCos(rad) * dx + qSin(rad) * dy;
+                    const qreal y1 = -qSin(rad) * dx + qCos(rad) * dy;
+                    const qreal lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+                    if (lambda > 1) {
+                        rx *= qSqrt(lambda);
+                        ry *= qSqrt(lambda);
+                    }
+                    // 起点在椭圆上，弧线整体位于“以起点为中心、两倍长半轴”的范围内
+                    const qreal r = qMax(rx, ry) * 2.0;
+                    include(current.x() - r, current.y() - r);
+                    include(current.x() + r, current.y() + r);
+                }
+                // 半径为0时弧线退化为直线
+                include(x, y);
+                current = QPointF(x, y);
+            }
+            break;
+        }
+        case 'Z':
+            current = subpathStart;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!hasPoint) return QRectF();
+    return QRectF(minX, minY, maxX - minX, maxY - minY);
+}
+
+SvgElementFactory::ParsedValue SvgElementFactory::parseValueWithUnit(QStringView str) {
     ParsedValue res = {0, "", false};
     if (str.isEmpty()) return res;
 
@@ -725,7 +1094,7 @@ SvgElementFactory::ParsedValue SvgElementFactory::parseValueWithUnit(const QStri
     while (i < str.size() && (str[i].isDigit() || str[i] == '.')) i++;
 
     // 提取数值
-    QString numStr = str.left(i).trimmed();
+    const QStringView numStr = str.left(i).trimmed();
     bool ok;
     res.value = numStr.toDouble(&ok);
     if (!ok) {
@@ -734,7 +1103,7 @@ SvgElementFactory::ParsedValue SvgElementFactory::parseValueWithUnit(const QStri
     }
 
     // 提取单位（默认px）
-    res.unit = str.mid(i).trimmed().toLower();
+    res.unit = str.mid(i).trimmed().toString().toLower();
     if (res.unit.isEmpty()) res.unit = "px";
     res.valid = true;
     return res;
@@ -759,11 +1128,11 @@ qreal SvgElementFactory::convertToPx(const ParsedValue& parsed, const QRectF& vi
     return px;
 }
 
-qreal SvgElementFactory::parseDoubleAttr(const QDomElement& elem, const QString& attrName,
+qreal SvgElementFactory::parseDoubleAttr(const SvgNodeSource& node, const char* attrName,
                                          const QRectF& viewBox, qreal defaultValue) {
-    if (!elem.hasAttribute(attrName)) return defaultValue;
+    if (!node.hasAttribute(attrName)) return defaultValue;
 
-    QString attrVal = elem.attribute(attrName).trimmed();
+    const QStringView attrVal = node.attribute(attrName).trimmed();
     ParsedValue parsed = parseValueWithUnit(attrVal);
     if (!parsed.valid) {
         qDebug() << "[警告] 解析属性失败：" << attrName << "=" << attrVal;
@@ -776,31 +1145,36 @@ qreal SvgElementFactory::parseDoubleAttr(const QDomElement& elem, const QString&
 }
 
 // 辅助函数：从字符串解析带单位的数值（如"50px"）
-qreal SvgElementFactory::parseDoubleAttrFromString(const QString& str, const QRectF& viewBox) {
+qreal SvgElementFactory::parseDoubleAttrFromString(QStringView str, const QRectF& viewBox) {
     ParsedValue parsed = parseValueWithUnit(str);
     return parsed.valid ? convertToPx(parsed, viewBox) : 0;
 }
 
-// 解析DOM元素的属性值（如elem.attribute("x")）
-qreal SvgElementFactory::parseDimensionAttr(const QDomElement& elem, const QString& attrName, qreal defaultValue) {
-    if (!elem.hasAttribute(attrName)) {
+// 解析元素的属性值（如node.attribute("x")）
+qreal SvgElementFactory::parseDimensionAttr(const SvgNodeSource& node, const char* attrName, qreal defaultValue) {
+    if (!node.hasAttribute(attrName)) {
         return defaultValue; // 属性不存在时返回默认值
     }
-    QString attrValue = elem.attribute(attrName).trimmed();
+    const QStringView attrValue = node.attribute(attrName).trimmed();
     return parseDimension(attrValue, defaultValue);
 }
 
 // 解析尺寸字符串（提取数值，忽略单位）
-qreal SvgElementFactory::parseDimension(const QString& dimStr, qreal defaultValue) {
+qreal SvgElementFactory::parseDimension(QStringView dimStr, qreal defaultValue) {
     if (dimStr.isEmpty()) {
         return defaultValue;
     }
-    // 正则表达式：匹配开头的数字（支持正负、小数）
-    QRegularExpression regex("^[-+]?\\d+(\\.\\d+)?");
-    QRegularExpressionMatch match = regex.match(dimStr);
-    if (match.hasMatch()) {
-        return match.captured(0).toDouble(); // 提取数值部分并转换为double
-    } else {
+    // 匹配开头的数字（支持正负、小数）
+    int i = 0;
+    if (dimStr[i] == u'+' || dimStr[i] == u'-') i++;
+    const int digitsStart = i;
+    while (i < dimStr.size() && dimStr[i].isDigit()) i++;
+    if (i == digitsStart) {
         return defaultValue; // 匹配失败返回默认值
     }
+    if (i + 1 < dimStr.size() && dimStr[i] == u'.' && dimStr[i + 1].isDigit()) {
+        i++;
+        while (i < dimStr.size() && dimStr[i].isDigit()) i++;
+    }
+    return dimStr.left(i).toDouble(); // 提取数值部分并转换为double
 }
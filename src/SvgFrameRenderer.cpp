@@ -0,0 +1,139 @@
+#include "SvgFrameRenderer.h"
+#include "SvgDocument.h"
+#include "SvgRenderer.h"
+#include "SvgDisplayList.h"
+#include "SvgRenderScheduler.h"
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+// 每个时间片的渲染预算（毫秒）：一帧内画不完时，每片结束上屏一次部分结果
+const qint64 kSliceBudget = 16;
+}
+
+SvgFrameRenderer::SvgFrameRenderer(QObject* parent)
+    : QObject(parent), mCancel(std::make_shared<QAtomicInt>(0))
+{
+    mPool.setMaxThreadCount(1);
+}
+
+SvgFrameRenderer::~SvgFrameRenderer()
+{
+    cancelAndWait();
+}
+
+bool SvgFrameRenderer::requestFrame(const SvgDocument* document, const QTransform& viewTransform, const QSize& size,
+                                    SvgRenderer::Quality quality)
+{
+    if (!document || size.isEmpty()) return false;
+
+    // 草稿：整帧缩小渲染，上屏时由帧变换放大回窗口尺寸
+    QSize frameSize = size;
+    QTransform frameTransform = viewTransform;
+    if (quality == SvgRenderer::QualityDraft) {
+        const qreal r = SvgRenderer::kDraftResolution;
+        frameSize = QSize(qMax(1, qCeil(size.width() * r)), qMax(1, qCeil(size.height() * r)));
+        frameTransform = viewTransform * QTransform::fromScale(r, r);
+    }
+
+    // 取消旧请求：运行中的在下一个元素处退出，排队中的开始时即返回
+    mCancel->storeRelaxed(1);
+    mCancel = std::make_shared<QAtomicInt>(0);
+
+    // 双缓冲：尺寸不变时复用上一帧的缓冲，避免每帧重新分配
+    QImage back = mSpare.size() == frameSize ? std::move(mSpare) : QImage(frameSize, QImage::Format_ARGB32_Premultiplied);
+    mSpare = QImage();
+
+    // 视图未变时以当前前台帧打底：尚未重绘的单元显示旧内容，部分结果上屏时不闪烁
+    QImage previous;
+    if (mFront.size() == frameSize && mFrontTransform == frameTransform) {
+        previous = mFront;
+    }
+
+    const quint64 serial = ++mSerial;
+    const std::shared_ptr<QAtomicInt> cancel = mCancel;
+    mInFlight.fetchAndAddOrdered(1);
+
+    mPool.start([this, document, frameTransform, quality, serial, cancel,
+                 back = std::move(back), previous]() mutable {
+        QElapsedTimer timer;
+        timer.start();
+        if (!cancel->loadRelaxed()) {
+            if (!previous.isNull()) {
+                std::memcpy(back.bits(), previous.constBits(), size_t(back.sizeInBytes()));
+            } else {
+                back.fill(Qt::transparent);
+            }
+
+            // 文档在isBusy()期间保持不变，编译得到的显示列表在本帧内有效
+            SvgDisplayList list;
+            list.compile(document);
+
+            // 按时间片增量渲染（中心优先），片与片之间上屏部分结果
+            SvgRenderScheduler scheduler;
+            scheduler.setAbortFlag(cancel.get());
+            scheduler.begin(&list, frameTransform, std::move(back), quality);
+            while (!scheduler.renderSlice(kSliceBudget)) {
+                if (cancel->loadRelaxed()) break;
+                const QImage partial = scheduler.image().copy();
+                QMetaObject::invokeMethod(this, [this, serial, partial, frameTransform]() {
+                    presentPartial(serial, partial, frameTransform);
+                }, Qt::QueuedConnection);
+            }
+            back = scheduler.takeImage();
+            if (scheduler.occludedItems() > 0) {
+                qDebug() << "遮挡剔除跳过的图元数量：" << scheduler.occludedItems();
+            }
+        }
+        const qint64 elapsed = timer.elapsed();
+
+        const bool completed = !cancel->loadRelaxed();
+        mInFlight.fetchAndSubOrdered(1);
+        if (!completed) return;
+
+        // 回到GUI线程交换缓冲（对象销毁前会等待线程池，this始终有效）
+        QMetaObject::invokeMethod(this, [this, serial, back, frameTransform, quality, elapsed]() {
+            present(serial, back, frameTransform, quality, elapsed);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void SvgFrameRenderer::cancelAndWait()
+{
+    mCancel->storeRelaxed(1);
+    mCancel = std::make_shared<QAtomicInt>(0);
+    ++mSerial;
+    mPool.waitForDone();
+}
+
+void SvgFrameRenderer::present(quint64 serial, const QImage& image, const QTransform& transform,
+                               SvgRenderer::Quality quality, qint64 elapsedMs)
+{
+    if (quality == SvgRenderer::QualityFull) {
+        mLastFullFrameTime = elapsedMs;
+    }
+    if (serial != mSerial) return;  // 已有更新的请求
+    mSpare = std::move(mFront);
+    mFront = image;
+    mFrontTransform = transform;
+    emit frameReady();
+}
+
+void SvgFrameRenderer::presentPartial(quint64 serial, const QImage& image, const QTransform& transform)
+{
+    if (serial != mSerial) return;
+    mFront = image;
+    mFrontTransform = transform;
+    emit frameReady();
+}
+
+void SvgFrameRenderer::clearFrame()
+{
+    mFront = QImage();
+    mSpare = QImage();
+    mFrontTransform = QTransform();
+}
@@ -0,0 +1,147 @@
+#include "SvgGeometryPool.h"
+#include <QMutexLocker>
+
+namespace {
+
+size_t contentHash(const SvgPathData& data)
+{
+    return qHashMulti(qHashRange(data.verbs().cbegin(), data.verbs().cend()),
+                      qHashRange(data.coords().cbegin(), data.coords().cend()));
+}
+
+size_t contentHash(const QPolygonF& points)
+{
+    size_t hash = qHash(points.size());
+    for (const QPointF& point : points) hash = qHashMulti(hash, point.x(), point.y());
+    return hash;
+}
+
+} // namespace
+
+SvgGeometryPool::SourceKey SvgGeometryPool::sourceKey(QStringView source)
+{
+    // 两个不同种子的哈希加上长度同时相同的不同文本可以忽略
+    static const size_t kCheckSeed = size_t(0x9e3779b97f4a7c15ULL);
+    return {qHash(source), qHash(source, kCheckSeed), source.size()};
+}
+
+template <typename Entry>
+const Entry* SvgGeometryPool::find(const QHash<size_t, QList<Keyed<Entry>>>& table, const SourceKey& key)
+{
+    auto it = table.constFind(key.hash);
+    if (it == table.cend()) return nullptr;
+    for (const Keyed<Entry>& keyed : *it) {
+        if (keyed.key.length == key.length && keyed.key.check == key.check) return &keyed.entry;
+    }
+    return nullptr;
+}
+
+SvgGeometryPool::PathEntry SvgGeometryPool::path(QStringView d, const std::function<PathEntry()>& parse)
+{
+    const SourceKey key = sourceKey(d);
+    {
+        QMutexLocker locker(&mMutex);
+        if (const PathEntry* entry = find(mPaths, key)) {
+            ++mStatistics.hits;
+            return *entry;
+        }
+        ++mStatistics.misses;
+    }
+    // 锁外解析；其他线程同时解析了同一d时以先登记者为准，保证全部引用同一份数据
+    const PathEntry parsed = parse();
+    QMutexLocker locker(&mMutex);
+    if (const PathEntry* entry = find(mPaths, key)) return *entry;
+    mPaths[key.hash].append(Keyed<PathEntry>{key, parsed});
+    return parsed;
+}
+
+SvgGeometryPool::PointsEntry SvgGeometryPool::points(QStringView text, const QRectF& viewBox,
+                                                      const std::function<PointsEntry()>& parse)
+{
+    const SourceKey key = sourceKey(text);
+    {
+        QMutexLocker locker(&mMutex);
+        const PointsEntry* entry = find(mPoints, key);
+        if (entry && entry->viewBox == viewBox) {
+            ++mStatistics.hits;
+            return *entry;
+        }
+        ++mStatistics.misses;
+    }
+    PointsEntry parsed = parse();
+    parsed.viewBox = viewBox;
+    QMutexLocker locker(&mMutex);
+    const PointsEntry* entry = find(mPoints, key);
+    if (entry && entry->viewBox == viewBox) return *entry;
+    // 同一文本在不同viewBox下解析的结果替换旧项，每个文本只保留一份
+    QList<Keyed<PointsEntry>>& bucket = mPoints[key.hash];
+    for (Keyed<PointsEntry>& keyed : bucket) {
+        if (keyed.key.length == key.length && keyed.key.check == key.check) {
+            keyed.entry = parsed;
+            return parsed;
+        }
+    }
+    bucket.append(Keyed<PointsEntry>{key, parsed});
+    return parsed;
+}
+
+SvgGeometryPool::LazyPathEntry SvgGeometryPool::lazyPath(QStringView d, const std::function<QRectF()>& estimate)
+{
+    // 懒加载项本身保存d字符串，命中时直接比较全文
+    const SourceKey key = sourceKey(d);
+    auto findSame = [this, &key, d]() -> const LazyPathEntry* {
+        const LazyPathEntry* entry = find(mLazyPaths, key);
+        return entry && entry->d == d ? entry : nullptr;
+    };
+    {
+        QMutexLocker locker(&mMutex);
+        if (const LazyPathEntry* entry = findSame()) {
+            ++mStatistics.hits;
+            return *entry;
+        }
+        ++mStatistics.misses;
+    }
+    const LazyPathEntry parsed{d.toString(), estimate()};
+    QMutexLocker locker(&mMutex);
+    if (const LazyPathEntry* entry = findSame()) return *entry;
+    mLazyPaths[key.hash].append(Keyed<LazyPathEntry>{key, parsed});
+    return parsed;
+}
+
+SvgPathData SvgGeometryPool::internPath(const SvgPathData& data)
+{
+    const size_t hash = contentHash(data);
+    QMutexLocker locker(&mMutex);
+    QList<SvgPathData>& bucket = mPathsByContent[hash];
+    for (const SvgPathData& existing : bucket) {
+        if (existing.verbs() == data.verbs() && existing.coords() == data.coords()) {
+            ++mStatistics.hits;
+            return existing;
+        }
+    }
+    ++mStatistics.misses;
+    bucket.append(data);
+    return data;
+}
+
+QPolygonF SvgGeometryPool::internPoints(const QPolygonF& points)
+{
+    const size_t hash = contentHash(points);
+    QMutexLocker locker(&mMutex);
+    QList<QPolygonF>& bucket = mPointsByContent[hash];
+    for (const QPolygonF& existing : bucket) {
+        if (existing == points) {
+            ++mStatistics.hits;
+            return existing;
+        }
+    }
+    ++mStatistics.misses;
+    bucket.append(points);
+    return points;
+}
+
+SvgGeometryPool::Statistics SvgGeometryPool::statistics() const
+{
+    QMutexLocker locker(&mMutex);
+    return mStatistics;
+}
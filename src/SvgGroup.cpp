@@ -1,6 +1,8 @@
 #include "SvgGroup.h"
 #include "SvgRenderer.h"
+#include "SvgTreeWalker.h"
 #include <QPainter>
+#include <QVector>
 
 SvgGroup::SvgGroup(const QString& id)
     : SvgElement(TypeGroup, id)
@@ -8,69 +10,161 @@ SvgGroup::SvgGroup(const QString& id)
 
 SvgGroup::~SvgGroup()
 {
-    // 释放所有子元素
-    qDeleteAll(mChildren);
-    mChildren.clear();
+    // 逐层递归析构在深层嵌套时会栈溢出：先摘下后代组的子元素放入工作表，
+    // 再逐个释放（被释放的组已没有子元素，析构不会再向下递归）
+    QList<SvgElement*> pending;
+    pending.swap(mChildren);
+    while (!pending.isEmpty()) {
+        SvgElement* element = pending.takeLast();
+        if (!element) continue;
+        if (element->type() == TypeGroup) {
+            auto* group = static_cast<SvgGroup*>(element);
+            pending.append(group->mChildren);
+            group->mChildren.clear();
+        }
+        delete element;
+    }
 }
 
-void SvgGroup::draw(SvgRenderer* renderer) const
+namespace {
+
+// 组绘制：子树按显式栈遍历。进入嵌套组时叠加其变换并保存画笔状态，离开时恢复；
+// 叶子与定义容器经由renderElement绘制（与逐层调用draw的结果相同）
+class DrawVisitor : public SvgTreeVisitor
 {
-    if (!renderer || !renderer->painter()) return;
+public:
+    DrawVisitor(const SvgGroup* root, SvgRenderer* renderer)
+        : mRoot(root), mRenderer(renderer), mPainter(renderer->painter()) {}
 
-    QPainter* painter = renderer->painter();
-    painter->save(); // 保存组之前的状态
+    bool enter(const SvgElement* element) override
+    {
+        if (element == mRoot) return true;   // 组自身的变换已由调用方应用
+        if (mRenderer->isAborted()) return false;  // 后台渲染已取消
+        if (element->type() == SvgElement::TypeGroup && static_cast<const SvgGroup*>(element)->isRendered()) {
+            if (!element->transform().isIdentity()) mRenderer->pushTransform(element->transform());
+            mPainter->save();
+            return true;
+        }
+        mRenderer->renderElement(element, mPainter);
+        return false;
+    }
+
+    void leave(const SvgElement* element) override
+    {
+        if (element == mRoot) return;
+        mPainter->restore();
+        if (!element->transform().isIdentity()) mRenderer->popTransform();
+    }
+
+private:
+    const SvgGroup* mRoot;
+    SvgRenderer* mRenderer;
+    QPainter* mPainter;
+};
 
-    // 应用组的变换（子元素会继承此变换）
-    const SvgTransform& groupTransform = this->transform();
-    if (!groupTransform.toQTransform().isIdentity()) {
-        painter->setTransform(groupTransform.toQTransform(), true);
+// 组包围盒：后序汇总，每个打开的组一个累加矩形；子元素的范围经其自身变换映射到父组坐标
+class BoundsVisitor : public SvgTreeVisitor
+{
+public:
+    explicit BoundsVisitor(const SvgGroup* root) : mRoot(root) {}
+
+    bool enter(const SvgElement* element) override
+    {
+        if (element == mRoot
+            || (element->type() == SvgElement::TypeGroup && static_cast<const SvgGroup*>(element)->isRendered())) {
+            mOpen.append(QRectF());
+            return true;
+        }
+        unite(element->boundingBox(), element);   // 叶子、<use>与定义容器使用各自的boundingBox
+        return false;
     }
 
-    // 绘制所有子元素
-    for (SvgElement* child : mChildren) {
-        if (child) {
-            child->draw(renderer);
+    void leave(const SvgElement* element) override
+    {
+        const QRectF bbox = mOpen.takeLast();
+        if (element == mRoot) {
+            mResult = bbox;
+        } else {
+            unite(bbox, element);
         }
     }
 
+    QRectF result() const { return mResult; }
+
+private:
+    void unite(const QRectF& local, const SvgElement* element)
+    {
+        const QRectF childBbox = element->transform().toQTransform().mapRect(local);
+        QRectF& groupBbox = mOpen.last();
+        groupBbox = groupBbox.isEmpty() ? childBbox : groupBbox.united(childBbox);
+    }
+
+    const SvgGroup* mRoot;
+    QVector<QRectF> mOpen;
+    QRectF mResult;
+};
+
+} // namespace
+
+void SvgGroup::draw(SvgRenderer* renderer) const
+{
+    if (!renderer || !renderer->painter()) return;
+
+    QPainter* painter = renderer->painter();
+    painter->save(); // 保存组之前的状态
+
+    // 组自身的变换已由调用方（renderElement）应用；嵌套组与子元素的变换各自叠加且只应用一次
+    DrawVisitor visitor(this, renderer);
+    SvgTreeWalker::walk(this, &visitor);
+
     painter->restore(); // 恢复状态
 }
 
 QRectF SvgGroup::boundingBox() const
 {
-    QRectF groupBbox;
-    // 合并所有子元素的边界框
-    for (SvgElement* child : mChildren) {
-        if (child) {
-            QRectF childBbox = child->boundingBox();
-            // 应用子元素的变换到边界框
-            const SvgTransform& childTransform = child->transform();
-            childBbox = childTransform.toQTransform().mapRect(childBbox);
-
-            if (groupBbox.isEmpty()) {
-                groupBbox = childBbox;
-            } else {
-                groupBbox = groupBbox.united(childBbox);
-            }
-        }
-    }
-    return groupBbox;
+    // 合并所有子元素的边界框（嵌套组逐层应用子元素的变换）
+    BoundsVisitor visitor(this);
+    SvgTreeWalker::walk(this, &visitor);
+    return visitor.result();
 }
 
 void SvgGroup::addChild(SvgElement* child)
 {
-    if (child && !mChildren.contains(child)) {
+    // 已在本组中的子元素父指针即为本组（免去宽组逐个添加时的线性查找）。
+    // 组的boundingBox()按子元素实时计算，添加时不合并子元素范围
+    //（子元素是组或<use>时那会遍历整棵子树，逐层构建深层嵌套的树就成了平方复杂度）
+    if (child && child->parent() != this) {
         mChildren.append(child);
-        // 更新组边界框
-        setBoundingBox(boundingBox());
+        child->setParent(this);
     }
 }
 
+void SvgGroup::insertChild(int index, SvgElement* child)
+{
+    if (!child || child->parent() == this) return;
+    if (index < 0 || index > mChildren.size()) index = mChildren.size();
+    mChildren.insert(index, child);
+    child->setParent(this);
+}
+
 void SvgGroup::removeChild(SvgElement* child)
 {
-    if (child) {
-        mChildren.removeAll(child);
+    if (takeChild(child)) {
         delete child; // 移除时释放子元素
-        setBoundingBox(boundingBox());
     }
 }
+
+void SvgGroup::setChildren(const QList<SvgElement*>& children)
+{
+    for (SvgElement* child : mChildren) child->setParent(nullptr);
+    mChildren = children;
+    for (SvgElement* child : mChildren) child->setParent(this);
+    // 组的boundingBox()按子元素实时计算，这里不逐个合并
+}
+
+bool SvgGroup::takeChild(SvgElement* child)
+{
+    if (!child || !mChildren.removeAll(child)) return false;
+    child->setParent(nullptr);
+    return true;
+}
@@ -0,0 +1,110 @@
+#include "SvgGzipDevice.h"
+#include <QDebug>
+#include <zlib.h>
+#include <limits>
+
+namespace {
+const qint64 kInputChunkSize = 64 * 1024;  // 每次从数据源读取的压缩块大小
+}
+
+SvgGzipDevice::SvgGzipDevice(QIODevice* source)
+    : mSource(source), mStream(new z_stream)
+{
+}
+
+SvgGzipDevice::~SvgGzipDevice()
+{
+    close();
+    delete mStream;
+}
+
+bool SvgGzipDevice::isGzipData(const QByteArray& head)
+{
+    return head.size() >= 2
+           && static_cast<unsigned char>(head[0]) == 0x1f
+           && static_cast<unsigned char>(head[1]) == 0x8b;
+}
+
+bool SvgGzipDevice::open(OpenMode mode)
+{
+    if ((mode & QIODevice::WriteOnly) || !mSource || !mSource->isReadable()) {
+        setErrorString("gzip设备只支持读取");
+        return false;
+    }
+
+    *mStream = z_stream();
+    // 16 + MAX_WBITS：只接受gzip头格式
+    if (inflateInit2(mStream, 16 + MAX_WBITS) != Z_OK) {
+        setErrorString("zlib初始化失败");
+        return false;
+    }
+    mInput.clear();
+    mFinished = false;
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+void SvgGzipDevice::close()
+{
+    if (!isOpen()) return;
+    inflateEnd(mStream);
+    mInput.clear();
+    QIODevice::close();
+}
+
+bool SvgGzipDevice::atEnd() const
+{
+    return mFinished && QIODevice::atEnd();
+}
+
+qint64 SvgGzipDevice::readData(char* data, qint64 maxSize)
+{
+    if (mFinished || maxSize <= 0) return 0;
+
+    mStream->next_out = reinterpret_cast<Bytef*>(data);
+    mStream->avail_out = static_cast<uInt>(qMin<qint64>(maxSize, std::numeric_limits<uInt>::max()));
+
+    while (mStream->avail_out > 0) {
+        // 输入耗尽时从数据源补充下一块
+        if (mStream->avail_in == 0) {
+            if (mSource->atEnd()) {
+                if (mStream->next_out == reinterpret_cast<Bytef*>(data)) {
+                    setErrorString("gzip数据不完整");
+                    qDebug() << "gzip数据提前结束";
+                    mFinished = true;
+                    return -1;
+                }
+                break;
+            }
+            mInput = mSource->read(kInputChunkSize);
+            if (mInput.isEmpty()) break;
+            mStream->next_in = reinterpret_cast<Bytef*>(mInput.data());
+            mStream->avail_in = static_cast<uInt>(mInput.size());
+        }
+
+        const int ret = inflate(mStream, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            // 支持多成员gzip（多个压缩段首尾相接）
+            if (mStream->avail_in > 0 || !mSource->atEnd()) {
+                inflateReset(mStream);
+                continue;
+            }
+            mFinished = true;
+            break;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            setErrorString(QString("gzip解压失败：%1").arg(mStream->msg ? mStream->msg : "未知错误"));
+            qDebug() << errorString();
+            mFinished = true;
+            return -1;
+        }
+    }
+
+    return reinterpret_cast<char*>(mStream->next_out) - data;
+}
+
+qint64 SvgGzipDevice::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
@@ -0,0 +1,191 @@
+#include "SvgLayerCache.h"
+#include "SvgDisplayList.h"
+#include "SvgDocument.h"
+#include "SvgGroup.h"
+#include <QHash>
+#include <QSet>
+#include <QtMath>
+#include <QDebug>
+
+namespace {
+
+bool scaleMatches(qreal layerScale, qreal scale)
+{
+    return layerScale > 0 && qAbs(scale / layerScale - 1.0) <= SvgLayerCache::kScaleTolerance;
+}
+
+} // namespace
+
+void SvgLayerCache::clear()
+{
+    mEntries.clear();
+    mBytes = 0;
+}
+
+void SvgLayerCache::cancelPending()
+{
+    for (Entry& entry : mEntries) entry.pending = false;
+}
+
+bool SvgLayerCache::isEnabled(const Entry& entry) const
+{
+    if (!entry.cacheable) return false;
+    return entry.group->layerHint() == SvgGroup::LayerStatic || entry.unchangedRenders >= kStableRenders;
+}
+
+QRectF SvgLayerCache::rangeBounds(const SvgDisplayList& list, int first, int end)
+{
+    const QVector<SvgDisplayItem>& items = list.items();
+    QRectF bounds;
+    for (int i = first; i < end; ++i) {
+        bounds = bounds.isEmpty() ? items.at(i).bounds : bounds.united(items.at(i).bounds);
+    }
+    return bounds;
+}
+
+void SvgLayerCache::dropImage(Entry* entry)
+{
+    mBytes -= entry->image.sizeInBytes();
+    entry->image = QImage();
+    entry->scale = 0;
+}
+
+void SvgLayerCache::rebuild(const SvgDisplayList& list)
+{
+    QHash<const SvgGroup*, Entry> previous;
+    for (const Entry& entry : mEntries) previous.insert(entry.group, entry);
+    mEntries.clear();
+    mBytes = 0;
+
+    const QVector<SvgDisplayItem>& items = list.items();
+    for (const SvgDisplayGroup& range : list.groups()) {
+        Entry entry;
+        entry.group = range.group;
+        entry.first = range.first;
+        entry.end = range.end;
+        entry.bounds = rangeBounds(list, range.first, range.end);
+        size_t hash = qHash(range.end - range.first);
+        for (int i = range.first; i < range.end; ++i) {
+            const SvgElement* element = items.at(i).element;
+            hash = qHashMulti(hash, element);
+            if (element->type() == SvgElement::TypeText) entry.cacheable = false;
+        }
+        entry.signature = hash;
+
+        // 区间内图元不变的组沿用图像与稳定计数（图元下标可能整体平移，图像与下标无关）
+        auto it = previous.constFind(range.group);
+        if (it != previous.cend() && it->signature == hash) {
+            entry.unchangedRenders = it->unchangedRenders;
+            entry.image = it->image;
+            entry.scale = it->scale;
+            entry.origin = it->origin;
+            mBytes += entry.image.sizeInBytes();
+        }
+        mEntries.append(entry);
+    }
+}
+
+void SvgLayerCache::invalidate(const SvgDocumentChange& change, const SvgDisplayList& list)
+{
+    QVector<const SvgElement*> changed = change.instances;
+    if (change.element) changed.append(change.element);
+    if (changed.isEmpty()) return;
+
+    // 被修改元素及其祖先：其中的组包含了修改；组自身的祖先中有被修改元素时，组的累积变换可能变化
+    QSet<const SvgElement*> touched;
+    for (const SvgElement* element : changed) {
+        for (const SvgElement* e = element; e && !touched.contains(e); e = e->parent()) {
+            touched.insert(e);
+        }
+    }
+    const QSet<const SvgElement*> modified(changed.cbegin(), changed.cend());
+
+    int invalidated = 0;
+    for (Entry& entry : mEntries) {
+        bool affected = touched.contains(entry.group);
+        for (const SvgElement* e = entry.group; e && !affected; e = e->parent()) {
+            affected = modified.contains(e);
+        }
+        if (!affected) continue;
+        if (!entry.image.isNull()) ++invalidated;
+        dropImage(&entry);
+        entry.unchangedRenders = 0;
+        entry.bounds = rangeBounds(list, entry.first, entry.end);
+    }
+    if (invalidated > 0) qDebug() << "编辑触及已缓存的图层，失效图层数量：" << invalidated;
+}
+
+void SvgLayerCache::documentChanged(const SvgDocumentChange& change, const SvgDisplayList& list)
+{
+    // 结构变化时显示列表已重新编译：图元不同的组在重建时即失去图像；插入的子树再按祖先失效一次
+    if (change.kind != SvgDocumentChange::ElementChanged) rebuild(list);
+    invalidate(change, list);
+}
+
+QVector<SvgLayerRequest> SvgLayerCache::takeRequests(qreal scale, const QRectF& rect)
+{
+    QVector<SvgLayerRequest> requests;
+    int covered = -1;   // 外层已有（或即将有）图层时，内层不必再栅格化
+    for (Entry& entry : mEntries) {
+        // 每次分块渲染计数一次：与分块相交的组在这次渲染中未被修改
+        const bool visible = !entry.bounds.isEmpty() && entry.bounds.intersects(rect);
+        if (visible && entry.unchangedRenders < kStableRenders) ++entry.unchangedRenders;
+
+        if (entry.first < covered || !isEnabled(entry)) continue;
+        if (entry.pending || (!entry.image.isNull() && scaleMatches(entry.scale, scale))) {
+            covered = entry.end;
+            continue;
+        }
+        if (!visible) continue;
+        const QRectF& bounds = entry.bounds;
+
+        // 向外对齐到整像素并留1像素抗锯齿余量，同一缩放下分块与图层的像素网格一致
+        const QPoint origin(qFloor(bounds.left() * scale) - 1, qFloor(bounds.top() * scale) - 1);
+        const QSize size(qCeil(bounds.right() * scale) + 1 - origin.x(),
+                         qCeil(bounds.bottom() * scale) + 1 - origin.y());
+        const qint64 pixels = qint64(size.width()) * size.height();
+        if (pixels > kMaxLayerPixels) continue;
+        if (mBytes - entry.image.sizeInBytes() + pixels * 4 > mMaxBytes) continue;
+
+        entry.pending = true;
+        covered = entry.end;
+        requests.append({entry.group, entry.first, entry.end, scale, origin, size});
+    }
+    return requests;
+}
+
+void SvgLayerCache::storeLayer(const SvgLayerRequest& request, const QImage& image)
+{
+    for (Entry& entry : mEntries) {
+        if (entry.group != request.group || entry.first != request.first || entry.end != request.end) continue;
+        if (!entry.pending) return;   // 请求已取消，或内容已变化
+        entry.pending = false;
+        dropImage(&entry);
+        entry.image = image;
+        entry.scale = request.scale;
+        entry.origin = request.origin;
+        mBytes += image.sizeInBytes();
+        qDebug() << "图层已栅格化：" << image.size() << "，代替图元数量：" << entry.end - entry.first
+                 << "，图层总字节：" << mBytes;
+        return;
+    }
+}
+
+QVector<SvgLayerImage> SvgLayerCache::layers(qreal scale) const
+{
+    QVector<SvgLayerImage> result;
+    int covered = -1;
+    for (const Entry& entry : mEntries) {
+        if (entry.first < covered || entry.image.isNull() || !scaleMatches(entry.scale, scale)) continue;
+        if (!isEnabled(entry)) continue;
+        SvgLayerImage layer;
+        layer.first = entry.first;
+        layer.end = entry.end;
+        layer.image = entry.image;
+        layer.transform.translate(-entry.origin.x(), -entry.origin.y());
+        layer.transform.scale(entry.scale, entry.scale);
+        result.append(layer);
+        covered = entry.end;
+    }
+    return result;
+}
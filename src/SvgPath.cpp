@@ -1,18 +1,141 @@
 #include "SvgPath.h"
 #include "SvgRenderer.h"
+#include "SvgElementFactory.h"
 #include <QPainter>
+#include <QMutexLocker>
 #include <QDebug>
 
+QAtomicInteger<qint64> SvgPath::sMaterializedBytes(0);
+
+SvgPath::~SvgPath()
+{
+    QMutexLocker locker(&mMutex);
+    dropPainterPath();
+    forgetMaterialized();
+}
+
+void SvgPath::setPath(const QPainterPath& path)
+{
+    setGeometry(SvgPathData::fromPainterPath(path));
+}
+
+void SvgPath::setGeometry(const SvgPathData& data)
+{
+    setGeometry(data, data.bounds());
+}
+
+void SvgPath::setGeometry(const SvgPathData& data, const QRectF& bounds)
+{
+    QMutexLocker locker(&mMutex);
+    dropPainterPath();
+    forgetMaterialized();
+    mData = data;
+    mBounds = bounds;
+    mPathData.clear();
+    mPathLoaded = true;
+}
+
+void SvgPath::setPathData(const QString& d)
+{
+    QMutexLocker locker(&mMutex);
+    dropPainterPath();
+    forgetMaterialized();
+    mPathData = d;
+    mData = SvgPathData();
+    mBounds = QRectF();
+    mPathLoaded = d.isEmpty();
+}
+
+void SvgPath::ensureLoaded() const
+{
+    if (!mPathLoaded) {
+        mData = SvgPathData::fromPainterPath(SvgElementFactory::parsePathData(mPathData));
+        mBounds = mData.bounds();
+        mPathLoaded = true;
+        mMaterialized = mData.memoryUsage();
+        sMaterializedBytes.fetchAndAddRelaxed(mMaterialized);
+    }
+}
+
+qint64 SvgPath::forgetMaterialized() const
+{
+    const qint64 bytes = mMaterialized;
+    if (bytes > 0) sMaterializedBytes.fetchAndSubRelaxed(bytes);
+    mMaterialized = 0;
+    return bytes;
+}
+
+qint64 SvgPath::dropPainterPath() const
+{
+    if (!mPainterPathCached) return 0;
+    const qint64 bytes = mPainterPathBytes;
+    sMaterializedBytes.fetchAndSubRelaxed(bytes);
+    mPainterPath = QPainterPath();
+    mPainterPathBytes = 0;
+    mPainterPathCached = false;
+    return bytes;
+}
+
+QPainterPath SvgPath::path() const
+{
+    QMutexLocker locker(&mMutex);
+    if (!mPainterPathCached) {
+        // 首次绘制时由紧凑几何转换一次，之后各次绘制共享同一份（隐式共享，返回时不复制）
+        ensureLoaded();
+        mPainterPath = mData.toPainterPath();
+        mPainterPathBytes = qint64(mPainterPath.elementCount()) * qint64(sizeof(QPainterPath::Element));
+        mPainterPathCached = true;
+        sMaterializedBytes.fetchAndAddRelaxed(mPainterPathBytes);
+    }
+    return mPainterPath;
+}
+
+SvgPathData SvgPath::geometry() const
+{
+    QMutexLocker locker(&mMutex);
+    ensureLoaded();
+    return mData;
+}
+
+QRectF SvgPath::boundingBox() const
+{
+    QMutexLocker locker(&mMutex);
+    if (mPathLoaded && !mData.isEmpty()) {
+        return mBounds;
+    }
+    return mBoundingBox;
+}
+
+bool SvgPath::isGeometryLoaded() const
+{
+    QMutexLocker locker(&mMutex);
+    return mPathLoaded;
+}
+
+qint64 SvgPath::releaseGeometry() const
+{
+    QMutexLocker locker(&mMutex);
+    const qint64 released = dropPainterPath();
+    if (mPathData.isEmpty() || !mPathLoaded) return released;
+    mData = SvgPathData();
+    mBounds = QRectF();
+    mPathLoaded = false;
+    return released + forgetMaterialized();
+}
+
 void SvgPath::draw(SvgRenderer* renderer) const {
     if (!renderer || !renderer->painter()) return;
     QPainter* painter = renderer->painter();
 
+    // 紧凑几何在首次绘制时转换为QPainterPath并缓存（懒加载路径在此处首次生成几何）
+    const QPainterPath painterPath = path();
+
     // 应用样式
     const SvgStyle& style = this->style();
     style.applyToPainter(painter, false);
-    qDebug() << "绘制路径：路径段数量=" << mPath.elementCount()
+    qDebug() << "绘制路径：路径段数量=" << painterPath.elementCount()
              << "填充：" << style.fill().name() << "描边：" << style.stroke().name();
 
     // 绘制路径
-    painter->drawPath(mPath);
+    painter->drawPath(painterPath);
 }
@@ -0,0 +1,257 @@
+#include "SvgPathData.h"
+#include <QtMath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SVG_PATH_DATA_SSE2
+#endif
+
+namespace {
+
+// 仿射变换交错排列的坐标：x' = m11*x + m21*y + dx，y' = m12*x + m22*y + dy
+void transformCoords(float* coords, int count,
+                     float m11, float m12, float m21, float m22, float dx, float dy)
+{
+    int i = 0;
+#ifdef SVG_PATH_DATA_SSE2
+    // 每次处理2个点（4个float）：[x0 y0 x1 y1]
+    const __m128 colX = _mm_setr_ps(m11, m12, m11, m12);
+    const __m128 colY = _mm_setr_ps(m21, m22, m21, m22);
+    const __m128 offset = _mm_setr_ps(dx, dy, dx, dy);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v = _mm_loadu_ps(coords + i);
+        const __m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, colX), _mm_mul_ps(yy, colY)), offset);
+        _mm_storeu_ps(coords + i, r);
+    }
+#endif
+    for (; i + 2 <= count; i += 2) {
+        const float x = coords[i];
+        const float y = coords[i + 1];
+        coords[i] = m11 * x + m21 * y + dx;
+        coords[i + 1] = m12 * x + m22 * y + dy;
+    }
+}
+
+// 交错坐标的最小/最大值：out = {minX, minY, maxX, maxY}
+void coordBounds(const float* coords, int count, float out[4])
+{
+    float minX = std::numeric_limits<float>::max();
+    float minY = minX;
+    float maxX = -minX;
+    float maxY = -minX;
+    int i = 0;
+#ifdef SVG_PATH_DATA_SSE2
+    if (count >= 4) {
+        __m128 vmin = _mm_loadu_ps(coords);
+        __m128 vmax = vmin;
+        for (i = 4; i + 4 <= count; i += 4) {
+            const __m128 v = _mm_loadu_ps(coords + i);
+            vmin = _mm_min_ps(vmin, v);
+            vmax = _mm_max_ps(vmax, v);
+        }
+        // 合并两个点位：lane0/2为x，lane1/3为y
+        vmin = _mm_min_ps(vmin, _mm_movehl_ps(vmin, vmin));
+        vmax = _mm_max_ps(vmax, _mm_movehl_ps(vmax, vmax));
+        float lo[4], hi[4];
+        _mm_storeu_ps(lo, vmin);
+        _mm_storeu_ps(hi, vmax);
+        minX = lo[0];
+        minY = lo[1];
+        maxX = hi[0];
+        maxY = hi[1];
+    }
+#endif
+    for (; i + 2 <= count; i += 2) {
+        minX = qMin(minX, coords[i]);
+        maxX = qMax(maxX, coords[i]);
+        minY = qMin(minY, coords[i + 1]);
+        maxY = qMax(maxY, coords[i + 1]);
+    }
+    out[0] = minX;
+    out[1] = minY;
+    out[2] = maxX;
+    out[3] = maxY;
+}
+
+// 三次贝塞尔在单个坐标轴上的极值（导数为0处），并入[lo, hi]
+void cubicAxisExtrema(qreal p0, qreal p1, qreal p2, qreal p3, qreal& lo, qreal& hi)
+{
+    // B'(t)/3 = a*t^2 + b*t + c
+    const qreal a = -p0 + 3 * p1 - 3 * p2 + p3;
+    const qreal b = 2 * (p0 - 2 * p1 + p2);
+    const qreal c = p1 - p0;
+
+    qreal roots[2];
+    int rootCount = 0;
+    if (qFuzzyIsNull(a)) {
+        if (!qFuzzyIsNull(b)) roots[rootCount++] = -c / b;
+    } else {
+        const qreal disc = b * b - 4 * a * c;
+        if (disc >= 0) {
+            const qreal sq = qSqrt(disc);
+            roots[rootCount++] = (-b + sq) / (2 * a);
+            roots[rootCount++] = (-b - sq) / (2 * a);
+        }
+    }
+
+    for (int i = 0; i < rootCount; ++i) {
+        const qreal t = roots[i];
+        if (t <= 0 || t >= 1) continue;
+        const qreal mt = 1 - t;
+        const qreal v = mt * mt * mt * p0 + 3 * mt * mt * t * p1 + 3 * mt * t * t * p2 + t * t * t * p3;
+        lo = qMin(lo, v);
+        hi = qMax(hi, v);
+    }
+}
+
+} // namespace
+
+SvgPathData SvgPathData::fromPainterPath(const QPainterPath& path)
+{
+    SvgPathData data;
+    const int count = path.elementCount();
+    data.mVerbs.reserve(count);
+    data.mCoords.reserve(count * 2);
+
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element& e = path.elementAt(i);
+        switch (e.type) {
+        case QPainterPath::MoveToElement:
+            data.moveTo(e.x, e.y);
+            break;
+        case QPainterPath::LineToElement:
+            data.lineTo(e.x, e.y);
+            break;
+        case QPainterPath::CurveToElement:
+            // CurveTo后紧跟两个CurveToData：控制点2与终点
+            if (i + 2 < count) {
+                const QPainterPath::Element& c2 = path.elementAt(i + 1);
+                const QPainterPath::Element& end = path.elementAt(i + 2);
+                data.cubicTo(e.x, e.y, c2.x, c2.y, end.x, end.y);
+                i += 2;
+            }
+            break;
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+    data.mVerbs.squeeze();
+    data.mCoords.squeeze();
+    return data;
+}
+
+SvgPathData SvgPathData::fromArrays(const QVector<quint8>& verbs, const QVector<float>& coords)
+{
+    int expected = 0;
+    for (quint8 verb : verbs) {
+        if (verb > CubicTo) return SvgPathData();
+        expected += verb == CubicTo ? 6 : 2;
+    }
+    if (expected != coords.size()) return SvgPathData();
+
+    SvgPathData data;
+    data.mVerbs = verbs;
+    data.mCoords = coords;
+    return data;
+}
+
+QPainterPath SvgPathData::toPainterPath() const
+{
+    QPainterPath path;
+    path.reserve(mCoords.size() / 2);
+    const float* c = mCoords.constData();
+    for (quint8 verb : mVerbs) {
+        switch (verb) {
+        case MoveTo:
+            path.moveTo(c[0], c[1]);
+            c += 2;
+            break;
+        case LineTo:
+            path.lineTo(c[0], c[1]);
+            c += 2;
+            break;
+        case CubicTo:
+            path.cubicTo(c[0], c[1], c[2], c[3], c[4], c[5]);
+            c += 6;
+            break;
+        }
+    }
+    return path;
+}
+
+void SvgPathData::moveTo(qreal x, qreal y)
+{
+    mVerbs.append(MoveTo);
+    mCoords << float(x) << float(y);
+}
+
+void SvgPathData::lineTo(qreal x, qreal y)
+{
+    mVerbs.append(LineTo);
+    mCoords << float(x) << float(y);
+}
+
+void SvgPathData::cubicTo(qreal c1x, qreal c1y, qreal c2x, qreal c2y, qreal x, qreal y)
+{
+    mVerbs.append(CubicTo);
+    mCoords << float(c1x) << float(c1y) << float(c2x) << float(c2y) << float(x) << float(y);
+}
+
+void SvgPathData::transform(const QTransform& matrix)
+{
+    if (matrix.isIdentity() || mCoords.isEmpty()) return;
+    transformCoords(mCoords.data(), mCoords.size(),
+                    float(matrix.m11()), float(matrix.m12()),
+                    float(matrix.m21()), float(matrix.m22()),
+                    float(matrix.dx()), float(matrix.dy()));
+}
+
+QRectF SvgPathData::controlBounds() const
+{
+    if (mCoords.isEmpty()) return QRectF();
+    float b[4];
+    coordBounds(mCoords.constData(), mCoords.size(), b);
+    return QRectF(QPointF(b[0], b[1]), QPointF(b[2], b[3]));
+}
+
+QRectF SvgPathData::bounds() const
+{
+    if (mCoords.isEmpty()) return QRectF();
+
+    // 无曲线时控制点即轮廓点，直接走向量化的最小/最大值
+    if (!mVerbs.contains(CubicTo)) {
+        return controlBounds();
+    }
+
+    // 有曲线：只取线段端点，曲线额外求极值
+    const float* c = mCoords.constData();
+    qreal minX = c[0], maxX = c[0], minY = c[1], maxY = c[1];
+    qreal lastX = c[0], lastY = c[1];
+    for (quint8 verb : mVerbs) {
+        if (verb == CubicTo) {
+            cubicAxisExtrema(lastX, c[0], c[2], c[4], minX, maxX);
+            cubicAxisExtrema(lastY, c[1], c[3], c[5], minY, maxY);
+            lastX = c[4];
+            lastY = c[5];
+            c += 6;
+        } else {
+            lastX = c[0];
+            lastY = c[1];
+            c += 2;
+        }
+        minX = qMin(minX, lastX);
+        maxX = qMax(maxX, lastX);
+        minY = qMin(minY, lastY);
+        maxY = qMax(maxY, lastY);
+    }
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+qsizetype SvgPathData::memoryUsage() const
+{
+    return mVerbs.capacity() * qsizetype(sizeof(quint8))
+           + mCoords.capacity() * qsizetype(sizeof(float));
+}
@@ -0,0 +1,349 @@
+#include "SvgPointKernels.h"
+#include <QDebug>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SVG_POINT_KERNELS_SIMD 1
+#define SVG_POINT_KERNELS_AVX2 1
+#define SVG_TARGET_SSE2 __attribute__((target("sse2")))
+#define SVG_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define SVG_POINT_KERNELS_SIMD 1
+#define SVG_TARGET_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// 仿射部分：x' = m11·x + m21·y + dx，y' = m12·x + m22·y + dy（与QTransform::map的运算顺序一致）
+struct Affine
+{
+    double m11, m12, m21, m22, dx, dy;
+};
+
+Affine affineOf(const QTransform& transform)
+{
+    return {transform.m11(), transform.m12(), transform.m21(), transform.m22(), transform.dx(), transform.dy()};
+}
+
+using MapFunction = void (*)(const Affine& m, const QPointF* src, QPointF* dst, qsizetype count);
+using BoundsFunction = void (*)(const QPointF* src, qsizetype count, double* lo, double* hi);
+using MappedBoundsFunction = void (*)(const Affine& m, const QPointF* src, qsizetype count, double* lo, double* hi);
+
+// 标量实现逐个读取QPointF的x()/y()，不依赖QPointF的内存布局（qreal为float的构建也使用它）
+inline void mapPoint(const Affine& m, const QPointF& p, double* out)
+{
+    const double x = p.x();
+    const double y = p.y();
+    out[0] = m.m11 * x + m.m21 * y + m.dx;
+    out[1] = m.m12 * x + m.m22 * y + m.dy;
+}
+
+inline void includePoint(double x, double y, double* lo, double* hi)
+{
+    lo[0] = x < lo[0] ? x : lo[0];
+    hi[0] = x > hi[0] ? x : hi[0];
+    lo[1] = y < lo[1] ? y : lo[1];
+    hi[1] = y > hi[1] ? y : hi[1];
+}
+
+void mapScalar(const Affine& m, const QPointF* src, QPointF* dst, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        double p[2];
+        mapPoint(m, src[i], p);
+        dst[i] = QPointF(p[0], p[1]);
+    }
+}
+
+void boundsScalar(const QPointF* src, qsizetype count, double* lo, double* hi)
+{
+    lo[0] = hi[0] = src[0].x();
+    lo[1] = hi[1] = src[0].y();
+    for (qsizetype i = 1; i < count; ++i) {
+        includePoint(src[i].x(), src[i].y(), lo, hi);
+    }
+}
+
+void mappedBoundsScalar(const Affine& m, const QPointF* src, qsizetype count, double* lo, double* hi)
+{
+    double p[2];
+    mapPoint(m, src[0], p);
+    lo[0] = hi[0] = p[0];
+    lo[1] = hi[1] = p[1];
+    for (qsizetype i = 1; i < count; ++i) {
+        mapPoint(m, src[i], p);
+        includePoint(p[0], p[1], lo, hi);
+    }
+}
+
+#ifdef SVG_POINT_KERNELS_SIMD
+
+// SIMD实现把点数组按x、y交错的double数组读写，只在qreal为double时选用（见selectKernels）
+template <void (*Kernel)(const Affine&, const double*, double*, qsizetype)>
+void mapInterleaved(const Affine& m, const QPointF* src, QPointF* dst, qsizetype count)
+{
+    Kernel(m, reinterpret_cast<const double*>(src), reinterpret_cast<double*>(dst), count);
+}
+
+template <void (*Kernel)(const double*, qsizetype, double*, double*)>
+void boundsInterleaved(const QPointF* src, qsizetype count, double* lo, double* hi)
+{
+    Kernel(reinterpret_cast<const double*>(src), count, lo, hi);
+}
+
+template <void (*Kernel)(const Affine&, const double*, qsizetype, double*, double*)>
+void mappedBoundsInterleaved(const Affine& m, const QPointF* src, qsizetype count, double* lo, double* hi)
+{
+    Kernel(m, reinterpret_cast<const double*>(src), count, lo, hi);
+}
+
+// SSE2：一个寄存器放一个点(x, y)，x、y分别广播后与矩阵的两列相乘
+SVG_TARGET_SSE2 inline __m128d mapPointSse2(__m128d p, __m128d a, __m128d b, __m128d d)
+{
+    const __m128d xx = _mm_unpacklo_pd(p, p);
+    const __m128d yy = _mm_unpackhi_pd(p, p);
+    return _mm_add_pd(_mm_add_pd(_mm_mul_pd(xx, a), _mm_mul_pd(yy, b)), d);
+}
+
+SVG_TARGET_SSE2 void mapSse2(const Affine& m, const double* src, double* dst, qsizetype count)
+{
+    const __m128d a = _mm_setr_pd(m.m11, m.m12);
+    const __m128d b = _mm_setr_pd(m.m21, m.m22);
+    const __m128d d = _mm_setr_pd(m.dx, m.dy);
+    for (qsizetype i = 0; i < count; ++i) {
+        _mm_storeu_pd(dst + 2 * i, mapPointSse2(_mm_loadu_pd(src + 2 * i), a, b, d));
+    }
+}
+
+SVG_TARGET_SSE2 void boundsSse2(const double* src, qsizetype count, double* lo, double* hi)
+{
+    // 两组累加器交替使用，缩短min/max的依赖链
+    __m128d lo0 = _mm_loadu_pd(src);
+    __m128d hi0 = lo0;
+    __m128d lo1 = lo0;
+    __m128d hi1 = lo0;
+    qsizetype i = 1;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d p0 = _mm_loadu_pd(src + 2 * i);
+        const __m128d p1 = _mm_loadu_pd(src + 2 * i + 2);
+        lo0 = _mm_min_pd(lo0, p0);
+        hi0 = _mm_max_pd(hi0, p0);
+        lo1 = _mm_min_pd(lo1, p1);
+        hi1 = _mm_max_pd(hi1, p1);
+    }
+    if (i < count) {
+        const __m128d p = _mm_loadu_pd(src + 2 * i);
+        lo0 = _mm_min_pd(lo0, p);
+        hi0 = _mm_max_pd(hi0, p);
+    }
+    _mm_storeu_pd(lo, _mm_min_pd(lo0, lo1));
+    _mm_storeu_pd(hi, _mm_max_pd(hi0, hi1));
+}
+
+SVG_TARGET_SSE2 void mappedBoundsSse2(const Affine& m, const double* src, qsizetype count, double* lo, double* hi)
+{
+    const __m128d a = _mm_setr_pd(m.m11, m.m12);
+    const __m128d b = _mm_setr_pd(m.m21, m.m22);
+    const __m128d d = _mm_setr_pd(m.dx, m.dy);
+    __m128d low = mapPointSse2(_mm_loadu_pd(src), a, b, d);
+    __m128d high = low;
+    for (qsizetype i = 1; i < count; ++i) {
+        const __m128d p = mapPointSse2(_mm_loadu_pd(src + 2 * i), a, b, d);
+        low = _mm_min_pd(low, p);
+        high = _mm_max_pd(high, p);
+    }
+    _mm_storeu_pd(lo, low);
+    _mm_storeu_pd(hi, high);
+}
+
+#endif // SVG_POINT_KERNELS_SIMD
+
+#ifdef SVG_POINT_KERNELS_AVX2
+
+// AVX2：一个寄存器放两个点(x0, y0, x1, y1)，permute在每个128位半内广播x或y
+SVG_TARGET_AVX2 inline __m256d mapPairAvx2(__m256d p, __m256d a, __m256d b, __m256d d)
+{
+    const __m256d xx = _mm256_permute_pd(p, 0x0);
+    const __m256d yy = _mm256_permute_pd(p, 0xF);
+    return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(xx, a), _mm256_mul_pd(yy, b)), d);
+}
+
+SVG_TARGET_AVX2 void mapAvx2(const Affine& m, const double* src, double* dst, qsizetype count)
+{
+    const __m256d a = _mm256_setr_pd(m.m11, m.m12, m.m11, m.m12);
+    const __m256d b = _mm256_setr_pd(m.m21, m.m22, m.m21, m.m22);
+    const __m256d d = _mm256_setr_pd(m.dx, m.dy, m.dx, m.dy);
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d p0 = _mm256_loadu_pd(src + 2 * i);
+        const __m256d p1 = _mm256_loadu_pd(src + 2 * i + 4);
+        _mm256_storeu_pd(dst + 2 * i, mapPairAvx2(p0, a, b, d));
+        _mm256_storeu_pd(dst + 2 * i + 4, mapPairAvx2(p1, a, b, d));
+    }
+    for (; i + 2 <= count; i += 2) {
+        _mm256_storeu_pd(dst + 2 * i, mapPairAvx2(_mm256_loadu_pd(src + 2 * i), a, b, d));
+    }
+    if (i < count) {
+        const __m128d p = _mm_loadu_pd(src + 2 * i);
+        _mm_storeu_pd(dst + 2 * i, mapPointSse2(p, _mm256_castpd256_pd128(a), _mm256_castpd256_pd128(b),
+                                                _mm256_castpd256_pd128(d)));
+    }
+}
+
+// 两个点一组累积min/max，最后把两个128位半合并
+SVG_TARGET_AVX2 void foldAvx2(__m256d low, __m256d high, double* lo, double* hi)
+{
+    _mm_storeu_pd(lo, _mm_min_pd(_mm256_castpd256_pd128(low), _mm256_extractf128_pd(low, 1)));
+    _mm_storeu_pd(hi, _mm_max_pd(_mm256_castpd256_pd128(high), _mm256_extractf128_pd(high, 1)));
+}
+
+SVG_TARGET_AVX2 void boundsAvx2(const double* src, qsizetype count, double* lo, double* hi)
+{
+    const __m128d first = _mm_loadu_pd(src);
+    __m256d lo0 = _mm256_insertf128_pd(_mm256_castpd128_pd256(first), first, 1);
+    __m256d hi0 = lo0;
+    __m256d lo1 = lo0;
+    __m256d hi1 = lo0;
+    qsizetype i = 1;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d p0 = _mm256_loadu_pd(src + 2 * i);
+        const __m256d p1 = _mm256_loadu_pd(src + 2 * i + 4);
+        lo0 = _mm256_min_pd(lo0, p0);
+        hi0 = _mm256_max_pd(hi0, p0);
+        lo1 = _mm256_min_pd(lo1, p1);
+        hi1 = _mm256_max_pd(hi1, p1);
+    }
+    for (; i + 2 <= count; i += 2) {
+        const __m256d p = _mm256_loadu_pd(src + 2 * i);
+        lo0 = _mm256_min_pd(lo0, p);
+        hi0 = _mm256_max_pd(hi0, p);
+    }
+    if (i < count) {
+        const __m128d p = _mm_loadu_pd(src + 2 * i);
+        const __m256d pp = _mm256_insertf128_pd(_mm256_castpd128_pd256(p), p, 1);
+        lo0 = _mm256_min_pd(lo0, pp);
+        hi0 = _mm256_max_pd(hi0, pp);
+    }
+    foldAvx2(_mm256_min_pd(lo0, lo1), _mm256_max_pd(hi0, hi1), lo, hi);
+}
+
+SVG_TARGET_AVX2 void mappedBoundsAvx2(const Affine& m, const double* src, qsizetype count, double* lo, double* hi)
+{
+    const __m256d a = _mm256_setr_pd(m.m11, m.m12, m.m11, m.m12);
+    const __m256d b = _mm256_setr_pd(m.m21, m.m22, m.m21, m.m22);
+    const __m256d d = _mm256_setr_pd(m.dx, m.dy, m.dx, m.dy);
+    const __m128d first = mapPointSse2(_mm_loadu_pd(src), _mm256_castpd256_pd128(a), _mm256_castpd256_pd128(b),
+                                       _mm256_castpd256_pd128(d));
+    __m256d low = _mm256_insertf128_pd(_mm256_castpd128_pd256(first), first, 1);
+    __m256d high = low;
+    qsizetype i = 1;
+    for (; i + 2 <= count; i += 2) {
+        const __m256d p = mapPairAvx2(_mm256_loadu_pd(src + 2 * i), a, b, d);
+        low = _mm256_min_pd(low, p);
+        high = _mm256_max_pd(high, p);
+    }
+    if (i < count) {
+        const __m128d p = mapPointSse2(_mm_loadu_pd(src + 2 * i), _mm256_castpd256_pd128(a),
+                                       _mm256_castpd256_pd128(b), _mm256_castpd256_pd128(d));
+        const __m256d pp = _mm256_insertf128_pd(_mm256_castpd128_pd256(p), p, 1);
+        low = _mm256_min_pd(low, pp);
+        high = _mm256_max_pd(high, pp);
+    }
+    foldAvx2(low, high, lo, hi);
+}
+
+#endif // SVG_POINT_KERNELS_AVX2
+
+struct Kernels
+{
+    SvgPointKernels::Isa isa;
+    MapFunction map;
+    BoundsFunction bounds;
+    MappedBoundsFunction mappedBounds;
+};
+
+Kernels selectKernels()
+{
+    Kernels kernels{SvgPointKernels::IsaScalar, mapScalar, boundsScalar, mappedBoundsScalar};
+#if defined(SVG_POINT_KERNELS_SIMD)
+    const Kernels sse2{SvgPointKernels::IsaSse2, mapInterleaved<mapSse2>, boundsInterleaved<boundsSse2>,
+                       mappedBoundsInterleaved<mappedBoundsSse2>};
+#endif
+    // SIMD内核按double交错数组读写QPointF，qreal为float的构建只用标量实现
+    if (std::is_same<qreal, double>::value && sizeof(QPointF) == 2 * sizeof(double)) {
+#if defined(SVG_POINT_KERNELS_AVX2)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernels = {SvgPointKernels::IsaAvx2, mapInterleaved<mapAvx2>, boundsInterleaved<boundsAvx2>,
+                       mappedBoundsInterleaved<mappedBoundsAvx2>};
+        } else if (__builtin_cpu_supports("sse2")) {
+            kernels = sse2;
+        }
+#elif defined(SVG_POINT_KERNELS_SIMD)
+        kernels = sse2;
+#endif
+    }
+    qDebug() << "点批处理内核：" << SvgPointKernels::isaName(kernels.isa);
+    return kernels;
+}
+
+const Kernels& kernels()
+{
+    static const Kernels sKernels = selectKernels();
+    return sKernels;
+}
+
+} // namespace
+
+SvgPointKernels::Isa SvgPointKernels::isa()
+{
+    return kernels().isa;
+}
+
+const char* SvgPointKernels::isaName(Isa isa)
+{
+    switch (isa) {
+    case IsaAvx2: return "AVX2";
+    case IsaSse2: return "SSE2";
+    case IsaScalar: break;
+    }
+    return "标量";
+}
+
+void SvgPointKernels::map(const QTransform& transform, const QPointF* src, QPointF* dst, qsizetype count)
+{
+    if (count <= 0) return;
+    if (transform.type() == QTransform::TxProject) {
+        for (qsizetype i = 0; i < count; ++i) dst[i] = transform.map(src[i]);
+        return;
+    }
+    kernels().map(affineOf(transform), src, dst, count);
+}
+
+QList<QPointF> SvgPointKernels::map(const QTransform& transform, const QList<QPointF>& points)
+{
+    QList<QPointF> result(points.size());
+    map(transform, points.constData(), result.data(), points.size());
+    return result;
+}
+
+QRectF SvgPointKernels::bounds(const QPointF* points, qsizetype count)
+{
+    if (count <= 0) return QRectF();
+    double lo[2];
+    double hi[2];
+    kernels().bounds(points, count, lo, hi);
+    return QRectF(lo[0], lo[1], hi[0] - lo[0], hi[1] - lo[1]);
+}
+
+QRectF SvgPointKernels::mappedBounds(const QTransform& transform, const QList<QPointF>& points)
+{
+    if (points.isEmpty()) return QRectF();
+    if (transform.type() == QTransform::TxProject) return bounds(map(transform, points));
+    double lo[2];
+    double hi[2];
+    kernels().mappedBounds(affineOf(transform), points.constData(), points.size(), lo, hi);
+    return QRectF(lo[0], lo[1], hi[0] - lo[0], hi[1] - lo[1]);
+}
@@ -7,8 +7,14 @@ void SvgPolyline::draw(SvgRenderer* renderer) const {
     if (!renderer || !renderer->painter() || mPoints.isEmpty()) return;
     QPainter* painter = renderer->painter();
 
-    // 应用样式（填充/描边均有效）
+    // 顶点批量变换到设备坐标，整体不可见时跳过
     const SvgStyle& style = this->style();
+    if (!renderer->isPointsVisible(mPoints, style.strokeWidth())) {
+        qDebug() << "折线不在可见区域，跳过绘制：顶点数量=" << mPoints.size();
+        return;
+    }
+
+    // 应用样式（填充/描边均有效）
     style.applyToPainter(painter, false);
 
     // 绘制折线（不闭合）
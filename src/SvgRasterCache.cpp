@@ -0,0 +1,152 @@
+#include "SvgRasterCache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+const char* const kEntrySuffix = ".raster";
+const char* const kStatisticsFile = "statistics";
+const qint64 kCopyChunkSize = 1024 * 1024;
+}
+
+SvgRasterCache::SvgRasterCache(const QString& cacheDir)
+    : mCacheDir(cacheDir)
+{
+}
+
+QString SvgRasterCache::cacheFilePath(const QByteArray& key) const
+{
+    return QDir(mCacheDir).filePath(QString::fromLatin1(key) + kEntrySuffix);
+}
+
+QByteArray SvgRasterCache::renderKey(const QString& sourceFile, const QSize& size, const QRectF& viewport,
+                                     SvgRenderer::Quality quality, SvgRasterWriter::Format format)
+{
+    QFile file(sourceFile);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+    // 源内容按块流式哈希，大文件不整体读入；路径与修改时间不参与，内容相同即命中
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) return QByteArray();
+
+    QByteArray parameters;
+    QDataStream out(&parameters, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << kRendererVersion << size << viewport << qint32(quality) << qint32(format);
+    hash.addData(parameters);
+    return hash.result().toHex();
+}
+
+bool SvgRasterCache::copyFile(const QString& from, const QString& to)
+{
+    QFile source(from);
+    if (!source.open(QIODevice::ReadOnly)) return false;
+    // 目标先写临时文件再原子替换：读者（包括共享目录的其他进程）不会看到写了一半的文件
+    QSaveFile target(to);
+    if (!target.open(QIODevice::WriteOnly)) return false;
+
+    QByteArray chunk;
+    while (!source.atEnd()) {
+        chunk = source.read(kCopyChunkSize);
+        if (chunk.isEmpty() || target.write(chunk) != chunk.size()) {
+            target.cancelWriting();
+            return false;
+        }
+    }
+    return target.commit();
+}
+
+bool SvgRasterCache::fetch(const QByteArray& key, const QString& outputFile)
+{
+    const QString path = cacheFilePath(key);
+    if (key.isEmpty() || !QFileInfo::exists(path) || !copyFile(path, outputFile)) {
+        ++mSession.misses;
+        return false;
+    }
+
+    // 刷新修改时间作为最近使用时间（LRU）
+    QFile entry(path);
+    if (entry.open(QIODevice::ReadWrite)) {
+        entry.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+    ++mSession.hits;
+    qDebug() << "栅格缓存命中：" << path;
+    return true;
+}
+
+bool SvgRasterCache::store(const QByteArray& key, const QString& renderedFile)
+{
+    if (key.isEmpty()) return false;
+    if (!QDir().mkpath(mCacheDir)) {
+        qDebug() << "无法创建栅格缓存目录：" << mCacheDir;
+        return false;
+    }
+    if (!copyFile(renderedFile, cacheFilePath(key))) {
+        qDebug() << "无法写入栅格缓存：" << cacheFilePath(key);
+        return false;
+    }
+    ++mSession.stores;
+    evict();
+    return true;
+}
+
+void SvgRasterCache::evict()
+{
+    QDir dir(mCacheDir);
+    QFileInfoList entries = dir.entryInfoList(QStringList() << QString("*") + kEntrySuffix, QDir::Files);
+    qint64 total = 0;
+    for (const QFileInfo& entry : entries) total += entry.size();
+    if (total <= mMaxBytes) return;
+
+    // 最久未使用的先淘汰；其他进程可能同时在淘汰，删除失败（已被删）直接跳过
+    std::sort(entries.begin(), entries.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return a.lastModified() < b.lastModified();
+    });
+    for (const QFileInfo& entry : entries) {
+        if (total <= mMaxBytes) break;
+        total -= entry.size();
+        if (QFile::remove(entry.absoluteFilePath())) {
+            ++mSession.evictions;
+        }
+    }
+    qDebug() << "栅格缓存淘汰完成，当前大小(MB)：" << total / (1024 * 1024);
+}
+
+SvgRasterCache::Statistics SvgRasterCache::flushStatistics()
+{
+    Statistics total;
+    if (!QDir().mkpath(mCacheDir)) return mSession;
+
+    const QString path = QDir(mCacheDir).filePath(kStatisticsFile);
+    QLockFile lock(path + ".lock");
+    if (!lock.lock()) return mSession;
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream in(&file);
+        in >> total.hits >> total.misses >> total.stores >> total.evictions;
+        if (in.status() != QDataStream::Ok) total = Statistics();
+        file.close();
+    }
+    total.hits += mSession.hits;
+    total.misses += mSession.misses;
+    total.stores += mSession.stores;
+    total.evictions += mSession.evictions;
+
+    QSaveFile out(path);
+    if (out.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&out);
+        stream << total.hits << total.misses << total.stores << total.evictions;
+        if (stream.status() == QDataStream::Ok && out.commit()) {
+            mSession = Statistics();   // 已合并，避免重复累加
+        }
+    }
+    return total;
+}
@@ -0,0 +1,180 @@
+#include "SvgRasterWriter.h"
+#include <QIODevice>
+#include <QtEndian>
+#include <QDebug>
+#include <zlib.h>
+
+namespace {
+// 压缩输出缓冲满后作为一个IDAT块写出
+const int kIdatChunkSize = 256 * 1024;
+
+// PNG：行滤波固定用Sub（与左侧像素做差），大面积纯色变为零序列，压缩率好且无需保留上一行
+class PngWriter : public SvgRasterWriter
+{
+public:
+    explicit PngWriter(QIODevice* device) : SvgRasterWriter(device) {}
+    ~PngWriter() override
+    {
+        if (mDeflating) deflateEnd(&mStream);
+    }
+
+    bool begin(int width, int height) override
+    {
+        if (width <= 0 || height <= 0) return fail("invalid image size");
+        mWidth = width;
+        mHeight = height;
+        mRowsWritten = 0;
+
+        static const char kSignature[8] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+        if (!writeBytes(kSignature, sizeof(kSignature))) return false;
+
+        uchar header[13];
+        qToBigEndian<quint32>(quint32(width), header);
+        qToBigEndian<quint32>(quint32(height), header + 4);
+        header[8] = 8;    // 位深
+        header[9] = 6;    // 颜色类型：RGBA
+        header[10] = 0;   // 压缩方法
+        header[11] = 0;   // 滤波方法
+        header[12] = 0;   // 不隔行
+        if (!writeChunk("IHDR", reinterpret_cast<const char*>(header), sizeof(header))) return false;
+
+        mStream = z_stream();
+        if (deflateInit(&mStream, Z_DEFAULT_COMPRESSION) != Z_OK) return fail("zlib初始化失败");
+        mDeflating = true;
+        mOutput.resize(kIdatChunkSize);
+        mStream.next_out = reinterpret_cast<Bytef*>(mOutput.data());
+        mStream.avail_out = kIdatChunkSize;
+        mRow.resize(1 + qsizetype(width) * 4);
+        return true;
+    }
+
+    bool writeRows(const QImage& rows) override
+    {
+        if (!mDeflating) return fail("writer not started");
+        if (rows.width() != mWidth || mRowsWritten + rows.height() > mHeight) return fail("row size mismatch");
+
+        const QImage rgba = rows.convertToFormat(QImage::Format_RGBA8888);
+        const int rowBytes = mWidth * 4;
+        uchar* filtered = reinterpret_cast<uchar*>(mRow.data());
+        for (int y = 0; y < rgba.height(); ++y) {
+            const uchar* line = rgba.constScanLine(y);
+            filtered[0] = 1;   // Sub
+            for (int i = 0; i < 4 && i < rowBytes; ++i) filtered[1 + i] = line[i];
+            for (int i = 4; i < rowBytes; ++i) filtered[1 + i] = uchar(line[i] - line[i - 4]);
+            if (!deflateData(filtered, 1 + rowBytes, Z_NO_FLUSH)) return false;
+        }
+        mRowsWritten += rgba.height();
+        return true;
+    }
+
+    bool finish() override
+    {
+        if (!mDeflating) return fail("writer not started");
+        if (mRowsWritten != mHeight) return fail("image is incomplete");
+        if (!deflateData(nullptr, 0, Z_FINISH)) return false;
+        deflateEnd(&mStream);
+        mDeflating = false;
+        return writeChunk("IEND", nullptr, 0);
+    }
+
+private:
+    bool deflateData(const uchar* data, int size, int flush)
+    {
+        mStream.next_in = const_cast<Bytef*>(data);
+        mStream.avail_in = uInt(size);
+        while (true) {
+            const int ret = deflate(&mStream, flush);
+            if (ret == Z_STREAM_ERROR) return fail("zlib压缩失败");
+            if (mStream.avail_out == 0 || (ret == Z_STREAM_END && mStream.avail_out < uInt(kIdatChunkSize))) {
+                if (!writeChunk("IDAT", mOutput.constData(), kIdatChunkSize - int(mStream.avail_out))) return false;
+                mStream.next_out = reinterpret_cast<Bytef*>(mOutput.data());
+                mStream.avail_out = kIdatChunkSize;
+            }
+            if (flush == Z_FINISH ? ret == Z_STREAM_END : mStream.avail_in == 0) return true;
+        }
+    }
+
+    bool writeChunk(const char* type, const char* data, int size)
+    {
+        uchar length[4];
+        qToBigEndian<quint32>(quint32(size), length);
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+        if (size > 0) crc = crc32(crc, reinterpret_cast<const Bytef*>(data), uInt(size));
+        uchar crcBytes[4];
+        qToBigEndian<quint32>(quint32(crc), crcBytes);
+        return writeBytes(reinterpret_cast<const char*>(length), 4)
+               && writeBytes(type, 4)
+               && (size == 0 || writeBytes(data, size))
+               && writeBytes(reinterpret_cast<const char*>(crcBytes), 4);
+    }
+
+    z_stream mStream;
+    bool mDeflating = false;
+    QByteArray mOutput;   // 压缩输出缓冲（一个IDAT块）
+    QByteArray mRow;      // 滤波后的当前行（含滤波类型字节）
+};
+
+// PAM：文本头加原始RGBA行，不压缩
+class PamWriter : public SvgRasterWriter
+{
+public:
+    explicit PamWriter(QIODevice* device) : SvgRasterWriter(device) {}
+
+    bool begin(int width, int height) override
+    {
+        if (width <= 0 || height <= 0) return fail("invalid image size");
+        mWidth = width;
+        mHeight = height;
+        mRowsWritten = 0;
+        const QByteArray header = "P7\nWIDTH " + QByteArray::number(width)
+                                  + "\nHEIGHT " + QByteArray::number(height)
+                                  + "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+        return writeBytes(header.constData(), header.size());
+    }
+
+    bool writeRows(const QImage& rows) override
+    {
+        if (rows.width() != mWidth || mRowsWritten + rows.height() > mHeight) return fail("row size mismatch");
+        const QImage rgba = rows.convertToFormat(QImage::Format_RGBA8888);
+        for (int y = 0; y < rgba.height(); ++y) {
+            if (!writeBytes(reinterpret_cast<const char*>(rgba.constScanLine(y)), qint64(mWidth) * 4)) return false;
+        }
+        mRowsWritten += rgba.height();
+        return true;
+    }
+
+    bool finish() override
+    {
+        if (mRowsWritten != mHeight) return fail("image is incomplete");
+        return true;
+    }
+};
+}
+
+SvgRasterWriter::Format SvgRasterWriter::formatForFileName(const QString& fileName)
+{
+    return fileName.endsWith(".pam", Qt::CaseInsensitive) ? FormatPam : FormatPng;
+}
+
+std::unique_ptr<SvgRasterWriter> SvgRasterWriter::create(Format format, QIODevice* device)
+{
+    if (format == FormatPam) return std::make_unique<PamWriter>(device);
+    return std::make_unique<PngWriter>(device);
+}
+
+bool SvgRasterWriter::writeBytes(const char* data, qint64 size)
+{
+    if (mDevice->write(data, size) != size) {
+        return fail("write failed: " + mDevice->errorString());
+    }
+    return true;
+}
+
+bool SvgRasterWriter::fail(const QString& message)
+{
+    if (mError.isEmpty()) {
+        mError = message;
+        qDebug() << "栅格写出失败：" << message;
+    }
+    return false;
+}
@@ -0,0 +1,304 @@
+#include "SvgRenderScheduler.h"
+#include "SvgDisplayList.h"
+#include "SvgRect.h"
+#include "SvgCircle.h"
+#include "SvgEllipse.h"
+#include "SvgPolygon.h"
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+bool SvgRenderScheduler::sOcclusionCulling = true;
+QAtomicInteger<quint64> SvgRenderScheduler::sOccludedItems(0);
+
+namespace {
+// 每绘制多少个图元检查一次耗时与取消标志
+const int kCheckInterval = 64;
+// 遮挡体内部的最小面积（像素）：更小的填充遮住整个图元的机会很少，不值得参与比较
+const int kMinOccluderPixels = 16 * 16;
+// 每个裁剪单元保留的遮挡体数量上限
+const int kMaxOccluders = 16;
+
+// 四个顶点恰为轴对齐矩形的多边形（地图导出中常见的底色块）
+bool isAxisAlignedRect(const QPolygonF& points, QRectF* rect)
+{
+    QPolygonF corners = points;
+    if (corners.size() == 5 && corners.first() == corners.last()) corners.removeLast();
+    if (corners.size() != 4) return false;
+    for (int i = 0; i < 4; ++i) {
+        const QPointF& a = corners.at(i);
+        const QPointF& b = corners.at((i + 1) % 4);
+        // 相邻顶点只能有一个坐标不同，且横竖交替
+        const bool horizontal = a.y() == b.y() && a.x() != b.x();
+        const bool vertical = a.x() == b.x() && a.y() != b.y();
+        if (horizontal == vertical) return false;
+        if (i > 0) {
+            const QPointF& prev = corners.at(i - 1);
+            if (horizontal == (prev.y() == a.y())) return false;
+        }
+    }
+    *rect = corners.boundingRect();
+    return true;
+}
+
+// 图元一定被填充完全覆盖的区域（局部坐标下的轴对齐矩形，填充是否不透明由调用方查样式表）：
+// 矩形（圆角时取去掉圆角后的内部）、圆与椭圆的内接矩形、轴对齐的矩形多边形
+bool opaqueFillRect(const SvgElement* element, QRectF* rect)
+{
+    if (auto* svgRect = dynamic_cast<const SvgRect*>(element)) {
+        *rect = QRectF(svgRect->x(), svgRect->y(), svgRect->width(), svgRect->height()).normalized();
+        *rect = rect->adjusted(qAbs(svgRect->rx()), qAbs(svgRect->ry()), -qAbs(svgRect->rx()), -qAbs(svgRect->ry()));
+    } else if (auto* circle = dynamic_cast<const SvgCircle*>(element)) {
+        const qreal half = circle->radius() * M_SQRT1_2;
+        *rect = QRectF(circle->center() - QPointF(half, half), circle->center() + QPointF(half, half));
+    } else if (auto* ellipse = dynamic_cast<const SvgEllipse*>(element)) {
+        const QPointF half(ellipse->rx() * M_SQRT1_2, ellipse->ry() * M_SQRT1_2);
+        const QPointF center(ellipse->cx(), ellipse->cy());
+        *rect = QRectF(center - half, center + half);
+    } else if (auto* polygon = dynamic_cast<const SvgPolygon*>(element)) {
+        if (!isAxisAlignedRect(polygon->points(), rect)) return false;
+    } else {
+        return false;
+    }
+    return rect->width() > 0 && rect->height() > 0;
+}
+
+// 设备空间中被图元完全覆盖的整像素矩形；只有轴对齐的变换（平移/缩放）才保持矩形
+bool occluderInterior(const SvgDisplayList* list, const SvgDisplayItem& item, const QTransform& view,
+                      QRect* interior)
+{
+    // 先查紧凑的样式表：大多数图元在这里就被排除，不必访问元素对象
+    if (!list->style(item).opaqueFill()) return false;
+    const QTransform total = item.transform * view;
+    if (total.type() > QTransform::TxScale) return false;
+    QRectF local;
+    if (!opaqueFillRect(item.element, &local)) return false;
+
+    // 向内取整到完全覆盖的像素，再各收缩1像素：抗锯齿边缘与图层合成时的重采样只影响边界附近
+    const QRectF device = total.mapRect(local);
+    const QPoint topLeft(qCeil(device.left()) + 1, qCeil(device.top()) + 1);
+    const QPoint bottomRight(qFloor(device.right()) - 2, qFloor(device.bottom()) - 2);
+    if (bottomRight.x() < topLeft.x() || bottomRight.y() < topLeft.y()) return false;
+    *interior = QRect(topLeft, bottomRight);
+    return true;
+}
+
+// 图元可能改变的像素（向外取整并留1像素抗锯齿余量）
+QRect deviceReach(const SvgDisplayItem& item, const QTransform& view)
+{
+    const QRectF device = view.mapRect(item.bounds);
+    return QRect(QPoint(qFloor(device.left()) - 1, qFloor(device.top()) - 1),
+                 QPoint(qCeil(device.right()), qCeil(device.bottom())));
+}
+}
+
+void SvgRenderScheduler::setOcclusionCulling(bool enabled)
+{
+    sOcclusionCulling = enabled;
+}
+
+bool SvgRenderScheduler::occlusionCulling()
+{
+    return sOcclusionCulling;
+}
+
+quint64 SvgRenderScheduler::totalOccludedItems()
+{
+    return sOccludedItems.loadRelaxed();
+}
+
+void SvgRenderScheduler::begin(const SvgDisplayList* list, const QTransform& viewTransform,
+                               QImage target, SvgRenderer::Quality quality)
+{
+    mList = list;
+    mView = viewTransform;
+    mInverseView = viewTransform.inverted();
+    mImage = std::move(target);
+    mQuality = quality;
+    mCellIndex = 0;
+    mCellStarted = false;
+    mCellItems.clear();
+    mItemIndex = 0;
+    mOccludedItems = 0;
+    // 同一缩放下只是整像素平移，图像原样拷贝；缩放略有差异时平滑缩放
+    mLayerPlacements.clear();
+    for (const SvgLayerImage& layer : mLayers) {
+        mLayerPlacements.append(layer.transform.inverted() * mView);
+    }
+
+    // 划分裁剪单元，按单元中心到图像中心的距离排序（视口中央的内容最先出现）
+    mCells.clear();
+    const QSize size = mImage.size();
+    for (int y = 0; y < size.height(); y += kCellSize) {
+        for (int x = 0; x < size.width(); x += kCellSize) {
+            mCells.append(QRect(x, y, qMin(kCellSize, size.width() - x), qMin(kCellSize, size.height() - y)));
+        }
+    }
+    const QPointF center(size.width() / 2.0, size.height() / 2.0);
+    std::stable_sort(mCells.begin(), mCells.end(), [&center](const QRect& a, const QRect& b) {
+        const QPointF da = QRectF(a).center() - center;
+        const QPointF db = QRectF(b).center() - center;
+        return QPointF::dotProduct(da, da) < QPointF::dotProduct(db, db);
+    });
+}
+
+bool SvgRenderScheduler::renderSlice(qint64 budgetMs)
+{
+    if (!mList || mImage.isNull()) return true;
+    if (isFinished()) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QPainter painter(&mImage);
+    SvgRenderer renderer;   // 仅借用其绘制与细节层次逻辑
+    renderer.setQuality(mQuality);
+    renderer.setAbortFlag(mAbortFlag);
+    renderer.setPainter(&painter);
+    renderer.applyQualityHints(&painter);
+
+    const QVector<SvgDisplayItem>& items = mList->items();
+    while (mCellIndex < mCells.size()) {
+        if (isAborted()) return false;
+        const QRect cell = mCells.at(mCellIndex);
+
+        painter.resetTransform();
+        if (!mCellStarted) {
+            // 查询与单元相交的图元，并清空单元中的旧内容
+            mCellItems = mList->query(mInverseView.mapRect(QRectF(cell)));
+            if (mFirstItem > 0 || mEndItem < std::numeric_limits<int>::max()) {
+                mCellItems.erase(std::remove_if(mCellItems.begin(), mCellItems.end(), [this](int index) {
+                    return index < mFirstItem || index >= mEndItem;
+                }), mCellItems.end());
+            }
+            if (sOcclusionCulling) cullOccluded(cell);
+            mItemIndex = 0;
+            mCellStarted = true;
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.fillRect(cell, Qt::transparent);
+            painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        }
+        painter.setClipRect(cell);
+
+        int drawn = 0;
+        while (mItemIndex < mCellItems.size()) {
+            const int index = mCellItems.at(mItemIndex);
+            const int layer = layerAt(index);
+            if (layer >= 0) {
+                // 图层代替区间内全部图元：合成一次，跳过本单元中属于该区间的其余图元
+                painter.setTransform(mLayerPlacements.at(layer));
+                painter.drawImage(QPointF(0, 0), mLayers.at(layer).image);
+                const int end = mLayers.at(layer).end;
+                while (mItemIndex < mCellItems.size() && mCellItems.at(mItemIndex) < end) ++mItemIndex;
+            } else {
+                renderer.renderItem(items.at(index), mView);
+                ++mItemIndex;
+            }
+            if (++drawn % kCheckInterval == 0
+                && (timer.elapsed() >= budgetMs || isAborted())) {
+                return false;
+            }
+        }
+
+        ++mCellIndex;
+        mCellStarted = false;
+        if (timer.elapsed() >= budgetMs) break;
+    }
+    return isFinished();
+}
+
+void SvgRenderScheduler::cullOccluded(const QRect& cell)
+{
+    const QVector<SvgDisplayItem>& items = mList->items();
+    QVector<QRect> occluders;
+    QVector<int> visible;
+    visible.reserve(mCellItems.size());
+
+    // 逆序扫描：只有更晚绘制的内容能遮住当前图元。被遮住的图元在单元内可能改变的
+    // 全部像素都落在某个遮挡体的不透明内部，跳过它不改变输出
+    for (int k = mCellItems.size() - 1; k >= 0; --k) {
+        const int index = mCellItems.at(k);
+        const SvgDisplayItem& item = items.at(index);
+        if (!occluders.isEmpty() && !item.bounds.isEmpty()) {
+            const QRect reach = deviceReach(item, mView) & cell;
+            const bool hidden = std::any_of(occluders.cbegin(), occluders.cend(),
+                                            [&reach](const QRect& occluder) { return occluder.contains(reach); });
+            if (hidden) {
+                ++mOccludedItems;
+                continue;
+            }
+        }
+
+        QRect interior;
+        if (occluderInterior(mList, item, mView, &interior)) {
+            interior &= cell;
+            const qint64 area = qint64(interior.width()) * interior.height();
+            if (area >= kMinOccluderPixels) {
+                if (occluders.size() < kMaxOccluders) {
+                    occluders.append(interior);
+                } else {
+                    // 已满时替换面积最小的遮挡体
+                    auto smallest = std::min_element(occluders.begin(), occluders.end(),
+                                                     [](const QRect& a, const QRect& b) {
+                                                         return qint64(a.width()) * a.height()
+                                                                < qint64(b.width()) * b.height();
+                                                     });
+                    if (qint64(smallest->width()) * smallest->height() < area) *smallest = interior;
+                }
+            }
+        }
+        visible.append(index);
+    }
+
+    const int culled = mCellItems.size() - visible.size();
+    if (culled > 0) sOccludedItems.fetchAndAddRelaxed(quint64(culled));
+    std::reverse(visible.begin(), visible.end());
+    mCellItems = std::move(visible);
+}
+
+void SvgRenderScheduler::setItemRange(int first, int end)
+{
+    mFirstItem = first;
+    mEndItem = end;
+}
+
+int SvgRenderScheduler::layerAt(int index) const
+{
+    // 图层按first升序且互不重叠：找到最后一个first <= index的图层
+    const auto it = std::upper_bound(mLayers.cbegin(), mLayers.cend(), index,
+                                     [](int value, const SvgLayerImage& layer) { return value < layer.first; });
+    if (it == mLayers.cbegin()) return -1;
+    const int candidate = int(it - mLayers.cbegin()) - 1;
+    return index < mLayers.at(candidate).end ? candidate : -1;
+}
+
+QImage SvgRenderScheduler::renderImage(const SvgDisplayList* list, const QTransform& viewTransform, const QSize& size,
+                                       SvgRenderer::Quality quality, const QAtomicInt* abortFlag,
+                                       const QVector<SvgLayerImage>& layers)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    SvgRenderScheduler scheduler;
+    scheduler.setAbortFlag(abortFlag);
+    scheduler.setLayers(layers);
+    scheduler.begin(list, viewTransform, std::move(image), quality);
+    scheduler.renderSlice(std::numeric_limits<qint64>::max());
+    return scheduler.takeImage();
+}
+
+QImage SvgRenderScheduler::renderRange(const SvgDisplayList* list, int first, int end, const QTransform& viewTransform,
+                                       const QSize& size, SvgRenderer::Quality quality, const QAtomicInt* abortFlag)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    SvgRenderScheduler scheduler;
+    scheduler.setAbortFlag(abortFlag);
+    scheduler.setItemRange(first, end);
+    scheduler.begin(list, viewTransform, std::move(image), quality);
+    scheduler.renderSlice(std::numeric_limits<qint64>::max());
+    return scheduler.takeImage();
+}
@@ -5,6 +5,9 @@
 #include "SvgStyle.h"
 #include "SvgTransform.h"
 #include "SvgRect.h"
+#include "SvgDisplayList.h"
+#include "SvgPointKernels.h"
+#include "SvgSceneStore.h"
 #include <QPainter>
 #include <QStack>
 #include <QDebug>
@@ -42,8 +45,8 @@ void SvgRenderer::pushTransform(const SvgTransform& transform) {
     if (mPainter) {
         // 保存当前变换（包含视图缩放+偏移+父元素变换）
         mTransformStack.push(mPainter->transform());
-        // 组合新变换（当前变换 × 元素自身变换）
-        QTransform newTransform = mPainter->transform() * transform.toQTransform();
+        // 组合新变换：元素局部坐标先经自身变换，再经当前变换到设备坐标
+        QTransform newTransform = transform.toQTransform() * mPainter->transform();
         mPainter->setTransform(newTransform);
     }
 }
@@ -55,30 +58,18 @@ void SvgRenderer::popTransform()
     }
 }
 
-void SvgRenderer::render(const SvgDocument* document, QPainter* painter, const QRectF& viewport) {
-    if (!document || !painter) {
-        qDebug() << "render失败：document或painter为空";
-        return;
-    }
-
-    painter->save();
-    setPainter(painter);
-
-    // 1. 关键修复1：从document获取viewBox（而非渲染器自身的mViewBox）
-    QRectF svgLogicRect = document->viewBox();  // 正确来源：SVG文档的viewBox
+QTransform SvgRenderer::fitTransform(const QRectF& viewBox, const QRectF& viewport)
+{
+    QRectF svgLogicRect = viewBox;     // SVG文档的viewBox
     QRectF windowPhysRect = viewport;
 
-    // 2. 关键修复2：强制处理无效viewBox（宽高<=0的情况）
+    // 强制处理无效viewBox（宽高<=0的情况），用默认值200x200避免除以0
     if (svgLogicRect.width() <= 0 || svgLogicRect.height() <= 0) {
-        // 用默认值200x200避免除以0，或根据元素计算（推荐后者）
         svgLogicRect = QRectF(0, 0, 200, 200);
         qDebug() << "警告：viewBox无效，使用默认值：" << svgLogicRect;
     }
 
-    qDebug() << "SVG逻辑范围（viewBox）：" << svgLogicRect;
-    qDebug() << "窗口物理尺寸：" << windowPhysRect;
-
-    // 3. 计算缩放和偏移（确保分母不为0，因上面已处理）
+    // 计算缩放和偏移（确保分母不为0，因上面已处理）
     qreal scaleX = windowPhysRect.width() / svgLogicRect.width();
     qreal scaleY = windowPhysRect.height() / svgLogicRect.height();
     qreal scale = qMin(scaleX, scaleY);  // 等比例缩放，避免图形变形
@@ -91,16 +82,45 @@ void SvgRenderer::render(const SvgDocument* document, QPainter* painter, const Q
     viewTransform.translate(offsetX, offsetY);  // 先平移到窗口中心
     viewTransform.scale(scale, scale);          // 再缩放
     viewTransform.translate(-svgLogicRect.x(), -svgLogicRect.y());  // 抵消viewBox原点偏移
+    return viewTransform;
+}
+
+void SvgRenderer::render(const SvgDocument* document, QPainter* painter, const QRectF& viewport) {
+    if (!document || !painter) {
+        qDebug() << "render失败：document或painter为空";
+        return;
+    }
+
+    qDebug() << "SVG逻辑范围（viewBox）：" << document->viewBox();
+    qDebug() << "窗口物理尺寸：" << viewport;
+
+    // 从document获取viewBox（而非渲染器自身的mViewBox），等比例适配到视口
+    render(document, painter, fitTransform(document->viewBox(), viewport));
+}
+
+void SvgRenderer::render(const SvgDocument* document, QPainter* painter, const QTransform& viewTransform)
+{
+    if (!document || !painter) {
+        qDebug() << "render失败：document或painter为空";
+        return;
+    }
+
+    painter->save();
+    setPainter(painter);
+
+    applyQualityHints(painter);
 
-    // 应用变换到画笔
+    // 应用变换到画笔（在画笔已有变换的基础上组合，便于绘制到分块等偏移目标）
+    const QTransform combined = viewTransform * painter->transform();
     mTransformStack.clear();
-    mTransformStack.push(viewTransform);
-    painter->setTransform(viewTransform);
-    qDebug() << "应用的坐标变换：" << viewTransform;  // 新增日志验证变换是否有效
+    mTransformStack.push(combined);
+    painter->setTransform(combined);
+    qDebug() << "应用的坐标变换：" << combined;  // 新增日志验证变换是否有效
 
     // 渲染元素（此时绘制逻辑坐标会自动转换为物理坐标）
     qDebug() << "开始渲染SVG元素，元素数量：" << document->elements().size();
     foreach (const SvgElement* element, document->elements()) {
+        if (isAborted()) break;
         renderElement(element, painter);
     }
 
@@ -116,8 +136,54 @@ void SvgRenderer::renderElement(const SvgElement* element, QPainter* painter) {
     if (!elemTrans.isIdentity()) pushTransform(elemTrans);
 
     // 调用元素的draw方法（虚函数：rect→SvgRect::draw，ellipse→SvgEllipse::draw）
-    element->draw(this);  // 关键：多态调用
+    if (!isBelowDetailThreshold(element)) {
+        element->draw(this);  // 关键：多态调用
+    }
 
     // 弹出变换
     if (!elemTrans.isIdentity()) popTransform();
 }
+
+bool SvgRenderer::isBelowDetailThreshold(const SvgElement* element) const
+{
+    if (mQuality != QualityDraft || !mPainter || !element) return false;
+    // 组的包围盒需要递归计算，文本的需要字体度量，二者都不在这里判断（文本自行处理）
+    if (element->type() == SvgElement::TypeGroup || element->type() == SvgElement::TypeText) return false;
+
+    const QRectF deviceBox = mPainter->transform().mapRect(element->boundingBox());
+    return deviceBox.width() < 1.0 && deviceBox.height() < 1.0;
+}
+
+bool SvgRenderer::isPointsVisible(const QList<QPointF>& points, qreal strokeWidth) const
+{
+    if (!mPainter || !mPainter->device() || points.isEmpty()) return true;
+    const QTransform& device = mPainter->transform();
+
+    // 描边外扩换算到设备坐标（非等比变换取较大的一边），与显示列表的包围盒规则一致
+    const qreal halfStroke = SvgSceneStore::strokeMargin(strokeWidth);
+    const QRectF pen = device.mapRect(QRectF(-halfStroke, -halfStroke, 2 * halfStroke, 2 * halfStroke));
+    const qreal margin = qMax(pen.width(), pen.height()) / 2 + 1;
+    const QRectF bounds = SvgPointKernels::mappedBounds(device, points).adjusted(-margin, -margin, margin, margin);
+
+    QRectF visible(0, 0, mPainter->device()->width(), mPainter->device()->height());
+    if (mPainter->hasClipping()) visible = visible.intersected(device.mapRect(mPainter->clipBoundingRect()));
+    return bounds.intersects(visible);
+}
+
+void SvgRenderer::applyQualityHints(QPainter* painter) const
+{
+    // 草稿关闭抗锯齿与平滑缩放
+    const bool full = mQuality == QualityFull;
+    painter->setRenderHint(QPainter::Antialiasing, full);
+    painter->setRenderHint(QPainter::TextAntialiasing, full);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, full);
+}
+
+void SvgRenderer::renderItem(const SvgDisplayItem& item, const QTransform& viewTransform)
+{
+    if (!mPainter || !item.element) return;
+    mPainter->setTransform(item.transform * viewTransform);
+    if (!isBelowDetailThreshold(item.element)) {
+        item.element->draw(this);
+    }
+}
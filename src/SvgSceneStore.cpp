@@ -0,0 +1,225 @@
+#include "SvgSceneStore.h"
+#include "SvgGroup.h"
+#include "SvgTreeWalker.h"
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const qreal kInf = std::numeric_limits<qreal>::infinity();
+const quint8 kVisibleLeaf = SvgSceneStore::FlagRendered | SvgSceneStore::FlagLeaf;
+
+QRectF unite(const QRectF& a, const QRectF& b)
+{
+    if (a.isEmpty()) return b;
+    if (b.isEmpty()) return a;
+    return a.united(b);
+}
+
+// 按文档前序登记元素并填写结构列（类型、父序号、子树末尾、可见性）
+class StructureVisitor : public SvgTreeVisitor
+{
+public:
+    StructureVisitor(QVector<const SvgElement*>& elements, QVector<quint8>& types, QVector<int>& parents,
+                     QVector<int>& subtreeEnds, QVector<quint8>& flags)
+        : mElements(elements), mTypes(types), mParents(parents), mSubtreeEnds(subtreeEnds), mFlags(flags)
+    {
+    }
+
+    bool enter(const SvgElement* element) override
+    {
+        const int ordinal = mElements.size();
+        const int parent = mOpen.isEmpty() ? -1 : mOpen.last();
+        bool rendered = parent < 0 || (mFlags.at(parent) & SvgSceneStore::FlagRendered);
+        quint8 flags = 0;
+        if (element->type() == SvgElement::TypeGroup) {
+            // defs/symbol的内容经由<use>图元绘制
+            rendered = rendered && static_cast<const SvgGroup*>(element)->isRendered();
+        } else {
+            flags |= SvgSceneStore::FlagLeaf;
+            // 文本包围盒按默认字体估算，不可靠
+            if (element->type() == SvgElement::TypeText) flags |= SvgSceneStore::FlagUnbounded;
+        }
+        if (rendered) flags |= SvgSceneStore::FlagRendered;
+
+        mElements.append(element);
+        mTypes.append(quint8(element->type()));
+        mParents.append(parent);
+        mSubtreeEnds.append(ordinal + 1);
+        mFlags.append(flags);
+        mOpen.append(ordinal);
+        return true;
+    }
+
+    void leave(const SvgElement* element) override
+    {
+        Q_UNUSED(element);
+        mSubtreeEnds[mOpen.takeLast()] = mElements.size();
+    }
+
+private:
+    QVector<const SvgElement*>& mElements;
+    QVector<quint8>& mTypes;
+    QVector<int>& mParents;
+    QVector<int>& mSubtreeEnds;
+    QVector<quint8>& mFlags;
+    QVector<int> mOpen;   // 当前路径上尚未离开的元素序号
+};
+
+} // namespace
+
+qreal SvgSceneStore::strokeMargin(qreal strokeWidth)
+{
+    return qMax<qreal>(strokeWidth / 2 * M_SQRT2, 0.5);
+}
+
+QRectF SvgSceneStore::leafBounds(const SvgElement* element, const QTransform& world)
+{
+    const qreal margin = strokeMargin(element->style().strokeWidth());
+    return world.mapRect(element->boundingBox().adjusted(-margin, -margin, margin, margin));
+}
+
+void SvgSceneStore::clear()
+{
+    mElements.clear();
+    mTypes.clear();
+    mParents.clear();
+    mSubtreeEnds.clear();
+    mFlags.clear();
+    mWorlds.clear();
+    mMinX.clear();
+    mMinY.clear();
+    mMaxX.clear();
+    mMaxY.clear();
+    mSubtreeBounds.clear();
+    mStyleHandles.clear();
+    mStyles.clear();
+    mStyleIndex.clear();
+    mOrdinals.clear();
+}
+
+void SvgSceneStore::build(const QList<SvgElement*>& roots)
+{
+    clear();
+    StructureVisitor visitor(mElements, mTypes, mParents, mSubtreeEnds, mFlags);
+    SvgTreeWalker::walk(roots, &visitor);
+
+    const int count = mElements.size();
+    mWorlds.resize(count);
+    mMinX.resize(count);
+    mMinY.resize(count);
+    mMaxX.resize(count);
+    mMaxY.resize(count);
+    mSubtreeBounds.fill(QRectF(), count);
+    mStyleHandles.resize(count);
+    mOrdinals.reserve(count);
+
+    // 父序号总小于子序号，按序号顺序计算时父元素的世界变换已就绪
+    for (int i = 0; i < count; ++i) {
+        mOrdinals.insert(mElements.at(i), i);
+        computeEntry(i);
+    }
+    // 逆序把每个元素的范围并入父组：处理到组时其子元素都已并入
+    for (int i = count - 1; i >= 0; --i) {
+        const int parent = mParents.at(i);
+        if (parent >= 0) mSubtreeBounds[parent] = unite(mSubtreeBounds.at(parent), bounds(i));
+    }
+}
+
+void SvgSceneStore::computeEntry(int ordinal)
+{
+    const SvgElement* element = mElements.at(ordinal);
+    const int parent = mParents.at(ordinal);
+    const QTransform local = element->transform().toQTransform();
+    mWorlds[ordinal] = parent >= 0 ? local * mWorlds.at(parent) : local;
+    mStyleHandles[ordinal] = internStyle(element->style());
+
+    if ((mFlags.at(ordinal) & (kVisibleLeaf | FlagUnbounded)) == kVisibleLeaf) {
+        const QRectF rect = leafBounds(element, mWorlds.at(ordinal));
+        mMinX[ordinal] = rect.left();
+        mMinY[ordinal] = rect.top();
+        mMaxX[ordinal] = rect.right();
+        mMaxY[ordinal] = rect.bottom();
+    } else {
+        mMinX[ordinal] = kInf;
+        mMinY[ordinal] = kInf;
+        mMaxX[ordinal] = -kInf;
+        mMaxY[ordinal] = -kInf;
+    }
+}
+
+int SvgSceneStore::internStyle(const SvgStyle& style)
+{
+    SvgHotStyle hot;
+    hot.fill = style.hasFill() ? style.fill().rgba() : 0;
+    hot.stroke = style.hasStroke() ? style.stroke().rgba() : 0;
+    hot.strokeWidth = style.strokeWidth();
+
+    auto it = mStyleIndex.constFind(hot);
+    if (it != mStyleIndex.constEnd()) return it.value();
+    // 编辑产生的旧样式不回收：样式表只在重建时清空，句柄保持稳定
+    const int handle = mStyles.size();
+    mStyles.append(hot);
+    mStyleIndex.insert(hot, handle);
+    return handle;
+}
+
+bool SvgSceneStore::updateElement(const SvgElement* element)
+{
+    const int first = ordinalOf(element);
+    if (first < 0) return false;
+    const int end = mSubtreeEnds.at(first);
+
+    for (int i = first; i < end; ++i) {
+        computeEntry(i);
+        if (!(mFlags.at(i) & FlagLeaf)) mSubtreeBounds[i] = QRectF();
+    }
+    for (int i = end - 1; i > first; --i) {
+        const int parent = mParents.at(i);
+        mSubtreeBounds[parent] = unite(mSubtreeBounds.at(parent), bounds(i));
+    }
+
+    // 祖先的子树范围 = 路径上子元素之前的叶子 ∪ 该子元素的子树 ∪ 之后的叶子；
+    // 各层扫描的区间互不重叠，整条祖先链合计最多扫描一遍全部元素
+    int child = first;
+    for (int ancestor = mParents.at(first); ancestor >= 0; child = ancestor, ancestor = mParents.at(ancestor)) {
+        QRectF rect = rangeBounds(ancestor + 1, child);
+        rect = unite(rect, bounds(child));
+        rect = unite(rect, rangeBounds(mSubtreeEnds.at(child), mSubtreeEnds.at(ancestor)));
+        mSubtreeBounds[ancestor] = rect;
+    }
+    return true;
+}
+
+QRectF SvgSceneStore::bounds(int ordinal) const
+{
+    if (!(mFlags.at(ordinal) & FlagLeaf)) return mSubtreeBounds.at(ordinal);
+    if (mMinX.at(ordinal) > mMaxX.at(ordinal)) return QRectF();
+    return QRectF(QPointF(mMinX.at(ordinal), mMinY.at(ordinal)), QPointF(mMaxX.at(ordinal), mMaxY.at(ordinal)));
+}
+
+QRectF SvgSceneStore::rangeBounds(int first, int end) const
+{
+    const qreal* minX = mMinX.constData();
+    const qreal* minY = mMinY.constData();
+    const qreal* maxX = mMaxX.constData();
+    const qreal* maxY = mMaxY.constData();
+    qreal x0 = kInf;
+    qreal y0 = kInf;
+    qreal x1 = -kInf;
+    qreal y1 = -kInf;
+    for (int i = first; i < end; ++i) {
+        x0 = std::min(x0, minX[i]);
+        y0 = std::min(y0, minY[i]);
+        x1 = std::max(x1, maxX[i]);
+        y1 = std::max(y1, maxY[i]);
+    }
+    if (x0 > x1 || y0 > y1) return QRectF();
+    return QRectF(QPointF(x0, y0), QPointF(x1, y1));
+}
+
+QRectF SvgSceneStore::unitedBounds() const
+{
+    return rangeBounds(0, mElements.size());
+}
@@ -0,0 +1,321 @@
+#include "SvgSourceDiff.h"
+#include "SvgDocument.h"
+#include "SvgElementFactory.h"
+#include "SvgGroup.h"
+#include "SvgGzipDevice.h"
+#include "SvgStreamLoader.h"
+#include <QBuffer>
+#include <QFile>
+#include <QHash>
+#include <QStack>
+#include <QXmlStreamReader>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+bool isContainerTag(const QString& tagName)
+{
+    return tagName == "svg" || tagName == "g" || tagName == "defs" || tagName == "symbol";
+}
+
+// 子节点签名全部确定后汇总子树hash与计数
+void finalize(SvgSubtreeSignature* node)
+{
+    node->hash = node->selfHash;
+    node->count = 1;
+    node->nestedSvg = false;
+    for (const SvgSubtreeSignature& child : node->children) {
+        node->hash = qHashMulti(node->hash, child.hash);
+        node->count += child.count;
+        node->nestedSvg = node->nestedSvg || child.nestedSvg || child.tagName == "svg";
+    }
+}
+
+size_t attributeHash(const QXmlStreamAttribute& attr)
+{
+    return qHashMulti(0, attr.qualifiedName(), attr.value());
+}
+
+// 只修改属性值即可更新的叶子：属性名序列不变；文本的内容不在属性中，仍按子树重建
+bool isAttributeUpdate(const SvgSubtreeSignature& oldNode, const SvgSubtreeSignature& newNode,
+                       const SvgElement* element)
+{
+    return !isContainerTag(newNode.tagName) && newNode.tagName != "text" && oldNode.tagName == newNode.tagName
+           && oldNode.attributeNames == newNode.attributeNames && element->type() != SvgElement::TypeGroup;
+}
+
+// 一次编辑操作（同一组内先执行全部删除，再按最终位置从小到大插入）
+struct EditOp {
+    enum Kind { Remove, Insert, Replace, Update };
+    Kind kind;
+    SvgGroup* parent;
+    SvgElement* target;   // Remove/Replace/Update：被删除或修改的现有元素
+    int index;            // Insert/Replace：在parent中的最终位置
+    int ordinal;          // Insert/Replace/Update：新节点在新源文本中的序号
+};
+
+} // namespace
+
+bool SvgSourceDiff::readSource(const QString& fileName, QByteArray* data)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    *data = file.readAll();
+
+    if (SvgGzipDevice::isGzipData(data->left(2))) {
+        QBuffer compressed(data);
+        compressed.open(QIODevice::ReadOnly);
+        SvgGzipDevice gzip(&compressed);
+        if (!gzip.open(QIODevice::ReadOnly)) return false;
+        const QByteArray plain = gzip.readAll();
+        if (!gzip.atEnd()) return false;
+        *data = plain;
+    }
+    return true;
+}
+
+bool SvgSourceDiff::scan(const QByteArray& data, SvgSubtreeSignature* root)
+{
+    *root = SvgSubtreeSignature();
+    QXmlStreamReader reader(data);
+    // 栈中只有祖先链，向栈顶追加子节点不会使栈中指针失效
+    QStack<SvgSubtreeSignature*> open;
+    bool haveRoot = false;
+    int ordinal = 0;
+
+    while (!reader.atEnd()) {
+        const QXmlStreamReader::TokenType token = reader.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            const QString tagName = reader.name().toString().toLower();
+            SvgSubtreeSignature* node = nullptr;
+            if (!haveRoot) {
+                if (tagName != "svg") return false;
+                haveRoot = true;
+                node = root;
+            } else if (open.isEmpty() || !SvgElementFactory::isSupportedTag(tagName)) {
+                // 与加载器一致：未支持的元素连同子树一起忽略
+                reader.skipCurrentElement();
+                continue;
+            } else {
+                open.top()->children.append(SvgSubtreeSignature());
+                node = &open.top()->children.last();
+            }
+
+            node->tagName = tagName;
+            node->ordinal = ordinal++;
+            size_t hash = qHash(tagName);
+            const QXmlStreamAttributes attributes = reader.attributes();
+            node->attributes.reserve(attributes.size());
+            for (const QXmlStreamAttribute& attr : attributes) {
+                if (attr.qualifiedName() == QLatin1String("id")) node->id = attr.value().toString();
+                hash = qHashMulti(hash, attr.qualifiedName(), attr.value());
+                node->attributeNames = qHashMulti(node->attributeNames, attr.qualifiedName());
+                node->attributes.append(attributeHash(attr));
+            }
+
+            if (tagName == "text") {
+                hash = qHashMulti(hash, reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            } else if (!isContainerTag(tagName)) {
+                reader.skipCurrentElement();   // 图形元素的子节点不参与绘制
+            }
+            node->selfHash = hash;
+            if (isContainerTag(tagName)) {
+                open.push(node);
+            } else {
+                finalize(node);
+            }
+        } else if (token == QXmlStreamReader::EndElement && !open.isEmpty()) {
+            finalize(open.pop());
+        }
+    }
+    return haveRoot && open.isEmpty() && !reader.hasError();
+}
+
+bool SvgSourceDiff::apply(SvgDocument* document, const SvgSubtreeSignature& oldRoot,
+                          const SvgSubtreeSignature& newRoot, const QByteArray& newData, Result* result)
+{
+    *result = Result();
+    if (!document || document->isLoading() || document->elements().size() != 1) return false;
+    if (document->isOptimized()) return false;   // 组已展开、坐标已烘焙，元素树与签名不对应
+    if (oldRoot.selfHash != newRoot.selfHash) return false;   // 根元素属性（viewBox等）变化
+    if (oldRoot.hash == newRoot.hash) return true;
+    auto* rootGroup = dynamic_cast<SvgGroup*>(document->elements().first());
+    if (!rootGroup) return false;
+
+    // 1. 对齐并规划：只深入签名不同、自身属性相同的组；其余不同的子树整体重建
+    struct Frame {
+        SvgGroup* group;
+        const SvgSubtreeSignature* oldNode;
+        const SvgSubtreeSignature* newNode;
+    };
+    QVector<EditOp> ops;
+    QHash<int, int> buildCounts;   // 需要构建的序号→子树元素数
+    QHash<int, const SvgSubtreeSignature*> updates;   // 原地修改的序号→旧签名
+    QHash<int, SvgElement*> updateTargets;
+    QStack<Frame> stack;
+    stack.push({rootGroup, &oldRoot, &newRoot});
+    while (!stack.isEmpty()) {
+        const Frame frame = stack.pop();
+        const QList<SvgElement*> live = frame.group->children();
+        const QVector<SvgSubtreeSignature>& oldChildren = frame.oldNode->children;
+        const QVector<SvgSubtreeSignature>& newChildren = frame.newNode->children;
+        if (live.size() != oldChildren.size()) {
+            qDebug() << "文档与源签名不对应，放弃增量更新";
+            return false;
+        }
+
+        QHash<QString, int> oldById;
+        for (int k = 0; k < oldChildren.size(); ++k) {
+            if (!oldChildren.at(k).id.isEmpty()) oldById.insert(oldChildren.at(k).id, k);
+        }
+
+        // 有id的按id对齐，无id的按位置顺序对齐（允许跳过一个被删除的元素）；匹配保持原有先后顺序
+        QVector<int> match(newChildren.size(), -1);
+        QVector<bool> used(oldChildren.size(), false);
+        int last = -1;
+        for (int j = 0; j < newChildren.size(); ++j) {
+            const SvgSubtreeSignature& node = newChildren.at(j);
+            int k = -1;
+            if (!node.id.isEmpty()) {
+                k = oldById.value(node.id, -1);
+            } else {
+                for (int candidate = last + 1; candidate <= last + 2 && candidate < oldChildren.size(); ++candidate) {
+                    const SvgSubtreeSignature& old = oldChildren.at(candidate);
+                    if (!old.id.isEmpty() || old.tagName != node.tagName) continue;
+                    if (candidate == last + 1 || old.hash == node.hash) {
+                        k = candidate;
+                        if (old.hash == node.hash) break;
+                    }
+                }
+            }
+            if (k <= last) continue;
+            match[j] = k;
+            used[k] = true;
+            last = k;
+        }
+
+        for (int k = 0; k < oldChildren.size(); ++k) {
+            if (!used.at(k)) ops.append({EditOp::Remove, frame.group, live.at(k), -1, -1});
+        }
+        for (int j = 0; j < newChildren.size(); ++j) {
+            const SvgSubtreeSignature& node = newChildren.at(j);
+            const int k = match.at(j);
+            if (k >= 0 && oldChildren.at(k).hash == node.hash) continue;   // 未变化，原样保留
+            if (k >= 0 && oldChildren.at(k).selfHash == node.selfHash && isContainerTag(node.tagName)
+                && live.at(k)->type() == SvgElement::TypeGroup) {
+                stack.push({static_cast<SvgGroup*>(live.at(k)), &oldChildren.at(k), &node});
+                continue;
+            }
+            if (k >= 0 && isAttributeUpdate(oldChildren.at(k), node, live.at(k))) {
+                ops.append({EditOp::Update, frame.group, live.at(k), j, node.ordinal});
+                updates.insert(node.ordinal, &oldChildren.at(k));
+                updateTargets.insert(node.ordinal, live.at(k));
+                continue;
+            }
+            if (node.tagName == "svg" || node.nestedSvg) return false;
+            ops.append({k >= 0 ? EditOp::Replace : EditOp::Insert, frame.group, k >= 0 ? live.at(k) : nullptr,
+                        j, node.ordinal});
+            buildCounts.insert(node.ordinal, node.count);
+            result->rebuiltElements += node.count;
+        }
+    }
+
+    // 2. 一次流式遍历新源文本，只为需要的序号构建子树或读取变化的属性（其余标签只计数）。
+    // 变化的属性中有编辑接口不支持的（或style：合并解析无法清除被删掉的声明）时改为整体重建
+    QVector<int> ordinals = buildCounts.keys() + updates.keys();
+    std::sort(ordinals.begin(), ordinals.end());
+    QHash<int, SvgElement*> built;
+    QHash<int, QVector<QPair<QString, QString>>> edits;   // 序号→变化的属性
+    QXmlStreamReader reader(newData);
+    bool haveRoot = false;
+    int ordinal = 0;
+    int next = 0;
+    while (!reader.atEnd() && next < ordinals.size()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) continue;
+        const QString tagName = reader.name().toString().toLower();
+        if (!haveRoot) {
+            haveRoot = true;
+            ++ordinal;
+            continue;
+        }
+        if (!SvgElementFactory::isSupportedTag(tagName)) {
+            reader.skipCurrentElement();
+            continue;
+        }
+        if (ordinal == ordinals.at(next) && updates.contains(ordinal)) {
+            const SvgSubtreeSignature* old = updates.value(ordinal);
+            const SvgElement* target = updateTargets.value(ordinal);
+            const QXmlStreamAttributes attributes = reader.attributes();
+            QVector<QPair<QString, QString>> changed;
+            bool editable = attributes.size() == old->attributes.size();
+            for (int i = 0; editable && i < attributes.size(); ++i) {
+                const QXmlStreamAttribute& attr = attributes.at(i);
+                if (attributeHash(attr) == old->attributes.at(i)) continue;
+                const QString name = attr.qualifiedName().toString();
+                const QString value = attr.value().toString();
+                editable = name != "style" && SvgElementFactory::supportsAttribute(target, name, value);
+                changed.append({name, value});
+            }
+            if (editable) {
+                edits.insert(ordinal, changed);
+                reader.skipCurrentElement();
+            } else {
+                built.insert(ordinal, SvgStreamLoader::buildSubtree(reader, document));
+                result->rebuiltElements += 1;
+            }
+            ++ordinal;
+            ++next;
+            continue;
+        }
+        if (ordinal == ordinals.at(next)) {
+            built.insert(ordinal, SvgStreamLoader::buildSubtree(reader, document));
+            ordinal += buildCounts.value(ordinal);
+            ++next;
+            continue;
+        }
+        ++ordinal;
+        if (tagName == "text") {
+            reader.readElementText(QXmlStreamReader::IncludeChildElements);
+        } else if (!isContainerTag(tagName)) {
+            reader.skipCurrentElement();
+        }
+    }
+    if (next < ordinals.size()) {
+        qDeleteAll(built);
+        return false;
+    }
+
+    // 3. 经由文档编辑接口应用。只有属性修改时逐个走增量通知；有结构修改时全部合并为一次批量编辑，
+    // 监听者只暂停一次、只重新编译一次
+    bool structural = false;
+    for (const EditOp& op : ops) {
+        structural = structural || op.kind != EditOp::Update || built.contains(op.ordinal);
+    }
+    if (structural) document->beginEditBatch();
+    for (EditOp op : ops) {
+        if (op.kind == EditOp::Update) {
+            if (!built.contains(op.ordinal)) {
+                for (const QPair<QString, QString>& attribute : edits.value(op.ordinal)) {
+                    document->setAttribute(op.target, attribute.first, attribute.second);
+                }
+                ++result->updatedElements;
+                continue;
+            }
+            op.kind = EditOp::Replace;
+        }
+        if (op.kind != EditOp::Insert) {
+            document->removeChild(op.target);
+            ++result->removed;
+        }
+        if (op.kind != EditOp::Remove) {
+            if (SvgElement* element = built.take(op.ordinal)) {
+                document->insertChild(op.parent, op.index, element);
+                ++result->inserted;
+            }
+        }
+    }
+    if (structural) document->endEditBatch();
+    qDeleteAll(built);
+    return true;
+}
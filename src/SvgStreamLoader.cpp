@@ -0,0 +1,367 @@
+#include "SvgStreamLoader.h"
+#include "SvgDocument.h"
+#include "SvgElementFactory.h"
+#include "SvgElement.h"
+#include "SvgGroup.h"
+#include <QXmlStreamReader>
+#include <QThread>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QStack>
+#include <QDebug>
+#include <limits>
+
+int SvgStreamLoader::sParallelThreshold = 0;
+
+namespace {
+
+// 会包含子元素的容器标签（其余元素的子节点不参与绘制）
+bool isContainerTag(const QString& tagName)
+{
+    return tagName == "svg" || tagName == "g" || tagName == "defs" || tagName == "symbol";
+}
+
+// 记录直接作为工厂的输入（属性值以QStringView读取，不复制）
+SvgNodeSource recordSource(const SvgNodeRecord& record)
+{
+    return SvgNodeSource(record.tagName, record.attributes, record.text);
+}
+
+// 填充当前开始标签；非容器元素在此读完（text读取文本，其余跳过子节点）
+void fillRecord(QXmlStreamReader& reader, SvgNodeRecord& node, bool& hasNestedSvg)
+{
+    node.tagName = reader.name().toString().toLower();
+    node.attributes = reader.attributes();
+    if (node.tagName == "svg") {
+        hasNestedSvg = true;
+    }
+    if (node.tagName == "text") {
+        node.text = reader.readElementText(QXmlStreamReader::IncludeChildElements);
+    } else if (!isContainerTag(node.tagName)) {
+        reader.skipCurrentElement();
+    }
+}
+
+} // namespace
+
+struct SvgStreamLoader::BuildSlot
+{
+    SvgElement* element = nullptr;   // 根元素的一个直接子元素（容器在当前线程流式创建）
+    // 分流到线程池的剩余部分：spine[i]的子记录按文档顺序追加到groups[i]已有的子元素之后
+    QVector<SvgGroup*> groups;
+    QVector<SvgNodeRecord> spine;
+    bool offloaded = false;
+    QAtomicInt ready{0};   // 子树读完（分流时为工作线程构建完成）后置1
+};
+
+SvgStreamLoader::SvgStreamLoader(SvgDocument* document)
+    : mDocument(document)
+{
+}
+
+SvgStreamLoader::~SvgStreamLoader()
+{
+    discardSlots();
+    if (mOwnsRoot) {
+        delete mRoot;
+    }
+}
+
+SvgElement* SvgStreamLoader::parse(QXmlStreamReader& reader)
+{
+    while (parseChunk(reader, std::numeric_limits<int>::max())) {
+    }
+    if (hasError()) {
+        return nullptr;
+    }
+    return takeRoot();
+}
+
+SvgElement* SvgStreamLoader::takeRoot()
+{
+    mOwnsRoot = false;
+    return mRoot;
+}
+
+bool SvgStreamLoader::parseChunk(QXmlStreamReader& reader, int maxElements)
+{
+    if (mFinished) return false;
+
+    const bool parallel = sParallelThreshold > 0 && QThread::idealThreadCount() > 1;
+    int processed = 0;
+
+    while (!reader.atEnd() && processed < maxElements) {
+        const QXmlStreamReader::TokenType token = reader.readNext();
+
+        if (token == QXmlStreamReader::StartElement) {
+            const QString tagName = reader.name().toString().toLower();
+            ++processed;
+
+            // 根元素必须是svg标签
+            if (!mRoot && tagName != "svg") {
+                mErrorString = "根元素不是svg标签";
+                mFinished = true;
+                return false;
+            }
+
+            // 并行模式：正在流式构建的根子树超过阈值后，其余部分整体记录并交给线程池构建
+            if (mStreamingSlot && ++mStreamedCount > sParallelThreshold) {
+                processed += offloadRemainder(reader) - 1;
+                continue;
+            }
+
+            SvgElement* element = SvgElementFactory::createElement(currentSource(reader, tagName), mDocument);
+            if (!element) {
+                // 未支持的元素：与DOM路径一致，整个子树都不解析
+                if (tagName != "text") reader.skipCurrentElement();
+                continue;
+            }
+
+            const QTransform parentWorld = mOpenTransforms.isEmpty() ? QTransform() : mOpenTransforms.top();
+            if (!mRoot) {
+                mRoot = element;
+                mOwnsRoot = true;
+            } else if (parallel && mOpenGroups.size() == 1
+                       && (element->type() == SvgElement::TypeGroup || mSpliced < mSlots.size())) {
+                // 根元素的直接子元素：容器可能分流给线程池，先不挂到根元素上（渐进绘制期间不被并发修改）；
+                // 前面还有未拼接的槽位时，图元也排队以保持文档顺序
+                auto slot = std::make_unique<BuildSlot>();
+                slot->element = element;
+                if (element->type() == SvgElement::TypeGroup) {
+                    mStreamingSlot = slot.get();
+                    mStreamedCount = 1;
+                } else {
+                    slot->ready.storeRelease(1);
+                }
+                mSlots.push_back(std::move(slot));
+            } else {
+                mOpenGroups.top()->addChild(element);
+            }
+
+            if (element->type() == SvgElement::TypeGroup) {
+                mOpenGroups.push(static_cast<SvgGroup*>(element));
+                // 根元素自身的变换不计入（与根元素boundingBox的坐标系一致）
+                mOpenTransforms.push(element == mRoot ? QTransform()
+                                                      : element->transform().toQTransform() * parentWorld);
+            } else {
+                includeBounds(element, parentWorld);
+            }
+            if (element->type() != SvgElement::TypeGroup && tagName != "text") {
+                // 图形元素的子节点（title、desc等）不参与绘制，直接跳过
+                reader.skipCurrentElement();
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            // 只有容器元素的结束标签会走到这里（其他元素已被整体读取或跳过）
+            if (!mOpenGroups.isEmpty()) {
+                SvgGroup* closed = mOpenGroups.pop();
+                mOpenTransforms.pop();
+                if (mStreamingSlot && mOpenGroups.size() == 1) {
+                    // 根子树未超过阈值，已在当前线程完整构建
+                    mStreamingSlot->ready.storeRelease(1);
+                    mStreamingSlot = nullptr;
+                }
+                if (mOpenGroups.isEmpty() && !mSlots.empty()) {
+                    spliceSlots(closed, true);
+                }
+            }
+        }
+    }
+
+    // 渐进加载的安全点：把已构建完成的前缀子树拼接进来，供下一帧绘制
+    if (!mSlots.empty() && !mOpenGroups.isEmpty()) {
+        spliceSlots(mOpenGroups.first(), false);
+    }
+
+    if (!reader.atEnd()) {
+        return true;  // 还有剩余输入
+    }
+
+    mFinished = true;
+    if (reader.hasError()) {
+        mErrorString = QString("XML解析失败（第%1行）：%2")
+                           .arg(reader.lineNumber())
+                           .arg(reader.errorString());
+        discardSlots();
+    } else if (!mRoot) {
+        mErrorString = "未找到svg根元素";
+    }
+    return false;
+}
+
+SvgNodeSource SvgStreamLoader::currentSource(QXmlStreamReader& reader, const QString& tagName)
+{
+    // 属性表在读取文本之前取出（readElementText会推进reader）
+    const QXmlStreamAttributes attributes = reader.attributes();
+
+    // text元素需要完整文本内容（包含tspan等子元素中的文字），读取后该元素已结束
+    if (tagName == "text") {
+        return SvgNodeSource(tagName, attributes, reader.readElementText(QXmlStreamReader::IncludeChildElements));
+    }
+    return SvgNodeSource(tagName, attributes);
+}
+
+int SvgStreamLoader::recordSubtree(QXmlStreamReader& reader, SvgNodeRecord& record, bool& hasNestedSvg)
+{
+    fillRecord(reader, record, hasNestedSvg);
+    if (!isContainerTag(record.tagName)) return 1;
+
+    QStack<SvgNodeRecord*> stack;
+    stack.push(&record);
+    return 1 + recordChildren(reader, stack, false, hasNestedSvg);
+}
+
+int SvgStreamLoader::recordChildren(QXmlStreamReader& reader, QStack<SvgNodeRecord*>& stack, bool includeCurrent,
+                                    bool& hasNestedSvg)
+{
+    // 栈中只保存祖先链，向栈顶追加子记录不会使栈中指针失效
+    int count = 0;
+    while (!stack.isEmpty() && !reader.atEnd()) {
+        const QXmlStreamReader::TokenType token = includeCurrent ? reader.tokenType() : reader.readNext();
+        includeCurrent = false;
+        if (token == QXmlStreamReader::StartElement) {
+            SvgNodeRecord& parent = *stack.top();
+            parent.children.append(SvgNodeRecord());
+            SvgNodeRecord& child = parent.children.last();
+            fillRecord(reader, child, hasNestedSvg);
+            ++count;
+            if (isContainerTag(child.tagName)) {
+                stack.push(&child);
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            stack.pop();
+        }
+    }
+    return count;
+}
+
+int SvgStreamLoader::offloadRemainder(QXmlStreamReader& reader)
+{
+    BuildSlot* slot = mStreamingSlot;
+    mStreamingSlot = nullptr;
+    slot->offloaded = true;
+
+    // 根子树中尚未闭合的容器（mOpenGroups[0]是根元素）各对应一个记录，收集其余下的子元素
+    const int depth = mOpenGroups.size() - 1;
+    slot->groups.reserve(depth);
+    slot->spine.resize(depth);
+    QStack<SvgNodeRecord*> stack;
+    for (int i = 0; i < depth; ++i) {
+        slot->groups.append(mOpenGroups.at(i + 1));
+        stack.push(&slot->spine[i]);
+    }
+    bool hasNestedSvg = false;
+    const int count = recordChildren(reader, stack, true, hasNestedSvg);
+
+    // 读完了整棵根子树（含各容器的结束标签），容器栈回到根元素
+    mOpenGroups.resize(1);
+    mOpenTransforms.resize(1);
+
+    // 嵌套svg会写入文档viewBox，保持在当前线程构建
+    if (hasNestedSvg) {
+        buildRemainder(slot, mDocument);
+        slot->ready.storeRelease(1);
+        return count;
+    }
+    if (!mPool) {
+        mPool = std::make_unique<QThreadPool>();
+    }
+    // GUI线程随后可能解析到嵌套svg并改写文档viewBox，工作线程只使用此刻的快照
+    SvgDocument* document = mDocument;
+    const QRectF viewBox = document->viewBox();
+    mPool->start([slot, document, viewBox]() {
+        const SvgElementFactory::ViewBoxSnapshot snapshot(viewBox);
+        buildRemainder(slot, document);
+        slot->ready.storeRelease(1);
+    });
+    return count;
+}
+
+void SvgStreamLoader::buildRemainder(BuildSlot* slot, SvgDocument* document)
+{
+    for (int i = 0; i < slot->spine.size(); ++i) {
+        for (const SvgNodeRecord& child : slot->spine.at(i).children) {
+            if (SvgElement* element = buildFromRecord(child, document)) {
+                slot->groups.at(i)->addChild(element);
+            }
+        }
+    }
+    slot->spine.clear();  // 构建完即释放记录
+}
+
+SvgElement* SvgStreamLoader::buildSubtree(QXmlStreamReader& reader, SvgDocument* document)
+{
+    SvgNodeRecord record;
+    bool hasNestedSvg = false;
+    recordSubtree(reader, record, hasNestedSvg);
+    return buildFromRecord(record, document);
+}
+
+SvgElement* SvgStreamLoader::buildFromRecord(const SvgNodeRecord& record, SvgDocument* document)
+{
+    // 记录只读，工作线程之间不共享任何可变状态
+    SvgElement* root = SvgElementFactory::createElement(recordSource(record), document);
+    if (!root || root->type() != SvgElement::TypeGroup) return root;
+
+    struct Frame {
+        const SvgNodeRecord* node;
+        SvgGroup* group;
+    };
+    QStack<Frame> stack;
+    stack.push({&record, static_cast<SvgGroup*>(root)});
+    while (!stack.isEmpty()) {
+        const Frame frame = stack.pop();
+        for (const SvgNodeRecord& child : frame.node->children) {
+            SvgElement* element = SvgElementFactory::createElement(recordSource(child), document);
+            if (!element) continue;
+            frame.group->addChild(element);
+            if (element->type() == SvgElement::TypeGroup) {
+                stack.push({&child, static_cast<SvgGroup*>(element)});
+            }
+        }
+    }
+    return root;
+}
+
+void SvgStreamLoader::spliceSlots(SvgGroup* root, bool wait)
+{
+    if (wait && mPool) {
+        mPool->waitForDone();
+    }
+    // 只按顺序拼接已完成的前缀，保证子元素始终保持文档顺序
+    while (mSpliced < mSlots.size()) {
+        BuildSlot* slot = mSlots[mSpliced].get();
+        if (!slot->ready.loadAcquire()) break;
+        if (slot->element) {
+            // 流式构建的部分已逐个计入；分流的子树在此整体计入
+            if (slot->offloaded) includeBounds(slot->element, QTransform());
+            root->addChild(slot->element);
+            slot->element = nullptr;
+        }
+        ++mSpliced;
+    }
+    if (wait) {
+        qDebug() << "并行构建完成，拼接子树数量：" << mSlots.size();
+        mSlots.clear();
+        mSpliced = 0;
+    }
+}
+
+void SvgStreamLoader::includeBounds(const SvgElement* element, const QTransform& parentWorld)
+{
+    const QRectF bounds = (element->transform().toQTransform() * parentWorld).mapRect(element->boundingBox());
+    if (bounds.isEmpty()) return;
+    mLoadedBounds = mLoadedBounds.isEmpty() ? bounds : mLoadedBounds.united(bounds);
+}
+
+void SvgStreamLoader::discardSlots()
+{
+    if (mPool) {
+        mPool->waitForDone();
+    }
+    for (const std::unique_ptr<BuildSlot>& slot : mSlots) {
+        delete slot->element;
+    }
+    mSlots.clear();
+    mStreamingSlot = nullptr;
+    mSpliced = 0;
+}
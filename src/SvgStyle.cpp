@@ -68,13 +68,13 @@ void SvgStyle::setBrush(SvgBrush* brush)
     }
 }
 
-void SvgStyle::parseStyleString(const QString& styleStr)
+void SvgStyle::parseStyleString(QStringView styleStr)
 {
-    QStringList props = styleStr.split(';');
-    foreach (const QString& prop, props) {
-        QStringList keyValue = prop.split(':');
+    // 在原字符串上切分，只有识别出的键值对才复制成QString
+    for (const QStringView prop : styleStr.split(u';')) {
+        const QList<QStringView> keyValue = prop.split(u':');
         if (keyValue.size() == 2) {
-            parseAttribute(keyValue[0].trimmed(), keyValue[1].trimmed());
+            parseAttribute(keyValue[0].trimmed().toString(), keyValue[1].trimmed().toString());
         }
     }
 }
@@ -148,6 +148,12 @@ void SvgStyle::parseAttribute(const QString& name, const QString& value)
     }
 }
 
+bool SvgStyle::isStyleProperty(const QString& name)
+{
+    return name == "fill" || name == "stroke" || name == "stroke-width" || name == "font-family"
+           || name == "font-size" || name == "text-anchor";
+}
+
 void SvgStyle::copyFrom(const SvgStyle& other)
 {
     if (other.mPen) {
@@ -0,0 +1,15 @@
+#include "SvgSymbol.h"
+
+SvgSymbol::SvgSymbol(const QString& id)
+    : SvgGroup(id)
+{}
+
+void SvgSymbol::draw(SvgRenderer* renderer) const
+{
+    Q_UNUSED(renderer);   // 只经由<use>实例绘制
+}
+
+void SvgSymbol::drawContent(SvgRenderer* renderer) const
+{
+    SvgGroup::draw(renderer);
+}
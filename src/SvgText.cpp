@@ -2,8 +2,15 @@
 #include "SvgRenderer.h"
 #include <QPainter>
 #include <QFontMetricsF>
+#include <QMutexLocker>
+#include <QtMath>
 #include <QDebug>
 
+namespace {
+// 草稿质量下，设备空间字号小于该值（像素）的文本不绘制
+const qreal kDraftMinTextPixels = 3.0;
+}
+
 SvgText::SvgText(const QString& id)
     : SvgElement(TypeText, id)
 {}
@@ -41,6 +48,12 @@ void SvgText::draw(SvgRenderer* renderer) const
     painter->setPen(textPen);
     painter->setBrush(Qt::NoBrush);
 
+    if (renderer->quality() == SvgRenderer::QualityDraft) {
+        drawDraft(painter, font, style);
+        painter->restore();
+        return;
+    }
+
     // 3. 处理text-anchor对齐（调整逻辑坐标x）
     QFontMetricsF fm(font);
     qreal textWidth = fm.horizontalAdvance(mText);
@@ -59,6 +72,32 @@ void SvgText::draw(SvgRenderer* renderer) const
     painter->restore(); // 恢复画笔状态
 }
 
+void SvgText::drawDraft(QPainter* painter, const QFont& font, const SvgStyle& style) const
+{
+    // 细节层次：按当前变换的平均缩放估算设备字号
+    const qreal deviceSize = font.pointSizeF() * qSqrt(qAbs(painter->transform().determinant()));
+    if (deviceSize < kDraftMinTextPixels) return;
+
+    QMutexLocker locker(&mStaticTextMutex);
+    if (mStaticText.text() != mText || mStaticTextFont != font) {
+        mStaticText.setText(mText);
+        mStaticText.setTextFormat(Qt::PlainText);
+        mStaticText.prepare(QTransform(), font);
+        mStaticTextFont = font;
+        mStaticTextAscent = QFontMetricsF(font).ascent();
+    }
+
+    // text-anchor对齐；drawStaticText以左上角定位，需从基线上移ascent
+    const qreal textWidth = mStaticText.size().width();
+    QPointF topLeft(mPosition.x(), mPosition.y() - mStaticTextAscent);
+    if (style.textAnchor() == "middle") {
+        topLeft.rx() -= textWidth / 2;
+    } else if (style.textAnchor() == "end") {
+        topLeft.rx() -= textWidth;
+    }
+    painter->drawStaticText(topLeft, mStaticText);
+}
+
 QRectF SvgText::boundingBox() const
 {
     // 使用正确的参数组合计算文本边界框
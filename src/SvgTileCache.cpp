@@ -0,0 +1,226 @@
+#include "SvgTileCache.h"
+#include "SvgDocument.h"
+#include "SvgRenderer.h"
+#include "SvgRenderScheduler.h"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+
+SvgTileCache::SvgTileCache(QObject* parent)
+    : QObject(parent), mAbort(std::make_shared<QAtomicInt>(0))
+{
+}
+
+SvgTileCache::~SvgTileCache()
+{
+    mAbort->storeRelaxed(1);
+    mPool.clear();
+    mPool.waitForDone();
+}
+
+void SvgTileCache::setDocument(const SvgDocument* document, qreal baseScale)
+{
+    clear();
+    mDocument = document;
+    mBaseScale = baseScale > 0 ? baseScale : 1.0;
+    mDisplayList.compile(document);
+    mLayers.rebuild(mDisplayList);
+}
+
+void SvgTileCache::clear()
+{
+    // 先让运行中的任务在下一个元素处退出，等待时间与分块大小无关
+    ++mGeneration;
+    mAbort->storeRelaxed(1);
+    mAbort = std::make_shared<QAtomicInt>(0);
+    mPool.clear();
+    mPool.waitForDone();
+    mTiles.clear();
+    mLastUse.clear();
+    mPending.clear();
+    mDraftTiles.clear();
+    mBytes = 0;
+    mLayers.clear();
+}
+
+void SvgTileCache::cancelPending()
+{
+    // 已开始的任务继续完成（结果仍然有效），只移除排队中的
+    mPool.clear();
+    mPending.clear();
+    mLayers.cancelPending();
+}
+
+void SvgTileCache::suspend()
+{
+    // 运行中的任务读取的是修改前的文档，直接中止；已完成但尚未入库的结果随代数递增一并丢弃
+    ++mGeneration;
+    mAbort->storeRelaxed(1);
+    mAbort = std::make_shared<QAtomicInt>(0);
+    mPool.clear();
+    mPool.waitForDone();
+    mPending.clear();
+    mLayers.cancelPending();
+}
+
+void SvgTileCache::documentChanged(const SvgDocumentChange& change)
+{
+    if (!mDocument) return;
+    if (change.kind == SvgDocumentChange::ElementChanged) {
+        mDisplayList.updateElement(mDocument, change.element);
+        // 引用了被修改内容的实例：变换不变，包围盒随目标变化
+        for (const SvgElement* instance : change.instances) {
+            mDisplayList.updateElement(mDocument, instance);
+        }
+    } else {
+        mDisplayList.compile(mDocument);   // 图元下标整体变化
+    }
+    mLayers.documentChanged(change, mDisplayList);
+
+    int stale = 0;
+    for (auto it = mTiles.constBegin(); it != mTiles.constEnd(); ++it) {
+        if (tileRect(it.key()).intersects(change.dirtyRect)) {
+            mDraftTiles.insert(it.key());
+            ++stale;
+        }
+    }
+    qDebug() << "文档已编辑，过期分块数量：" << stale << "/" << mTiles.size();
+}
+
+qreal SvgTileCache::levelScale(int level) const
+{
+    return mBaseScale * qPow(2.0, level);
+}
+
+QRectF SvgTileCache::tileRect(const SvgTileKey& key) const
+{
+    const qreal size = kTileSize / levelScale(key.level);
+    return QRectF(key.x * size, key.y * size, size, size);
+}
+
+QImage SvgTileCache::tile(const SvgTileKey& key)
+{
+    auto it = mTiles.constFind(key);
+    if (it == mTiles.constEnd()) return QImage();
+    mLastUse[key] = ++mClock;
+    return it.value();
+}
+
+void SvgTileCache::requestTile(const SvgTileKey& key, SvgRenderer::Quality quality)
+{
+    if (!mDocument || mDisplayList.isEmpty() || mPending.contains(key)) return;
+    // 已有完整分块，或已有草稿且只需要草稿
+    if (mTiles.contains(key) && (quality == SvgRenderer::QualityDraft || !mDraftTiles.contains(key))) return;
+    mPending.insert(key);
+
+    const int generation = mGeneration;
+    const std::shared_ptr<QAtomicInt> abort = mAbort;
+    const SvgDisplayList* list = &mDisplayList;
+    const qreal scale = levelScale(key.level);
+    // 草稿分块分辨率不同，不使用图层
+    QVector<SvgLayerImage> layers;
+    if (quality == SvgRenderer::QualityFull) {
+        requestLayers(scale, tileRect(key));
+        layers = mLayers.layers(scale);
+    }
+
+    mPool.start([this, list, key, scale, generation, abort, quality, layers]() {
+        if (abort->loadRelaxed()) return;  // 已被清空
+
+        QElapsedTimer timer;
+        timer.start();
+        const qreal resolution = quality == SvgRenderer::QualityDraft ? SvgRenderer::kDraftResolution : 1.0;
+        const int pixels = qCeil(kTileSize * resolution);
+        // 文档坐标→级别像素空间，再平移到分块原点（草稿再整体缩小）
+        QTransform transform;
+        transform.scale(resolution, resolution);
+        transform.translate(-key.x * kTileSize, -key.y * kTileSize);
+        transform.scale(scale, scale);
+
+        // 分块不大于一个裁剪单元：只绘制网格索引查到的相交图元，不限时一次画完
+        const QImage image = SvgRenderScheduler::renderImage(list, transform, QSize(pixels, pixels),
+                                                             quality, abort.get(), layers);
+        if (abort->loadRelaxed()) return;  // 中途取消，半成品分块不入库
+
+        // 回到GUI线程入库（缓存对象销毁前会等待线程池，this始终有效）
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, generation, key, image, quality, elapsed]() {
+            storeTile(generation, key, image, quality, elapsed);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SvgTileCache::requestLayers(qreal scale, const QRectF& rect)
+{
+    const int generation = mGeneration;
+    const std::shared_ptr<QAtomicInt> abort = mAbort;
+    const SvgDisplayList* list = &mDisplayList;
+    for (const SvgLayerRequest& request : mLayers.takeRequests(scale, rect)) {
+        // 图层在完成之前不参与合成，本次分块照常逐个绘制图元
+        mPool.start([this, list, request, generation, abort]() {
+            if (abort->loadRelaxed()) return;
+            QTransform transform;
+            transform.translate(-request.origin.x(), -request.origin.y());
+            transform.scale(request.scale, request.scale);
+            const QImage image = SvgRenderScheduler::renderRange(list, request.first, request.end, transform,
+                                                                 request.size, SvgRenderer::QualityFull,
+                                                                 abort.get());
+            if (abort->loadRelaxed()) return;
+            QMetaObject::invokeMethod(this, [this, generation, request, image]() {
+                if (generation == mGeneration) mLayers.storeLayer(request, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void SvgTileCache::storeTile(int generation, const SvgTileKey& key, const QImage& image,
+                             SvgRenderer::Quality quality, qint64 elapsedMs)
+{
+    mPending.remove(key);
+    if (generation != mGeneration) return;
+
+    if (quality == SvgRenderer::QualityFull) {
+        mAverageTileTime = mAverageTileTime > 0 ? mAverageTileTime * 0.8 + elapsedMs * 0.2 : elapsedMs;
+        mDraftTiles.remove(key);
+    } else if (mTiles.contains(key) && !mDraftTiles.contains(key)) {
+        return;  // 草稿晚于完整分块到达，保留完整分块
+    } else {
+        mDraftTiles.insert(key);
+    }
+
+    mBytes -= mTiles.value(key).sizeInBytes();   // 替换草稿时扣除旧图像
+    mTiles.insert(key, image);
+    mLastUse.insert(key, ++mClock);
+    mBytes += image.sizeInBytes();
+    evict();
+    emit tileReady();
+}
+
+void SvgTileCache::evict()
+{
+    if (mBytes <= mMaxBytes) return;
+
+    // 按最近使用时间从旧到新淘汰，直到回到预算的3/4以内
+    QList<QPair<quint64, SvgTileKey>> order;
+    order.reserve(mLastUse.size());
+    for (auto it = mLastUse.constBegin(); it != mLastUse.constEnd(); ++it) {
+        order.append(qMakePair(it.value(), it.key()));
+    }
+    std::sort(order.begin(), order.end(),
+              [](const QPair<quint64, SvgTileKey>& a, const QPair<quint64, SvgTileKey>& b) {
+                  return a.first < b.first;
+              });
+
+    const qint64 target = mMaxBytes * 3 / 4;
+    int evicted = 0;
+    for (const auto& entry : order) {
+        if (mBytes <= target) break;
+        mBytes -= mTiles.value(entry.second).sizeInBytes();
+        mTiles.remove(entry.second);
+        mLastUse.remove(entry.second);
+        mDraftTiles.remove(entry.second);
+        ++evicted;
+    }
+    qDebug() << "分块缓存超出预算，淘汰分块数量：" << evicted;
+}
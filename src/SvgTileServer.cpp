@@ -0,0 +1,433 @@
+#include "SvgTileServer.h"
+#include "SvgDocument.h"
+#include "SvgDisplayList.h"
+#include "SvgPath.h"
+#include "SvgPolygon.h"
+#include "SvgPolyline.h"
+#include "SvgText.h"
+#include "SvgTreeWalker.h"
+#include "SvgRenderScheduler.h"
+#include <QBuffer>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QLocalSocket>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// 文档内存估算：元素对象本身（含样式、变换与父子指针）的平均字节数，几何另按实际大小计入
+const qint64 kBytesPerElement = 256;
+// 分块参数范围
+const int kMaxZoom = 24;
+const int kMinTileSize = 16;
+const int kMaxTileSize = 4096;
+// 单行请求的长度上限，超过视为非法输入
+const int kMaxRequestLine = 8192;
+
+QByteArray errorResponse(const QString& message)
+{
+    return "ERR " + message.toUtf8() + "\n";
+}
+
+QByteArray okResponse(const QByteArray& payload)
+{
+    return "OK " + QByteArray::number(payload.size()) + "\n" + payload;
+}
+
+// 文档与显示列表占用的内存：元素对象按平均大小，路径、点列表与文本按实际容量。
+// 几何去重池让重复的数据被多个元素隐式共享，按数据指针只计一次。
+// 懒加载路径只计d字符串；按需生成的几何与绘制时缓存的QPainterPath由SvgPath::materializedBytes另行计入预算
+qint64 documentCost(const SvgDocument& document, const SvgDisplayList& displayList)
+{
+    qint64 bytes = qint64(displayList.size()) * qint64(sizeof(SvgDisplayItem));
+    QSet<const void*> counted;
+    auto countOnce = [&counted, &bytes](const void* data, qint64 size) {
+        if (size <= 0 || counted.contains(data)) return;
+        counted.insert(data);
+        bytes += size;
+    };
+    SvgTreeWalker::preOrder(document.elements(), [&bytes, &countOnce](const SvgElement* element) {
+        bytes += kBytesPerElement;
+        if (auto* path = dynamic_cast<const SvgPath*>(element)) {
+            if (path->isLazy()) {
+                countOnce(path->pathData().constData(), path->pathData().capacity() * qint64(sizeof(QChar)));
+            } else {
+                const SvgPathData data = path->geometry();
+                countOnce(data.verbs().constData(), data.memoryUsage());
+            }
+        } else if (auto* polyline = dynamic_cast<const SvgPolyline*>(element)) {
+            countOnce(polyline->points().constData(), polyline->points().capacity() * qint64(sizeof(QPointF)));
+        } else if (auto* polygon = dynamic_cast<const SvgPolygon*>(element)) {
+            countOnce(polygon->points().constData(), polygon->points().capacity() * qint64(sizeof(QPointF)));
+        } else if (auto* text = dynamic_cast<const SvgText*>(element)) {
+            bytes += text->text().capacity() * qint64(sizeof(QChar));
+        }
+        return true;
+    });
+    return bytes;
+}
+}
+
+// 缓存中的一份已解析文档：显示列表编译后只读，可被多个工作线程同时渲染
+struct SvgTileServer::CachedDocument
+{
+    SvgDocument document;
+    SvgDisplayList displayList;
+    QDateTime modified;
+    qint64 cost = 0;
+    quint64 lastUse = 0;
+};
+
+SvgTileServer::SvgTileServer(QObject* parent)
+    : QObject(parent)
+{
+    mTiles.setMaxCost(256 * 1024 * 1024);
+    connect(&mServer, &QLocalServer::newConnection, this, &SvgTileServer::onNewConnection);
+}
+
+SvgTileServer::~SvgTileServer()
+{
+    mServer.close();
+    mPool.waitForDone();
+}
+
+bool SvgTileServer::listen(const QString& serverName)
+{
+    // 上次异常退出可能遗留同名套接字文件
+    QLocalServer::removeServer(serverName);
+    if (!mServer.listen(serverName)) {
+        qDebug() << "分块服务启动失败：" << mServer.errorString();
+        return false;
+    }
+    qDebug() << "分块服务已启动：" << mServer.fullServerName()
+             << "，工作线程数：" << mPool.maxThreadCount();
+    return true;
+}
+
+void SvgTileServer::setTileCacheBudget(qint64 bytes)
+{
+    QMutexLocker locker(&mMutex);
+    mTiles.setMaxCost(bytes);
+}
+
+void SvgTileServer::onNewConnection()
+{
+    while (QLocalSocket* socket = mServer.nextPendingConnection()) {
+        mConnections.insert(socket, Connection());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            auto it = mConnections.find(socket);
+            if (it == mConnections.end()) return;
+            it->buffer += socket->readAll();
+            processNext(socket);
+        });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            mConnections.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void SvgTileServer::processNext(QLocalSocket* socket)
+{
+    auto it = mConnections.find(socket);
+    if (it == mConnections.end() || it->busy) return;
+
+    while (true) {
+        const int newline = it->buffer.indexOf('\n');
+        if (newline < 0) {
+            if (it->buffer.size() > kMaxRequestLine) {
+                socket->write(errorResponse("request line too long"));
+                socket->disconnectFromServer();
+            }
+            return;
+        }
+        const QByteArray line = it->buffer.left(newline).trimmed();
+        it->buffer.remove(0, newline + 1);
+        if (line.isEmpty()) continue;
+
+        // 统计与分块请求都交给工作线程，应答回到本线程按序写出
+        std::function<QByteArray()> job;
+        if (line == "STATS") {
+            job = [this]() { return okResponse(statsText()); };
+        } else {
+            Request request;
+            QString error;
+            if (!parseRequest(line, &request, &error)) {
+                socket->write(errorResponse(error));
+                continue;
+            }
+            job = [this, request]() { return handleTile(request); };
+        }
+
+        it->busy = true;
+        QPointer<QLocalSocket> guard(socket);
+        mPool.start([this, job, guard, socket]() {
+            const QByteArray response = job();
+            QMetaObject::invokeMethod(this, [this, response, guard, socket]() {
+                if (!guard) return;   // 客户端已断开
+                socket->write(response);
+                auto connection = mConnections.find(socket);
+                if (connection == mConnections.end()) return;
+                connection->busy = false;
+                processNext(socket);
+            }, Qt::QueuedConnection);
+        });
+        return;
+    }
+}
+
+bool SvgTileServer::parseRequest(const QByteArray& line, Request* request, QString* error)
+{
+    // TILE <z> <x> <y> <size> <path>：路径放在最后，允许包含空格
+    const QList<QByteArray> parts = line.split(' ');
+    if (parts.size() < 6 || parts.at(0) != "TILE") {
+        *error = "expected: TILE <z> <x> <y> <size> <path>";
+        return false;
+    }
+
+    bool okZ = false, okX = false, okY = false, okSize = false;
+    request->z = parts.at(1).toInt(&okZ);
+    request->x = parts.at(2).toInt(&okX);
+    request->y = parts.at(3).toInt(&okY);
+    request->size = parts.at(4).toInt(&okSize);
+    // 跳过前五个字段，剩余部分原样作为路径
+    int pathStart = 0;
+    for (int i = 0; i < 5; ++i) {
+        pathStart = line.indexOf(' ', pathStart) + 1;
+    }
+    request->path = QString::fromUtf8(line.mid(pathStart));
+
+    if (!okZ || !okX || !okY || !okSize) {
+        *error = "invalid tile coordinates";
+        return false;
+    }
+    if (request->z < 0 || request->z > kMaxZoom) {
+        *error = QString("zoom out of range [0, %1]").arg(kMaxZoom);
+        return false;
+    }
+    const int tiles = 1 << request->z;
+    if (request->x < 0 || request->y < 0 || request->x >= tiles || request->y >= tiles) {
+        *error = "tile index out of range";
+        return false;
+    }
+    if (request->size < kMinTileSize || request->size > kMaxTileSize) {
+        *error = QString("tile size out of range [%1, %2]").arg(kMinTileSize).arg(kMaxTileSize);
+        return false;
+    }
+    if (request->path.isEmpty()) {
+        *error = "missing path";
+        return false;
+    }
+    return true;
+}
+
+QByteArray SvgTileServer::handleTile(const Request& request)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QString error;
+    const std::shared_ptr<CachedDocument> cached = acquireDocument(request.path, &error);
+    if (!cached) {
+        return errorResponse(error);
+    }
+
+    // 分块缓存键包含文件修改时间，文件变化后旧分块自然失效
+    const QString tileKey = QString("%1|%2|%3|%4|%5|%6")
+                                .arg(request.path)
+                                .arg(cached->modified.toMSecsSinceEpoch())
+                                .arg(request.z).arg(request.x).arg(request.y).arg(request.size);
+    {
+        QMutexLocker locker(&mMutex);
+        ++mRequests;
+        if (const QByteArray* png = mTiles.object(tileKey)) {
+            ++mTileHits;
+            return okResponse(*png);
+        }
+    }
+
+    // 级别z：viewBox长边划分为2^z个分块
+    const QRectF viewBox = cached->document.viewBox();
+    const qreal extent = qMax(viewBox.width(), viewBox.height());
+    const qreal scale = request.size * qreal(1 << request.z) / extent;
+    QTransform transform;
+    transform.translate(-qreal(request.x) * request.size, -qreal(request.y) * request.size);
+    transform.scale(scale, scale);
+    transform.translate(-viewBox.left(), -viewBox.top());
+
+    const QImage image = SvgRenderScheduler::renderImage(&cached->displayList, transform,
+                                                         QSize(request.size, request.size));
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "PNG")) {
+        return errorResponse("PNG encoding failed");
+    }
+
+    {
+        QMutexLocker locker(&mMutex);
+        mTiles.insert(tileKey, new QByteArray(png), png.size());
+        // 渲染可能生成了新的路径缓存
+        evictDocuments();
+    }
+    qDebug() << "分块渲染完成：" << request.path << request.z << request.x << request.y
+             << "，耗时(ms)：" << timer.elapsed() << "，字节数：" << png.size();
+    return okResponse(png);
+}
+
+std::shared_ptr<SvgTileServer::CachedDocument> SvgTileServer::acquireDocument(const QString& path, QString* error)
+{
+    const QFileInfo info(path);
+    if (!info.isFile()) {
+        *error = "file not found: " + path;
+        return nullptr;
+    }
+    const QString key = info.absoluteFilePath();
+    const QDateTime modified = info.lastModified();
+
+    std::shared_ptr<QMutex> loadLock;
+    {
+        QMutexLocker locker(&mMutex);
+        auto it = mDocuments.constFind(key);
+        if (it != mDocuments.constEnd() && it.value()->modified == modified) {
+            ++mDocumentHits;
+            it.value()->lastUse = ++mClock;
+            return it.value();
+        }
+        std::shared_ptr<QMutex>& lock = mLoadLocks[key];
+        if (!lock) lock = std::make_shared<QMutex>();
+        loadLock = lock;
+    }
+
+    // 同一文件的并发请求只有一个负责解析，其余等待后直接命中缓存
+    QMutexLocker loadLocker(loadLock.get());
+    {
+        QMutexLocker locker(&mMutex);
+        auto it = mDocuments.constFind(key);
+        if (it != mDocuments.constEnd() && it.value()->modified == modified) {
+            ++mDocumentHits;
+            it.value()->lastUse = ++mClock;
+            return it.value();
+        }
+    }
+
+    auto cached = std::make_shared<CachedDocument>();
+    if (!cached->document.load(key)) {
+        *error = "failed to load SVG: " + path;
+        return nullptr;
+    }
+    cached->displayList.compile(&cached->document);
+    cached->modified = modified;
+    cached->cost = documentCost(cached->document, cached->displayList);
+
+    QMutexLocker locker(&mMutex);
+    ++mDocumentLoads;
+    if (const auto old = mDocuments.value(key)) {
+        mDocumentBytes -= old->cost;   // 文件已修改，替换旧版本（正在使用旧版本的渲染仍持有引用）
+    }
+    cached->lastUse = ++mClock;
+    mDocuments.insert(key, cached);
+    mDocumentBytes += cached->cost;
+    evictDocuments();
+    qDebug() << "文档已载入服务缓存：" << key << "，估算内存(MB)：" << cached->cost / (1024 * 1024)
+             << "，缓存文档数：" << mDocuments.size();
+    return cached;
+}
+
+void SvgTileServer::evictDocuments()
+{
+    // 路径缓存的QPainterPath与懒加载路径按需生成的几何可以随时重新生成：
+    // 超出预算时先从最久未用的文档释放，仍超出才整份淘汰
+    if (SvgPath::materializedBytes() > 0 && mDocumentBytes + SvgPath::materializedBytes() > mDocumentBudget) {
+        QList<std::shared_ptr<CachedDocument>> byAge = mDocuments.values();
+        std::sort(byAge.begin(), byAge.end(),
+                  [](const std::shared_ptr<CachedDocument>& a, const std::shared_ptr<CachedDocument>& b) {
+                      return a->lastUse < b->lastUse;
+                  });
+        for (const std::shared_ptr<CachedDocument>& cached : byAge) {
+            if (mDocumentBytes + SvgPath::materializedBytes() <= mDocumentBudget) break;
+            const qint64 released = cached->document.releaseCachedGeometry();
+            if (released > 0) qDebug() << "释放文档中路径的缓存几何(KB)：" << released / 1024;
+        }
+    }
+
+    // 按最近使用时间淘汰，至少保留刚载入的一份
+    while (mDocumentBytes > mDocumentBudget && mDocuments.size() > 1) {
+        auto oldest = mDocuments.begin();
+        for (auto it = mDocuments.begin(); it != mDocuments.end(); ++it) {
+            if (it.value()->lastUse < oldest.value()->lastUse) oldest = it;
+        }
+        qDebug() << "淘汰服务缓存中的文档：" << oldest.key();
+        mDocumentBytes -= oldest.value()->cost;
+        mDocuments.erase(oldest);
+    }
+}
+
+QByteArray SvgTileServer::statsText()
+{
+    QMutexLocker locker(&mMutex);
+    QByteArray text;
+    text += "requests " + QByteArray::number(mRequests) + "\n";
+    text += "tile_hits " + QByteArray::number(mTileHits) + "\n";
+    text += "tile_cache_bytes " + QByteArray::number(mTiles.totalCost()) + "\n";
+    text += "documents " + QByteArray::number(mDocuments.size()) + "\n";
+    text += "document_bytes " + QByteArray::number(mDocumentBytes) + "\n";
+    text += "document_hits " + QByteArray::number(mDocumentHits) + "\n";
+    text += "document_loads " + QByteArray::number(mDocumentLoads) + "\n";
+    text += "occluded_items " + QByteArray::number(SvgRenderScheduler::totalOccludedItems()) + "\n";
+    return text;
+}
+
+bool SvgTileServer::fetchTile(const QString& serverName, const QString& filePath,
+                              int z, int x, int y, int tileSize,
+                              QByteArray* png, QString* error, int timeoutMs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    if (!socket.waitForConnected(timeoutMs)) {
+        *error = "cannot connect to " + serverName + ": " + socket.errorString();
+        return false;
+    }
+
+    const QByteArray request = QString("TILE %1 %2 %3 %4 %5\n")
+                                   .arg(z).arg(x).arg(y).arg(tileSize)
+                                   .arg(QFileInfo(filePath).absoluteFilePath()).toUtf8();
+    socket.write(request);
+    if (!socket.waitForBytesWritten(timeoutMs)) {
+        *error = "write failed: " + socket.errorString();
+        return false;
+    }
+
+    // 应答头：OK <n> 或 ERR <原因>
+    while (!socket.canReadLine()) {
+        if (!socket.waitForReadyRead(timeoutMs)) {
+            *error = "no response: " + socket.errorString();
+            return false;
+        }
+    }
+    const QByteArray header = socket.readLine().trimmed();
+    if (header.startsWith("ERR ")) {
+        *error = QString::fromUtf8(header.mid(4));
+        return false;
+    }
+    bool ok = false;
+    const qint64 length = header.startsWith("OK ") ? header.mid(3).toLongLong(&ok) : -1;
+    if (!ok || length < 0) {
+        *error = "malformed response: " + QString::fromUtf8(header);
+        return false;
+    }
+
+    png->clear();
+    while (png->size() < length) {
+        if (socket.bytesAvailable() == 0 && !socket.waitForReadyRead(timeoutMs)) {
+            *error = "truncated response: " + socket.errorString();
+            return false;
+        }
+        png->append(socket.read(length - png->size()));
+    }
+    return true;
+}
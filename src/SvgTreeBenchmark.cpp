@@ -0,0 +1,151 @@
+#include "SvgTreeBenchmark.h"
+#include "SvgDocument.h"
+#include "SvgDocumentCache.h"
+#include "SvgElement.h"
+#include "SvgRenderer.h"
+#include <QElapsedTimer>
+#include <QImage>
+#include <QLoggingCategory>
+#include <QPainter>
+#include <QTemporaryDir>
+
+namespace {
+const int kDrawSize = 512;
+const char* const kHeader = "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 1000 1000\">\n";
+}
+
+QByteArray SvgTreeBenchmark::deepDocument(int depth)
+{
+    // 每层一个带平移的<g>，最内层是唯一的图元：计数、包围盒与绘制都必须走到最深处
+    QByteArray data(kHeader);
+    const QByteArray open("<g transform=\"translate(0.05,0.05)\">");
+    data.reserve(data.size() + depth * (open.size() + 4) + 128);
+    for (int i = 0; i < depth; ++i) data += open;
+    data += "<rect x=\"10\" y=\"10\" width=\"100\" height=\"100\" fill=\"#336699\"/>";
+    for (int i = 0; i < depth; ++i) data += "</g>";
+    data += "\n</svg>\n";
+    return data;
+}
+
+QByteArray SvgTreeBenchmark::wideDocument(int width)
+{
+    // 一个组下排成方阵的小矩形
+    QByteArray data(kHeader);
+    data += "<g>\n";
+    int columns = 1;
+    while (columns * columns < width) ++columns;
+    const qreal cell = 1000.0 / columns;
+    for (int i = 0; i < width; ++i) {
+        data += QStringLiteral("<rect x=\"%1\" y=\"%2\" width=\"%3\" height=\"%3\" fill=\"#%4\"/>\n")
+                    .arg((i % columns) * cell)
+                    .arg((i / columns) * cell)
+                    .arg(cell * 0.8)
+                    .arg(i % 0xffffff, 6, 16, QLatin1Char('0'))
+                    .toUtf8();
+    }
+    data += "</g>\n</svg>\n";
+    return data;
+}
+
+SvgTreeBenchmark::Result SvgTreeBenchmark::runScenario(const QString& name, const QByteArray& source,
+                                                       const QString& cacheDir)
+{
+    Result result;
+    result.name = name;
+    QElapsedTimer timer;
+
+    SvgDocument document;
+    timer.start();
+    if (!document.loadFromData(source)) {
+        result.error = "load failed";
+        return result;
+    }
+    result.loadMs = timer.elapsed();
+
+    timer.restart();
+    result.elements = document.totalElementCount();
+    result.countMs = timer.elapsed();
+
+    timer.restart();
+    QRectF bounds;
+    for (const SvgElement* element : document.elements()) {
+        bounds = bounds.united(element->boundingBox());
+    }
+    result.boundsMs = timer.elapsed();
+    if (bounds.isEmpty()) {
+        result.error = "empty bounds";
+        return result;
+    }
+
+    QImage image(kDrawSize, kDrawSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    timer.restart();
+    {
+        QPainter painter(&image);
+        SvgRenderer renderer;
+        renderer.render(&document, &painter, QRectF(image.rect()));
+    }
+    result.drawMs = timer.elapsed();
+
+    // 缓存往返：写出后还原到新文档，元素数量应一致
+    SvgDocumentCache cache(cacheDir);
+    const QByteArray hash = SvgDocumentCache::contentHash(source);
+    timer.restart();
+    if (!cache.store(hash, &document)) {
+        result.error = "cache store failed";
+        return result;
+    }
+    result.cacheStoreMs = timer.elapsed();
+
+    SvgDocument restored;
+    timer.restart();
+    if (!cache.restore(hash, &restored)) {
+        result.error = "cache restore failed";
+        return result;
+    }
+    result.cacheRestoreMs = timer.elapsed();
+    if (restored.totalElementCount() != result.elements) {
+        result.error = QString("cache restored %1 of %2 elements").arg(restored.totalElementCount()).arg(result.elements);
+        return result;
+    }
+
+    result.ok = true;
+    return result;
+}
+
+bool SvgTreeBenchmark::run()
+{
+    QTemporaryDir cacheDir;
+    if (!cacheDir.isValid()) {
+        qCritical("tree bench: cannot create a temporary cache directory");
+        return false;
+    }
+
+    // 逐元素的调试输出会淹没计时，运行期间关闭
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    const struct {
+        QString name;
+        QByteArray source;
+    } scenarios[] = {
+        {QString("deep %1").arg(mDepth), deepDocument(mDepth)},
+        {QString("wide %1").arg(mWidth), wideDocument(mWidth)},
+    };
+
+    bool ok = true;
+    for (const auto& scenario : scenarios) {
+        const Result result = runScenario(scenario.name, scenario.source, cacheDir.path());
+        if (!result.ok) {
+            qCritical("tree bench %s: %s", qPrintable(result.name), qPrintable(result.error));
+            ok = false;
+            continue;
+        }
+        qInfo("tree bench %s: %d elements, load %lld ms, count %lld ms, bounds %lld ms, draw %lld ms, "
+              "cache store %lld ms, cache restore %lld ms",
+              qPrintable(result.name), result.elements, result.loadMs, result.countMs, result.boundsMs,
+              result.drawMs, result.cacheStoreMs, result.cacheRestoreMs);
+    }
+
+    QLoggingCategory::setFilterRules(QString());
+    return ok;
+}
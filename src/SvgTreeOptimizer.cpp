@@ -0,0 +1,171 @@
+#include "SvgTreeOptimizer.h"
+#include "SvgDocument.h"
+#include "SvgGroup.h"
+#include "SvgRect.h"
+#include "SvgCircle.h"
+#include "SvgLine.h"
+#include "SvgPolyline.h"
+#include "SvgPolygon.h"
+#include "SvgPath.h"
+#include "SvgPointKernels.h"
+#include <QElapsedTimer>
+#include <QStack>
+#include <QDebug>
+
+namespace {
+
+bool isDefaultStyle(const SvgStyle& style)
+{
+    static const SvgStyle kDefault;
+    return style.fill() == kDefault.fill() && style.stroke() == kDefault.stroke()
+           && style.strokeWidth() == kDefault.strokeWidth() && style.fontFamily() == kDefault.fontFamily()
+           && style.fontSize() == kDefault.fontSize() && style.textAnchor() == kDefault.textAnchor();
+}
+
+// 没有id（可能被引用或编辑）、样式不起作用的组才展开；defs/symbol的内容不能移到可见的父组中，
+// 声明了图层提示的组是图层缓存的单位，同样保留。
+// 子元素带id时也保留：<use>只应用目标自身的变换，组变换合并进去会改变实例的位置
+bool isFlattenable(const SvgElement* element)
+{
+    if (element->type() != SvgElement::TypeGroup || !element->id().isEmpty()) return false;
+    auto* group = static_cast<const SvgGroup*>(element);
+    if (!group->isRendered() || !isDefaultStyle(group->style())) return false;
+    if (group->layerHint() != SvgGroup::LayerAuto) return false;
+    for (const SvgElement* child : group->children()) {
+        if (!child->id().isEmpty()) return false;
+    }
+    return true;
+}
+
+bool hasVisibleStroke(const SvgStyle& style)
+{
+    return style.hasStroke() && style.stroke().alpha() > 0 && style.strokeWidth() > 0;
+}
+
+} // namespace
+
+bool SvgTreeOptimizer::bakeTransform(SvgElement* element)
+{
+    const QTransform matrix = element->transform().toQTransform();
+    if (matrix.isIdentity() || matrix.type() > QTransform::TxScale) return false;   // 旋转、斜切、透视保留
+
+    const qreal sx = matrix.m11();
+    const qreal sy = matrix.m22();
+    if (sx == 0 || sy == 0) return false;
+    const bool uniform = qFuzzyCompare(qAbs(sx), qAbs(sy));
+    // 画笔在非等比变换下会被拉伸，坐标烘焙无法还原，只有描边不可见时才允许
+    if (!uniform && hasVisibleStroke(element->style())) return false;
+
+    if (auto* rect = dynamic_cast<SvgRect*>(element)) {
+        const QRectF mapped = matrix.mapRect(QRectF(rect->x(), rect->y(), rect->width(), rect->height()));
+        rect->setX(mapped.x());
+        rect->setY(mapped.y());
+        rect->setWidth(mapped.width());
+        rect->setHeight(mapped.height());
+        rect->setRx(rect->rx() * qAbs(sx));
+        rect->setRy(rect->ry() * qAbs(sy));
+    } else if (auto* circle = dynamic_cast<SvgCircle*>(element)) {
+        if (!uniform) return false;   // 非等比缩放后变为椭圆
+        circle->setCenter(matrix.map(circle->center()));
+        circle->setRadius(circle->radius() * qAbs(sx));
+    } else if (auto* line = dynamic_cast<SvgLine*>(element)) {
+        const QLineF mapped = matrix.map(QLineF(line->x1(), line->y1(), line->x2(), line->y2()));
+        line->setX1(mapped.x1());
+        line->setY1(mapped.y1());
+        line->setX2(mapped.x2());
+        line->setY2(mapped.y2());
+        line->setBoundingBox(matrix.mapRect(line->boundingBox()));
+    } else if (auto* polyline = dynamic_cast<SvgPolyline*>(element)) {
+        polyline->setPoints(SvgPointKernels::map(matrix, polyline->points()));
+        polyline->setBoundingBox(matrix.mapRect(polyline->boundingBox()));
+    } else if (auto* polygon = dynamic_cast<SvgPolygon*>(element)) {
+        polygon->setPoints(SvgPointKernels::map(matrix, polygon->points()));
+        polygon->setBoundingBox(matrix.mapRect(polygon->boundingBox()));
+    } else if (auto* path = dynamic_cast<SvgPath*>(element)) {
+        // 懒加载路径保持懒加载（烘焙需要先解析几何，且几何不能再被释放）
+        if (path->isLazy()) return false;
+        SvgPathData data = path->geometry();
+        data.transform(matrix);
+        path->setGeometry(data);
+    } else {
+        return false;   // 文本（字号、字形不宜缩放）与其他元素保留变换
+    }
+
+    if (uniform && element->style().hasStrokeWidth()) {
+        SvgStyle style = element->style();
+        style.setStrokeWidth(style.strokeWidth() * qAbs(sx));
+        element->setStyle(style);
+    }
+    element->setTransform(SvgTransform());
+    return true;
+}
+
+SvgTreeOptimizer::Result SvgTreeOptimizer::optimize(SvgDocument* document)
+{
+    Result result;
+    if (!document) return result;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 待处理的组（显式栈，深层嵌套也不会递归溢出）；顶层元素本身不展开，保持文档根不变
+    QStack<SvgGroup*> groups;
+    for (SvgElement* element : document->elements()) {
+        if (element->type() == SvgElement::TypeGroup) {
+            groups.push(static_cast<SvgGroup*>(element));
+        } else if (bakeTransform(element)) {
+            ++result.bakedTransforms;
+        }
+    }
+
+    struct Pending {
+        SvgElement* element;
+        QTransform outer;   // 已展开的上层组变换（组合在元素自身变换之后）
+    };
+    while (!groups.isEmpty()) {
+        SvgGroup* group = groups.pop();
+
+        // 按文档顺序逐个取出子元素；可展开的组把其子元素连同组变换放回待处理栈
+        QList<SvgElement*> children;
+        QStack<Pending> pending;
+        const QList<SvgElement*> original = group->children();
+        for (auto it = original.crbegin(); it != original.crend(); ++it) {
+            pending.push({*it, QTransform()});
+        }
+        group->setChildren(QList<SvgElement*>());
+
+        while (!pending.isEmpty()) {
+            const Pending item = pending.pop();
+            SvgElement* element = item.element;
+            if (!item.outer.isIdentity()) {
+                if (!element->transform().isIdentity()) ++result.mergedTransforms;
+                element->setTransform(SvgTransform(element->transform().toQTransform() * item.outer));
+            }
+
+            if (isFlattenable(element)) {
+                auto* flattened = static_cast<SvgGroup*>(element);
+                const QTransform outer = flattened->transform().toQTransform();
+                const QList<SvgElement*> inner = flattened->children();
+                for (auto it = inner.crbegin(); it != inner.crend(); ++it) {
+                    pending.push({*it, outer});
+                }
+                flattened->setChildren(QList<SvgElement*>());   // 子元素已转移，组本身可安全释放
+                delete flattened;
+                ++result.flattenedGroups;
+                continue;
+            }
+
+            if (element->type() == SvgElement::TypeGroup) {
+                groups.push(static_cast<SvgGroup*>(element));
+            } else if (bakeTransform(element)) {
+                ++result.bakedTransforms;
+            }
+            children.append(element);
+        }
+        group->setChildren(children);
+    }
+
+    qDebug() << "树优化完成：展开组" << result.flattenedGroups << "，合并变换" << result.mergedTransforms
+             << "，烘焙变换" << result.bakedTransforms << "，耗时(ms)：" << timer.elapsed();
+    return result;
+}
@@ -0,0 +1,69 @@
+#include "SvgTreeWalker.h"
+#include "SvgElement.h"
+#include "SvgGroup.h"
+#include <QVector>
+
+namespace {
+
+// 前序回调的适配器
+class PreOrderVisitor : public SvgTreeVisitor
+{
+public:
+    explicit PreOrderVisitor(const std::function<bool(const SvgElement*)>& visit) : mVisit(visit) {}
+    bool enter(const SvgElement* element) override { return mVisit(element); }
+
+private:
+    const std::function<bool(const SvgElement*)>& mVisit;
+};
+
+} // namespace
+
+void SvgTreeWalker::walk(const SvgElement* root, SvgTreeVisitor* visitor)
+{
+    walk(QList<SvgElement*>{const_cast<SvgElement*>(root)}, visitor);
+}
+
+void SvgTreeWalker::walk(const QList<SvgElement*>& roots, SvgTreeVisitor* visitor)
+{
+    if (!visitor) return;
+
+    struct Frame {
+        const SvgElement* element;
+        bool leaving;   // 子树已访问完，待调用leave
+    };
+    // 子元素逆序压栈，出栈顺序即文档顺序；进入元素时先压入其离开标记，子树出栈完毕后才轮到它
+    QVector<Frame> stack;
+    stack.reserve(64);
+    for (auto it = roots.crbegin(); it != roots.crend(); ++it) {
+        stack.append({*it, false});
+    }
+
+    while (!stack.isEmpty()) {
+        const Frame frame = stack.takeLast();
+        if (frame.leaving) {
+            visitor->leave(frame.element);
+            continue;
+        }
+        if (!frame.element || !visitor->enter(frame.element)) continue;
+
+        stack.append({frame.element, true});
+        if (frame.element->type() == SvgElement::TypeGroup) {
+            const QList<SvgElement*> children = static_cast<const SvgGroup*>(frame.element)->children();
+            for (auto it = children.crbegin(); it != children.crend(); ++it) {
+                stack.append({*it, false});
+            }
+        }
+    }
+}
+
+void SvgTreeWalker::preOrder(const SvgElement* root, const std::function<bool(const SvgElement*)>& visit)
+{
+    PreOrderVisitor visitor(visit);
+    walk(root, &visitor);
+}
+
+void SvgTreeWalker::preOrder(const QList<SvgElement*>& roots, const std::function<bool(const SvgElement*)>& visit)
+{
+    PreOrderVisitor visitor(visit);
+    walk(roots, &visitor);
+}
@@ -0,0 +1,141 @@
+#include "SvgUse.h"
+#include "SvgGroup.h"
+#include "SvgRenderer.h"
+#include "SvgSceneStore.h"
+#include "SvgSymbol.h"
+#include <QMutexLocker>
+#include <QPainter>
+#include <QStack>
+
+namespace {
+
+// 符号之间互相引用时展开会无限递归，超过该深度的实例不再展开
+const int kMaxInstanceDepth = 32;
+thread_local int sInstanceDepth = 0;
+
+// 进入一层实例展开，超过深度时返回false
+struct InstanceScope
+{
+    InstanceScope() : entered(sInstanceDepth < kMaxInstanceDepth) { if (entered) ++sInstanceDepth; }
+    ~InstanceScope() { if (entered) --sInstanceDepth; }
+    const bool entered;
+};
+
+} // namespace
+
+SvgUse::SvgUse(const QString& id)
+    : SvgElement(TypeUse, id)
+{}
+
+void SvgUse::setTarget(const SvgElement* target, const std::shared_ptr<TargetBounds>& bounds)
+{
+    mTarget = target;
+    mTargetBounds = !target ? nullptr : (bounds ? bounds : std::make_shared<TargetBounds>());
+}
+
+void SvgUse::invalidateTargetBounds() const
+{
+    if (!mTargetBounds) return;
+    QMutexLocker locker(&mTargetBounds->mutex);
+    mTargetBounds->valid = false;
+    ++mTargetBounds->generation;
+}
+
+QTransform SvgUse::instanceTransform() const
+{
+    QTransform transform = QTransform::fromTranslate(mX, mY);
+    auto* symbol = dynamic_cast<const SvgSymbol*>(mTarget);
+    if (symbol && symbol->viewBox().isValid() && mWidth > 0 && mHeight > 0) {
+        transform = SvgRenderer::fitTransform(symbol->viewBox(), QRectF(0, 0, mWidth, mHeight)) * transform;
+    }
+    return transform;
+}
+
+void SvgUse::draw(SvgRenderer* renderer) const
+{
+    if (!mTarget || !renderer || !renderer->painter()) return;
+    InstanceScope scope;
+    if (!scope.entered) return;
+
+    QPainter* painter = renderer->painter();
+    painter->save();
+    painter->setTransform(instanceTransform() * painter->transform());
+    if (auto* symbol = dynamic_cast<const SvgSymbol*>(mTarget)) {
+        symbol->drawContent(renderer);
+    } else {
+        renderer->renderElement(mTarget, painter);   // 目标自身的变换照常应用
+    }
+    painter->restore();
+}
+
+QRectF SvgUse::boundingBox() const
+{
+    if (!mTarget || !mTargetBounds) return QRectF();
+
+    // 共享缓存：引用同一目标的实例只遍历一次目标子树，之后只做实例变换
+    // （x/y平移与symbol适配只含平移和缩放，映射矩形范围不会变松）。
+    // 遍历时不持锁：符号互相引用时嵌套实例会查询其他目标的缓存
+    QRectF local;
+    quint64 generation = 0;
+    bool valid = false;
+    {
+        QMutexLocker locker(&mTargetBounds->mutex);
+        local = mTargetBounds->bounds;
+        generation = mTargetBounds->generation;
+        valid = mTargetBounds->valid;
+    }
+    if (!valid) {
+        InstanceScope scope;
+        if (!scope.entered) return QRectF();
+        local = targetBounds();
+        QMutexLocker locker(&mTargetBounds->mutex);
+        if (mTargetBounds->generation == generation) {
+            mTargetBounds->bounds = local;
+            mTargetBounds->valid = true;
+        }
+    }
+    return local.isNull() ? QRectF() : instanceTransform().mapRect(local);
+}
+
+QRectF SvgUse::targetBounds() const
+{
+    struct Frame {
+        const SvgElement* element;
+        QTransform parent;
+    };
+    QStack<Frame> stack;
+    if (auto* symbol = dynamic_cast<const SvgSymbol*>(mTarget)) {
+        for (const SvgElement* child : symbol->children()) {
+            if (child) stack.push({child, QTransform()});
+        }
+    } else {
+        stack.push({mTarget, QTransform()});
+    }
+
+    // 与SvgDocument::documentBounds相同的放宽规则（描边外扩、文本按字号）
+    QRectF bounds;
+    while (!stack.isEmpty()) {
+        const Frame frame = stack.pop();
+        const QTransform total = frame.element->transform().toQTransform() * frame.parent;
+        if (frame.element->type() == SvgElement::TypeGroup) {
+            auto* group = static_cast<const SvgGroup*>(frame.element);
+            if (!group->isRendered()) continue;
+            for (const SvgElement* child : group->children()) {
+                if (child) stack.push({child, total});
+            }
+            continue;
+        }
+        const QRectF box = frame.element->boundingBox();
+        qreal margin = 0;
+        if (frame.element->type() == SvgElement::TypeUse) {
+            if (box.isNull()) continue;   // 未解析的嵌套实例；已解析的范围已放宽
+        } else if (frame.element->type() == SvgElement::TypeText) {
+            margin = qMax<qreal>(frame.element->style().fontSize(), 16);
+        } else {
+            margin = SvgSceneStore::strokeMargin(frame.element->style().strokeWidth());
+        }
+        const QRectF local = box.adjusted(-margin, -margin, margin, margin);
+        bounds = bounds.isEmpty() ? total.mapRect(local) : bounds.united(total.mapRect(local));
+    }
+    return bounds;
+}
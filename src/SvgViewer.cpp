@@ -1,16 +1,72 @@
 #include "SvgViewer.h"
+#include "SvgSceneStore.h"
+#include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QPainter>
 #include <QResizeEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
 #include <QMessageBox>
+#include <QtMath>
 #include <QDebug>
+#include <algorithm>
+
+namespace {
+// 加载期间两次重绘之间的最小间隔（毫秒），避免每个时间片都整幅重绘
+const int kProgressiveRepaintInterval = 100;
+// 时间片内每次解析的元素数（检查耗时的粒度）
+const int kElementsPerStep = 500;
+// 手势停顿多久后视为结束（毫秒），之后才切换分块级别并重绘清晰分块
+const int kGestureSettleDelay = 150;
+// 窗口尺寸停止变化多久后按最终尺寸重新渲染（毫秒）
+const int kResizeSettleDelay = 200;
+// 文件变化后等待多久再重新读取（毫秒），编辑器保存时常有多次写入
+const int kReloadDelay = 100;
+// 缩放范围（相对于适配窗口时的缩放）
+const qreal kMinZoom = 1.0 / 16;
+const qreal kMaxZoom = 4096;
+// 交互期间的渲染预算（毫秒）：完整质量的整帧/单个分块超出预算时改用草稿
+const qreal kFrameBudget = 50;
+const qreal kTileBudget = 8;
+// 缺失分块时向上查找的更粗级别数
+const int kMaxFallbackLevels = 6;
+
+// 向下取整的整数除以2^shift（负数分块坐标同样适用）
+int floorShift(int value, int shift)
+{
+    return int(qFloor(value / qPow(2.0, shift)));
+}
+}
+
+int SvgViewer::sLoadSliceBudget = 25;
 
 SvgViewer::SvgViewer(const QString& svgFilePath, QWidget *parent)
-    : QWidget(parent), mSvgDocument(std::make_unique<SvgDocument>())
+    : QWidget(parent), mSvgDocument(std::make_unique<SvgDocument>()),
+      mLoadTimer(new QTimer(this)), mSettleTimer(new QTimer(this)), mResizeTimer(new QTimer(this)),
+      mReloadTimer(new QTimer(this))
 {
     // 设置窗口标题和初始大小
     setWindowTitle("SVG Viewer");
     setMinimumSize(800, 600);
 
+    // 零间隔定时器：每次事件循环空闲时解析一个时间片
+    mLoadTimer->setInterval(0);
+    connect(mLoadTimer, &QTimer::timeout, this, &SvgViewer::continueLoading);
+
+    // 手势停顿判定与分块就绪后的重绘
+    mSettleTimer->setSingleShot(true);
+    mSettleTimer->setInterval(kGestureSettleDelay);
+    connect(mSettleTimer, &QTimer::timeout, this, &SvgViewer::settleGesture);
+    mResizeTimer->setSingleShot(true);
+    mResizeTimer->setInterval(kResizeSettleDelay);
+    connect(mResizeTimer, &QTimer::timeout, this, &SvgViewer::settleResize);
+    mReloadTimer->setSingleShot(true);
+    mReloadTimer->setInterval(kReloadDelay);
+    connect(mReloadTimer, &QTimer::timeout, this, &SvgViewer::reloadChangedFile);
+    connect(&mTileCache, &SvgTileCache::tileReady, this, qOverload<>(&SvgViewer::update));
+    connect(&mFrameRenderer, &SvgFrameRenderer::frameReady, this, &SvgViewer::onFrameReady);
+    mSvgDocument->addListener(this);
+
     // 尝试加载SVG文件
     if (!svgFilePath.isEmpty()) {
         if (!loadSvgFile(svgFilePath)) {
@@ -19,18 +75,80 @@ SvgViewer::SvgViewer(const QString& svgFilePath, QWidget *parent)
     }
 }
 
+SvgViewer::~SvgViewer()
+{
+    mSvgDocument->removeListener(this);
+}
+
 bool SvgViewer::loadSvgFile(const QString& filePath)
 {
-    bool loaded = mSvgDocument->load(filePath);
+    // 渐进加载：打开文件后立即返回，剩余内容在事件循环中分片解析，已解析部分即时可见
+    mLoadTimer->stop();
+    // 分块与整帧渲染任务在工作线程读取文档，修改文档前先取消并等待（任务在下一个元素处退出）
+    mTileCache.setDocument(nullptr, 1.0);
+    mFrameRenderer.cancelAndWait();
+    mFrameRenderer.clearFrame();
+    mSourceSignature.reset();
+    bool loaded = mSvgDocument->beginLoad(filePath);
     qDebug() << "SVG加载结果：" << loaded;  // 需包含#include <QDebug>
-    qDebug() << "解析到的元素数量：" << mSvgDocument->elements().size();
 
-    if (mSvgDocument->load(filePath)) {
+    if (!loaded) {
+        return false;
+    }
+
+    if (mSvgDocument->isLoading()) {
+        mLoadingFilePath = filePath;
+        mSinceRepaint.start();
+        mLoadTimer->start();
+        // 首个时间片同步执行，随后立即请求首帧，窗口显示后尽快有内容可画
+        continueLoading();
+        if (mSvgDocument->isLoading() && !mFrameRenderer.isBusy()) {
+            requestLoadingFrame();
+        }
+    } else {
+        // 缓存命中，文档已完整
         mCurrentFilePath = filePath;
+        resetView();
         update();  // 触发重绘
-        return true;
     }
-    return false;
+    return true;
+}
+
+void SvgViewer::continueLoading()
+{
+    // 后台帧正在读取文档时不能追加元素，等frameReady后继续
+    if (mFrameRenderer.isBusy()) {
+        mLoadTimer->stop();
+        return;
+    }
+
+    QElapsedTimer slice;
+    slice.start();
+    bool more = true;
+    while (more && slice.elapsed() < sLoadSliceBudget) {
+        more = mSvgDocument->continueLoad(kElementsPerStep);
+    }
+
+    if (more) {
+        // 节流重绘：加载期间最多每kProgressiveRepaintInterval毫秒刷新一次
+        // 拖动窗口边缘期间不为中间尺寸渲染，尺寸稳定后由settleResize补一帧
+        if (!mResizing && mSinceRepaint.elapsed() >= kProgressiveRepaintInterval) {
+            mSinceRepaint.restart();
+            requestLoadingFrame();
+        }
+        return;
+    }
+
+    mLoadTimer->stop();
+    qDebug() << "解析到的元素数量：" << mSvgDocument->elements().size();
+    if (mSvgDocument->isValid()) {
+        mCurrentFilePath = mLoadingFilePath;
+        resetView();
+    } else {
+        QMessageBox::critical(this, "Error", "Failed to load SVG file: " + mLoadingFilePath);
+    }
+    mLoadingFilePath.clear();
+    update();  // 触发重绘
 }
 
 void SvgViewer::paintEvent(QPaintEvent *event)
@@ -55,35 +173,382 @@ void SvgViewer::paintEvent(QPaintEvent *event)
     qDebug() << "mSvgDocument->isValid()：" << mSvgDocument->isValid();
     qDebug() << "mSvgDocument元素数量：" << mSvgDocument->elements().size();
 
-    // 调用渲染方法
-    if (mSvgDocument->isValid()) {
-        QRectF viewportRect = rect();  // 窗口可视区域
-        qDebug() << "准备调用mRenderer.render，viewport：" << viewportRect;
-        mRenderer.render(mSvgDocument.get(), &painter, viewportRect);
-        qDebug() << "mRenderer.render调用完成";
+    // 调用渲染方法：GUI线程只贴图，光栅化全部在后台完成。
+    // 最近完成的整帧作为底图（加载期间即已解析的部分），加载完成后在其上叠加分块
+    const bool loading = mSvgDocument->isLoading();
+    if (mFrameRenderer.hasFrame() && (loading || mSvgDocument->isValid())) {
+        const QTransform current = loading
+            ? SvgRenderer::fitTransform(mSvgDocument->displayViewBox(), QRectF(rect()))
+            : viewTransform();
+        painter.save();
+        // 帧像素→文档坐标→当前窗口坐标（视图变化后先缩放旧帧；调整尺寸期间用快速缩放）
+        painter.setTransform(mFrameRenderer.frameTransform().inverted() * current);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, !mResizing && !mGestureActive);
+        painter.drawImage(QPointF(0, 0), mFrameRenderer.frame());
+        painter.restore();
+    }
+    if (loading) {
+        qDebug() << "渐进加载中，绘制最近完成的帧";
+    } else if (mSvgDocument->isValid()) {
+        paintTiles(painter);
     } else {
         qDebug() << "mSvgDocument无效，不调用render";
     }
 
-    // if (!mSvgDocument || !mSvgDocument->isValid()) {
-    //     mRenderer.render(mSvgDocument.get(), &painter, QRectF(rect()));
-    // }
+}
+
+void SvgViewer::resizeEvent(QResizeEvent *event)
+{
+    Q_UNUSED(event);
+    // 连续的resize事件只重启计时器：期间只缩放已有的帧/分块，不发起任何渲染，
+    // 尺寸停止变化kResizeSettleDelay毫秒后再按最终尺寸渲染一次
+    mResizing = true;
+    mResizeTimer->start();
+
+    // 未缩放/平移过时保持整幅适配窗口
+    if (mFitMode && mSvgDocument->isValid() && !mSvgDocument->isLoading()) {
+        fitToWindow();
+        mGestureActive = true;
+        const int desired = desiredTileLevel();
+        mTileLevel = qBound(desired - 2, mTileLevel, desired + 1);
+    }
+    // 窗口大小变化时触发重绘
+    update();
+}
+
+void SvgViewer::settleResize()
+{
+    mResizing = false;
+    if (mSvgDocument->isLoading()) {
+        // 取消按旧尺寸进行中的帧，按最终尺寸重新请求
+        requestLoadingFrame();
+    } else if (mSvgDocument->isValid()) {
+        settleGesture();
+    }
+    update();
+}
 
-    // // 创建 painter 并开始绘制
-    // QPainter painter(this);
-    // painter.setRenderHint(QPainter::Antialiasing, true);  // 抗锯齿
-    // painter.setRenderHint(QPainter::TextAntialiasing, true);
+void SvgViewer::requestLoadingFrame()
+{
+    // 窗口尚无尺寸时不渲染，解析照常继续
+    const SvgRenderer::Quality quality = chooseQuality(mFrameRenderer.lastFullFrameTime(), kFrameBudget);
+    if (mFrameRenderer.requestFrame(mSvgDocument.get(),
+                                    SvgRenderer::fitTransform(mSvgDocument->displayViewBox(), QRectF(rect())),
+                                    size(), quality)) {
+        mLoadTimer->stop();
+    }
+}
 
-    // // 获取当前窗口大小作为绘制区域
-    // QRectF viewport(0, 0, width(), height());
+void SvgViewer::onFrameReady()
+{
+    update();
+    // 帧已完成，文档可以继续追加元素
+    if (mSvgDocument->isLoading() && !mFrameRenderer.isBusy()) {
+        mLoadTimer->start();
+    }
+}
 
-    // // 渲染SVG到窗口
-    // mRenderer.render(mSvgDocument.get(), &painter, viewport);
+QTransform SvgViewer::viewTransform() const
+{
+    return QTransform(mViewScale, 0, 0, mViewScale, mViewOffset.x(), mViewOffset.y());
 }
 
-void SvgViewer::resizeEvent(QResizeEvent *event)
+void SvgViewer::fitToWindow()
 {
+    const QTransform fit = SvgRenderer::fitTransform(mSvgDocument->displayViewBox(), QRectF(rect()));
+    mViewScale = fit.m11();
+    mViewOffset = QPointF(fit.dx(), fit.dy());
+    mFitMode = true;
+}
+
+void SvgViewer::resetView()
+{
+    // 分块范围包含viewBox之外的内容（适配窗口时这些内容也会出现在留白处）
+    mContentRect = mSvgDocument->viewBox();
+    if (const SvgSceneStore* store = mSvgDocument->sceneStore()) {
+        const QRectF bbox = store->unitedBounds();
+        if (!bbox.isEmpty()) mContentRect = mContentRect.united(bbox);
+        // 文本不在列式包围盒中（包围盒不可靠），按字号放宽后的估算范围单独并入
+        const quint8 text = SvgSceneStore::FlagRendered | SvgSceneStore::FlagLeaf | SvgSceneStore::FlagUnbounded;
+        for (int i = 0; i < store->size(); ++i) {
+            if ((store->flags(i) & text) != text) continue;
+            const QRectF textBox = mSvgDocument->documentBounds(store->element(i));
+            if (!textBox.isEmpty()) mContentRect = mContentRect.united(textBox);
+        }
+    } else {
+        for (const SvgElement* element : mSvgDocument->elements()) {
+            const QRectF bbox = element->transform().toQTransform().mapRect(element->boundingBox());
+            if (!bbox.isEmpty()) mContentRect = mContentRect.united(bbox);
+        }
+    }
+
+    fitToWindow();
+    // 级别0即适配窗口时的分辨率
+    mTileCache.setDocument(mSvgDocument.get(), mViewScale);
+    mTileLevel = 0;
+    mGestureActive = false;
+    qDebug() << "视图已重置，分块范围：" << mContentRect << "，基准缩放：" << mViewScale;
+    startWatching();
+}
+
+void SvgViewer::setWatchEnabled(bool enabled)
+{
+    mWatchEnabled = enabled;
+    if (!enabled) {
+        delete mWatcher;
+        mWatcher = nullptr;
+        mSourceSignature.reset();
+        return;
+    }
+    if (!mWatcher) {
+        mWatcher = new QFileSystemWatcher(this);
+        connect(mWatcher, &QFileSystemWatcher::fileChanged, mReloadTimer, qOverload<>(&QTimer::start));
+    }
+    if (mSvgDocument->isValid() && !mSvgDocument->isLoading()) {
+        startWatching();
+    }
+}
+
+void SvgViewer::startWatching()
+{
+    if (!mWatchEnabled || !mWatcher || mCurrentFilePath.isEmpty()) return;
+    if (!mWatcher->files().isEmpty()) {
+        mWatcher->removePaths(mWatcher->files());
+    }
+    mWatcher->addPath(mCurrentFilePath);
+
+    // 记录当前内容的源签名，作为下次变化时比较的基准
+    QByteArray data;
+    auto signature = std::make_unique<SvgSubtreeSignature>();
+    if (SvgSourceDiff::readSource(mCurrentFilePath, &data) && SvgSourceDiff::scan(data, signature.get())) {
+        mSourceSignature = std::move(signature);
+    } else {
+        mSourceSignature.reset();
+    }
+}
+
+void SvgViewer::reloadChangedFile()
+{
+    if (!mWatcher || mCurrentFilePath.isEmpty() || mSvgDocument->isLoading()) return;
+    // “写临时文件再改名”式的保存会使监视失效，需要重新加入
+    if (!mWatcher->files().contains(mCurrentFilePath) && QFileInfo::exists(mCurrentFilePath)) {
+        mWatcher->addPath(mCurrentFilePath);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray data;
+    SvgSubtreeSignature signature;
+    if (!SvgSourceDiff::readSource(mCurrentFilePath, &data) || !SvgSourceDiff::scan(data, &signature)) {
+        qDebug() << "文件内容不完整（可能仍在写入），等待下一次变化：" << mCurrentFilePath;
+        return;
+    }
+
+    SvgSourceDiff::Result result;
+    if (mSourceSignature
+        && SvgSourceDiff::apply(mSvgDocument.get(), *mSourceSignature, signature, data, &result)) {
+        *mSourceSignature = std::move(signature);
+        qDebug() << "增量重新加载完成，删除子树：" << result.removed << "，新建子树：" << result.inserted
+                 << "，重建元素：" << result.rebuiltElements << "，原地修改属性的元素：" << result.updatedElements
+                 << "，耗时(ms)：" << timer.elapsed();
+        return;
+    }
+
+    // 根元素（viewBox等）变化或无法对齐时整体重新加载，完成后重新记录签名
+    qDebug() << "无法增量更新，整体重新加载：" << mCurrentFilePath;
+    loadSvgFile(mCurrentFilePath);
+}
+
+void SvgViewer::documentAboutToChange(const SvgDocument* document)
+{
+    Q_UNUSED(document);
+    mFrameRenderer.cancelAndWait();
+    mTileCache.suspend();
+}
+
+void SvgViewer::documentChanged(const SvgDocument* document, const SvgDocumentChange& change)
+{
+    Q_UNUSED(document);
+    // 加载时的整帧底图已过时；分块只有与修改区域相交的需要重绘
+    mFrameRenderer.clearFrame();
+    mTileCache.documentChanged(change);
+    if (change.kind == SvgDocumentChange::ChildInserted || change.kind == SvgDocumentChange::StructureChanged) {
+        mContentRect = mContentRect.united(change.dirtyRect);
+    }
+    update(viewTransform().mapRect(change.dirtyRect).toAlignedRect());
+}
+
+SvgRenderer::Quality SvgViewer::chooseQuality(qreal fullRenderMs, qreal budgetMs) const
+{
+    const bool busy = mGestureActive || mDragging || mResizing || mSvgDocument->isLoading();
+    return busy && fullRenderMs > budgetMs ? SvgRenderer::QualityDraft : SvgRenderer::QualityFull;
+}
+
+int SvgViewer::desiredTileLevel() const
+{
+    const qreal ratio = mViewScale / mTileCache.baseScale();
+    // 取不低于当前缩放的最近级别，分块只缩小不放大
+    const int level = qCeil(std::log2(ratio) - 1e-3);
+    return qBound(qFloor(std::log2(kMinZoom)), level, qCeil(std::log2(kMaxZoom)));
+}
+
+void SvgViewer::beginGesture()
+{
+    mGestureActive = true;
+    mSettleTimer->start();
+    // 手势期间沿用已有级别放大/缩小显示；偏离过多时（模糊或分块过多）才跟随切换
+    const int desired = desiredTileLevel();
+    mTileLevel = qBound(desired - 2, mTileLevel, desired + 1);
+}
+
+void SvgViewer::settleGesture()
+{
+    // 仍在调整窗口尺寸时由settleResize统一收尾
+    if (mResizing) return;
+    mGestureActive = false;
+    const int desired = desiredTileLevel();
+    if (desired != mTileLevel) {
+        // 旧级别的排队请求已无意义
+        mTileCache.cancelPending();
+        mTileLevel = desired;
+    }
+    update();
+}
+
+void SvgViewer::paintTiles(QPainter& painter)
+{
+    const QRectF visible = viewTransform().inverted().mapRect(QRectF(rect())).intersected(mContentRect);
+    if (visible.isEmpty()) return;
+
+    const int level = mTileLevel;
+    const qreal tileSize = SvgTileCache::kTileSize / mTileCache.levelScale(level);
+    const int x0 = qFloor(visible.left() / tileSize);
+    const int x1 = qCeil(visible.right() / tileSize) - 1;
+    const int y0 = qFloor(visible.top() / tileSize);
+    const int y1 = qCeil(visible.bottom() / tileSize) - 1;
+
+    painter.save();
+    painter.setTransform(viewTransform());
+    // 手势期间用快速缩放保证帧率，停顿后再平滑
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, !mGestureActive);
+
+    // 纯平移时级别不变，新露出的分块立即请求；缩放手势与调整窗口尺寸期间等停顿后再请求
+    const bool request = !mResizing && (!mGestureActive || level == desiredTileLevel());
+    // 交互期间分块渲染偏慢时先出草稿分块，静止后再逐块升级为完整质量
+    const SvgRenderer::Quality quality = chooseQuality(mTileCache.averageTileTime(), kTileBudget);
+    QVector<SvgTileKey> wanted;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const SvgTileKey key{level, x, y};
+            const QRectF target = mTileCache.tileRect(key);
+            const QImage image = mTileCache.tile(key);
+            if (!image.isNull()) {
+                painter.drawImage(target, image);
+                if (request && quality == SvgRenderer::QualityFull && mTileCache.isDraft(key)) {
+                    wanted.append(key);
+                }
+                continue;
+            }
+            drawCoarserTile(painter, key, target);
+            if (request) wanted.append(key);
+        }
+    }
+    painter.restore();
+
+    // 中心优先：线程池按提交顺序执行，视口中央的分块最先完成
+    const QPointF center = visible.center() / tileSize - QPointF(0.5, 0.5);
+    std::sort(wanted.begin(), wanted.end(), [&center](const SvgTileKey& a, const SvgTileKey& b) {
+        const QPointF da = QPointF(a.x, a.y) - center;
+        const QPointF db = QPointF(b.x, b.y) - center;
+        return QPointF::dotProduct(da, da) < QPointF::dotProduct(db, db);
+    });
+    for (const SvgTileKey& key : wanted) {
+        mTileCache.requestTile(key, quality);
+    }
+}
+
+bool SvgViewer::drawCoarserTile(QPainter& painter, const SvgTileKey& key, const QRectF& target)
+{
+    for (int d = 1; d <= kMaxFallbackLevels; ++d) {
+        const SvgTileKey parent{key.level - d, floorShift(key.x, d), floorShift(key.y, d)};
+        const QImage image = mTileCache.tile(parent);
+        if (image.isNull()) continue;
+
+        // 目标分块在父分块图像中对应的像素区域；草稿分块的图像分辨率低于kTileSize，按实际宽度换算
+        const QRectF parentRect = mTileCache.tileRect(parent);
+        const qreal scale = mTileCache.levelScale(parent.level) * (image.width() / qreal(SvgTileCache::kTileSize));
+        const QRectF source((target.left() - parentRect.left()) * scale,
+                            (target.top() - parentRect.top()) * scale,
+                            target.width() * scale, target.height() * scale);
+        painter.drawImage(target, image, source);
+        return true;
+    }
+    return false;
+}
+
+void SvgViewer::wheelEvent(QWheelEvent *event)
+{
+    if (!mSvgDocument->isValid() || mSvgDocument->isLoading()) {
+        QWidget::wheelEvent(event);
+        return;
+    }
+
+    // 以光标所在的文档点为不动点缩放
+    const qreal base = mTileCache.baseScale();
+    const qreal factor = qPow(1.0015, event->angleDelta().y());
+    const qreal zoom = qBound(kMinZoom, mViewScale * factor / base, kMaxZoom);
+    const QPointF pos = event->position();
+    const QPointF docPos = (pos - mViewOffset) / mViewScale;
+    mViewScale = base * zoom;
+    mViewOffset = pos - docPos * mViewScale;
+    mFitMode = false;
+
+    beginGesture();
+    update();
+    event->accept();
+}
+
+void SvgViewer::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && mSvgDocument->isValid()) {
+        mDragging = true;
+        mLastDragPos = event->position();
+        setCursor(Qt::ClosedHandCursor);
+        event->accept();
+        return;
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void SvgViewer::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!mDragging) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    mViewOffset += event->position() - mLastDragPos;
+    mLastDragPos = event->position();
+    mFitMode = false;
+    beginGesture();
+    update();
+}
+
+void SvgViewer::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && mDragging) {
+        mDragging = false;
+        unsetCursor();
+        event->accept();
+        return;
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void SvgViewer::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (!mSvgDocument->isValid() || mSvgDocument->isLoading()) return;
     Q_UNUSED(event);
-    // 窗口大小变化时触发重绘
+    fitToWindow();
+    beginGesture();
     update();
 }
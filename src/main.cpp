@@ -1,11 +1,45 @@
 #include "SvgViewer.h"
+#include "SvgBandExporter.h"
+#include "SvgRasterCache.h"
+#include "SvgDocument.h"
+#include "SvgElementFactory.h"
+#include "SvgRenderScheduler.h"
+#include "SvgStreamLoader.h"
+#include "SvgTileServer.h"
+#include "SvgTreeBenchmark.h"
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QFile>
 #include <QMessageBox>
+#include <cstring>
+#include <memory>
+
+namespace {
+bool hasArgument(int argc, char *argv[], const char* name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return true;
+    }
+    return false;
+}
+}
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    // 应用对象必须在解析参数之前创建：服务、导出与基准测试模式不需要窗口系统（无显示环境下配合QT_QPA_PLATFORM=offscreen），
+    // 客户端模式不需要GUI
+    const bool serveMode = hasArgument(argc, argv, "--serve") || hasArgument(argc, argv, "--export")
+                           || hasArgument(argc, argv, "--tree-bench");
+    const bool clientMode = hasArgument(argc, argv, "--tile-client");
+    std::unique_ptr<QCoreApplication> application;
+    if (clientMode) {
+        application = std::make_unique<QCoreApplication>(argc, argv);
+    } else if (serveMode) {
+        application = std::make_unique<QGuiApplication>(argc, argv);
+    } else {
+        application = std::make_unique<QApplication>(argc, argv);
+    }
+    QCoreApplication& app = *application;
 
     // 设置应用程序信息
     QCoreApplication::setApplicationName("SVG Viewer");
@@ -18,9 +52,240 @@ int main(int argc, char *argv[])
     parser.addVersionOption();
     parser.addPositionalArgument("file", "SVG file to open.");
 
+    QCommandLineOption cacheDirOption("cache-dir",
+                                      "Directory for the binary document cache.",
+                                      "dir");
+    parser.addOption(cacheDirOption);
+
+    QCommandLineOption lazyPathsOption("lazy-paths",
+                                       "Defer path parsing until a path is first drawn.");
+    parser.addOption(lazyPathsOption);
+
+    QCommandLineOption parallelLoadOption("parallel-load",
+                                          "Build top-level subtrees with at least <elements> elements on worker threads.",
+                                          "elements");
+    parser.addOption(parallelLoadOption);
+
+    QCommandLineOption optimizeOption("optimize",
+                                      "Flatten plain groups and bake translate/scale transforms after loading.");
+    parser.addOption(optimizeOption);
+
+    QCommandLineOption noOcclusionOption("no-occlusion",
+                                         "Draw elements hidden behind opaque shapes instead of culling them.");
+    parser.addOption(noOcclusionOption);
+
+    QCommandLineOption watchOption("watch",
+                                   "Reload the file when it changes, rebuilding only the changed parts.");
+    parser.addOption(watchOption);
+
+    QCommandLineOption serveOption("serve",
+                                   "Run as a tile render server listening on local socket <name>.",
+                                   "name");
+    parser.addOption(serveOption);
+
+    QCommandLineOption tileClientOption("tile-client",
+                                        "Fetch one tile from server <name>; arguments: <file> <z> <x> <y> <output|->.",
+                                        "name");
+    parser.addOption(tileClientOption);
+
+    QCommandLineOption serverMemoryOption("server-memory",
+                                          "Memory budget for parsed documents held by the tile server.",
+                                          "MB");
+    parser.addOption(serverMemoryOption);
+
+    QCommandLineOption tileCacheMemoryOption("tile-cache-memory",
+                                             "Memory budget for encoded tiles held by the tile server.",
+                                             "MB");
+    parser.addOption(tileCacheMemoryOption);
+
+    QCommandLineOption tileSizeOption("tile-size",
+                                      "Tile edge length in pixels for --tile-client.",
+                                      "px");
+    parser.addOption(tileSizeOption);
+
+    QCommandLineOption exportOption("export",
+                                    "Render the file to <image> (.png or .pam) without opening a window.",
+                                    "image");
+    parser.addOption(exportOption);
+
+    QCommandLineOption exportSizeOption("export-size",
+                                        "Export size as <width>x<height>, or <width> to keep the aspect ratio.",
+                                        "size");
+    parser.addOption(exportSizeOption);
+
+    QCommandLineOption bandHeightOption("band-height",
+                                        "Rows rendered per band during export (default: about 64 MB per band).",
+                                        "rows");
+    parser.addOption(bandHeightOption);
+
+    QCommandLineOption exportThreadsOption("export-threads",
+                                           "Number of bands rendered in parallel during export.",
+                                           "count");
+    parser.addOption(exportThreadsOption);
+
+    QCommandLineOption rasterCacheOption("raster-cache",
+                                         "Reuse exported rasters from <dir> when the same content and settings were rendered before.",
+                                         "dir");
+    parser.addOption(rasterCacheOption);
+
+    QCommandLineOption rasterCacheSizeOption("raster-cache-size",
+                                             "Size limit of the raster cache directory.",
+                                             "MB");
+    parser.addOption(rasterCacheSizeOption);
+
+    QCommandLineOption rasterCacheStatsOption("raster-cache-stats",
+                                              "Print accumulated raster cache hit/miss statistics after export.");
+    parser.addOption(rasterCacheStatsOption);
+
+    QCommandLineOption treeBenchOption("tree-bench",
+                                       "Time load, count, bounds, draw and cache round-trip on synthetic deep and wide trees.");
+    parser.addOption(treeBenchOption);
+
     parser.process(app);
+
+    // 启用二进制文档缓存（同一文件再次打开时跳过解析）
+    if (parser.isSet(cacheDirOption)) {
+        SvgDocument::setCacheDirectory(parser.value(cacheDirOption));
+    }
+    // 路径懒加载（缩短大文件的首帧时间）
+    SvgElementFactory::setLazyPathParsing(parser.isSet(lazyPathsOption));
+    // 宽文档并行构建（根元素下的大子树交给线程池）
+    if (parser.isSet(parallelLoadOption)) {
+        SvgStreamLoader::setParallelThreshold(parser.value(parallelLoadOption).toInt());
+    }
+
+    // 加载后展开无样式的组、把平移/缩放烘焙进坐标（减少绘制时的save/restore与变换压栈）
+    SvgDocument::setOptimizeOnLoad(parser.isSet(optimizeOption));
+    // 遮挡剔除不改变输出，关闭只用于对比验证
+    SvgRenderScheduler::setOcclusionCulling(!parser.isSet(noOcclusionOption));
+
     const QStringList args = parser.positionalArguments();
 
+    // 基准测试模式：合成的深层/超宽文档，不读取文件
+    if (parser.isSet(treeBenchOption)) {
+        SvgTreeBenchmark benchmark;
+        return benchmark.run() ? 0 : 1;
+    }
+
+    // 导出模式：分带渲染并流式写出，内存不随输出尺寸增长
+    if (parser.isSet(exportOption)) {
+        if (args.isEmpty()) {
+            qCritical("Usage: --export <image> [--export-size <w>x<h>] <file>");
+            return 1;
+        }
+        const QString outputFile = parser.value(exportOption);
+
+        // 请求的尺寸：0表示由viewBox推导（缓存键只依赖请求参数，命中时无需解析文档）
+        QSize requested;
+        if (parser.isSet(exportSizeOption)) {
+            const QStringList parts = parser.value(exportSizeOption).split('x');
+            requested = QSize(parts.first().toInt(), parts.size() > 1 ? parts.at(1).toInt() : 0);
+        }
+
+        std::unique_ptr<SvgRasterCache> rasterCache;
+        QByteArray rasterKey;
+        if (parser.isSet(rasterCacheOption)) {
+            rasterCache = std::make_unique<SvgRasterCache>(parser.value(rasterCacheOption));
+            if (parser.isSet(rasterCacheSizeOption)) {
+                rasterCache->setMaxBytes(parser.value(rasterCacheSizeOption).toLongLong() * 1024 * 1024);
+            }
+            rasterKey = SvgRasterCache::renderKey(args.first(), requested, QRectF(), SvgRenderer::QualityFull,
+                                                  SvgRasterWriter::formatForFileName(outputFile));
+        }
+        auto reportCache = [&]() {
+            if (!rasterCache) return;
+            const SvgRasterCache::Statistics total = rasterCache->flushStatistics();
+            if (parser.isSet(rasterCacheStatsOption)) {
+                qInfo("raster cache: hits %llu, misses %llu, stores %llu, evictions %llu",
+                      total.hits, total.misses, total.stores, total.evictions);
+            }
+        };
+        if (rasterCache && rasterCache->fetch(rasterKey, outputFile)) {
+            reportCache();
+            return 0;
+        }
+
+        SvgDocument document;
+        if (!document.load(args.first())) {
+            qCritical("Cannot load %s", qPrintable(args.first()));
+            return 1;
+        }
+
+        // 未指定尺寸时按viewBox原始大小；只给宽度时按viewBox宽高比推算高度
+        const QRectF viewBox = document.viewBox();
+        QSize size = viewBox.size().toSize();
+        if (requested.width() > 0) {
+            const int height = requested.height() > 0
+                                   ? requested.height()
+                                   : qRound(requested.width() * viewBox.height() / qMax<qreal>(viewBox.width(), 1));
+            size = QSize(requested.width(), height);
+        }
+        if (size.isEmpty()) {
+            qCritical("Invalid export size");
+            return 1;
+        }
+
+        SvgBandExporter exporter;
+        if (parser.isSet(bandHeightOption)) {
+            exporter.setBandHeight(parser.value(bandHeightOption).toInt());
+        }
+        if (parser.isSet(exportThreadsOption)) {
+            exporter.setParallelBands(parser.value(exportThreadsOption).toInt());
+        }
+        if (!exporter.exportToFile(&document, size, outputFile)) {
+            qCritical("Export failed: %s", qPrintable(exporter.errorString()));
+            return 1;
+        }
+        if (rasterCache) {
+            rasterCache->store(rasterKey, outputFile);
+            reportCache();
+        }
+        return 0;
+    }
+
+    // 分块服务模式：常驻进程，文档只解析一次，供多个客户端请求分块
+    if (parser.isSet(serveOption)) {
+        SvgTileServer server;
+        if (parser.isSet(serverMemoryOption)) {
+            server.setDocumentBudget(parser.value(serverMemoryOption).toLongLong() * 1024 * 1024);
+        }
+        if (parser.isSet(tileCacheMemoryOption)) {
+            server.setTileCacheBudget(parser.value(tileCacheMemoryOption).toLongLong() * 1024 * 1024);
+        }
+        if (!server.listen(parser.value(serveOption))) {
+            qCritical("Cannot listen on %s: %s", qPrintable(parser.value(serveOption)),
+                      qPrintable(server.errorString()));
+            return 1;
+        }
+        return app.exec();
+    }
+
+    // 分块客户端模式：请求一个分块并写入文件（"-"表示标准输出）
+    if (parser.isSet(tileClientOption)) {
+        if (args.size() != 5) {
+            qCritical("Usage: --tile-client <name> <file> <z> <x> <y> <output|->");
+            return 1;
+        }
+        const int tileSize = parser.isSet(tileSizeOption) ? parser.value(tileSizeOption).toInt()
+                                                          : SvgTileServer::kDefaultTileSize;
+        QByteArray png;
+        QString error;
+        if (!SvgTileServer::fetchTile(parser.value(tileClientOption), args.at(0),
+                                      args.at(1).toInt(), args.at(2).toInt(), args.at(3).toInt(),
+                                      tileSize, &png, &error)) {
+            qCritical("Tile request failed: %s", qPrintable(error));
+            return 1;
+        }
+        QFile output(args.at(4));
+        const bool opened = args.at(4) == "-" ? output.open(stdout, QIODevice::WriteOnly)
+                                              : output.open(QIODevice::WriteOnly);
+        if (!opened || output.write(png) != png.size()) {
+            qCritical("Cannot write %s", qPrintable(args.at(4)));
+            return 1;
+        }
+        return 0;
+    }
+
     // 确定要打开的SVG文件路径
     QString svgFilePath;
     if (!args.isEmpty()) {
@@ -29,6 +294,7 @@ int main(int argc, char *argv[])
 
     // 创建并显示主窗口
     SvgViewer viewer(svgFilePath);
+    viewer.setWatchEnabled(parser.isSet(watchOption));
     viewer.show();
 
     return app.exec();